@@ -26,17 +26,66 @@ public class FlutterBicubicResizePlugin: NSObject, FlutterPlugin {
 
     // Call each function with minimal parameters to force symbol inclusion
     // These calls are safe - they return early due to invalid dimensions
-    // New API: filter, edge_mode, crop, crop_anchor, aspect_mode, aspect_w, aspect_h
-    _ = bicubic_resize_rgb(&dummyInput, 0, 0, &dummyOutput, 0, 0, 0, 0, 1.0, 0, 0, 1.0, 1.0)
-    _ = bicubic_resize_rgba(&dummyInput, 0, 0, &dummyOutput, 0, 0, 0, 0, 1.0, 0, 0, 1.0, 1.0)
+    // New API: filter, edge_mode, color_space, crop, crop_anchor, aspect_mode, aspect_w, aspect_h, num_threads
+    // RGBA entry points take alpha_mode after color_space
+    _ = bicubic_resize_rgb(&dummyInput, 0, 0, &dummyOutput, 0, 0, 0, 0, 0, 0, 1.0, 0, 0, 1.0, 1.0, 1)
+    _ = bicubic_resize_rgba(&dummyInput, 0, 0, &dummyOutput, 0, 0, 0, 0, 0, 0, 0, 1.0, 0, 0, 1.0, 1.0, 1)
+    // Strided: input_stride after input size, output_stride after output size
+    _ = bicubic_resize_rgb_strided(&dummyInput, 0, 0, 0, &dummyOutput, 0, 0, 0, 0, 0, 0, 0, 1.0, 0, 0, 1.0, 1.0, 1)
+    _ = bicubic_resize_rgba_strided(&dummyInput, 0, 0, 0, &dummyOutput, 0, 0, 0, 0, 0, 0, 0, 0, 1.0, 0, 0, 1.0, 1.0, 1)
+    _ = bicubic_resize_gray(&dummyInput, 0, 0, &dummyOutput, 0, 0, 0, 0, 0, 0, 1.0, 0, 0, 1.0, 1.0, 1)
+    _ = bicubic_resize_gray_strided(&dummyInput, 0, 0, 0, &dummyOutput, 0, 0, 0, 0, 0, 0, 0, 1.0, 0, 0, 1.0, 1.0, 1)
+    // Layout: input_stride, input_layout after input size; output_stride, output_layout after output size
+    _ = bicubic_resize_layout(&dummyInput, 0, 0, 0, 5, &dummyOutput, 0, 0, 0, 5, 0, 0, 0, 0, 0, 1.0, 0, 0, 1.0, 1.0, 1)
+    var dummyChannels: Int32 = 0
+    _ = bicubic_resize_rgba_drop_opaque_alpha(&dummyInput, 0, 0, 0, &dummyOutput, 0, 0, 0, 0, 0, 0, 0, 1.0, 0, 0, 1.0, 1.0, 1, &dummyChannels)
+
+    // Tensor: input_channels, output, ..., tensor_layout, channel_order, mean, std, num_threads
+    var dummyTensor: [Float] = [0]
+    _ = bicubic_resize_rgb_to_tensor(&dummyInput, 0, 0, 3, &dummyTensor, 0, 0, 0, 0, 0, 0, 1.0, 0, 0, 1.0, 1.0, 0, 0, nil, nil, 1)
+
+    // YUV: planes and strides, input size, output, output_channels, color_matrix, resize options
+    _ = bicubic_resize_yuv420(&dummyInput, 0, &dummyInput, &dummyInput, 0, 1, 0, 0, &dummyOutput, 0, 0, 3, 0, 0, 0, 0, 0, 1.0, 0, 0, 1.0, 1.0, 1)
+
+    // Plan: input size, channels, output size, filter, edge_mode, color_space, alpha_mode, crop, crop_anchor, aspect_mode, aspect_w, aspect_h, num_threads
+    let plan = bicubic_plan_create(0, 0, 3, 0, 0, 0, 0, 0, 0, 0, 1.0, 0, 0, 1.0, 1.0, 1)
+    _ = bicubic_plan_execute(plan, &dummyInput, &dummyOutput)
+    bicubic_plan_destroy(plan)
 
     var outPtr: UnsafeMutablePointer<UInt8>? = nil
     var outSize: Int32 = 0
-    // JPEG: filter, edge_mode, crop, crop_anchor, aspect_mode, aspect_w, aspect_h, apply_exif
-    _ = bicubic_resize_jpeg(&dummyInput, 0, 0, 0, 80, 0, 0, 1.0, 0, 0, 1.0, 1.0, 1, &outPtr, &outSize)
-    // PNG: filter, edge_mode, crop, crop_anchor, aspect_mode, aspect_w, aspect_h, compression_level
-    _ = bicubic_resize_png(&dummyInput, 0, 0, 0, 0, 0, 1.0, 0, 0, 1.0, 1.0, 6, &outPtr, &outSize)
+    // JPEG: quality, chroma_subsampling, filter, edge_mode, color_space, crop, crop_anchor, aspect_mode, aspect_w, aspect_h, apply_exif, num_threads
+    _ = bicubic_resize_jpeg(&dummyInput, 0, 0, 0, 80, -1, 0, 0, 0, 0, 1.0, 0, 0, 1.0, 1.0, 1, 1, &outPtr, &outSize)
+    // PNG: filter, edge_mode, color_space, crop, crop_anchor, aspect_mode, aspect_w, aspect_h, compression_level, png_filter, num_threads
+    _ = bicubic_resize_png(&dummyInput, 0, 0, 0, 0, 0, 0, 0, 1.0, 0, 0, 1.0, 1.0, 6, -1, 1, &outPtr, &outSize)
+
+    // Batch: items, count, num_threads
+    _ = bicubic_resize_batch(nil, 0, 1)
+
+    // Multi-rendition: input, input_size, specs, count, apply_exif, num_threads
+    _ = bicubic_resize_multi(nil, 0, nil, 0, 1, 1)
+
+    // Decoded image: input, input_size, apply_exif (NULL input returns NULL)
+    let image = bicubic_image_create(nil, 0, 1)
+    var dummyInfo: Int32 = 0
+    _ = bicubic_image_info(image, &dummyInfo, &dummyInfo, &dummyInfo)
+    _ = bicubic_image_resize(image, &dummyOutput, 0, 0, 0, 0, 0, 0, 1.0, 0, 0, 1.0, 1.0, 1)
+    _ = bicubic_image_encode(image, 0, 0, 0, 80, -1, 6, -1, 0, 0, 0, 0, 1.0, 0, 0, 1.0, 1.0, 1, &outPtr, &outSize)
+    bicubic_image_destroy(image)
+
+    // Probe: input, input_size, info (NULL info is rejected)
+    _ = bicubic_probe(nil, 0, nil)
+    _ = bicubic_probe_batch(nil, nil, 0, nil)
+
+    // Async: NULL post function / inputs are rejected without queueing a job
+    bicubic_async_init(nil)
+    _ = bicubic_resize_raw_async(nil, 0, 0, 0, 3, 0, 0, 0, 0, 0, 0, 0, 1.0, 0, 0, 1.0, 1.0, 1, 0)
+    _ = bicubic_resize_batch_async(nil, 0, 1, 0)
 
     free_buffer(nil)
+
+    // Arenas: set the default limit (64 MB), release nothing-yet-cached memory
+    bicubic_arena_set_limit(64 * 1024 * 1024)
+    bicubic_arena_trim()
   }
 }
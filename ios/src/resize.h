@@ -20,6 +20,7 @@ extern "C" {
 #define FILTER_CATMULL_ROM   0  // OpenCV INTER_CUBIC, PIL BICUBIC (default)
 #define FILTER_CUBIC_BSPLINE 1  // Smoother, more blurry
 #define FILTER_MITCHELL      2  // Mitchell-Netravali (balanced)
+#define FILTER_AUTO          3  // Catmull-Rom, cheaper triangle/copy on near-1:1 axes
 
 // ============================================================================
 // Edge modes (how to handle pixels outside image bounds)
@@ -30,6 +31,48 @@ extern "C" {
 #define EDGE_REFLECT 2  // Mirror reflection
 #define EDGE_ZERO    3  // Black/transparent pixels
 
+// ============================================================================
+// Per-axis selection (filter / edge_mode arguments)
+// ============================================================================
+
+// Pack a horizontal and a vertical value into one filter or edge_mode argument
+// (plain values apply to both axes), e.g. FILTER_AXES(FILTER_CATMULL_ROM, FILTER_AUTO)
+#define AXES_PACKED 0x100
+#define FILTER_AXES(h, v) (AXES_PACKED | ((v) << 4) | (h))
+#define EDGE_AXES(h, v)   (AXES_PACKED | ((v) << 4) | (h))
+
+// ============================================================================
+// Color spaces (where resampling happens)
+// ============================================================================
+
+#define COLOR_SPACE_GAMMA  0  // Resample the stored sRGB values (default)
+#define COLOR_SPACE_LINEAR 1  // Resample in linear light (sRGB decoded, re-encoded)
+
+// ============================================================================
+// Alpha modes (how RGBA / gray+alpha input is weighted)
+// ============================================================================
+
+#define ALPHA_STRAIGHT      0  // Straight alpha, premultiplied around the resample (default)
+#define ALPHA_PREMULTIPLIED 1  // Input is already premultiplied (no conversion passes)
+#define ALPHA_IGNORE        2  // Alpha resampled as an independent channel
+#define ALPHA_STRAIGHT_FAST 3  // Straight alpha, faster premultiply at lower precision
+
+// ============================================================================
+// Pixel layouts (channel order of raw buffers, see bicubic_resize_layout)
+// ============================================================================
+
+#define PIXEL_LAYOUT_GRAY 0
+#define PIXEL_LAYOUT_RA   1  // Gray + alpha
+#define PIXEL_LAYOUT_AR   2  // Alpha + gray
+#define PIXEL_LAYOUT_RGB  3
+#define PIXEL_LAYOUT_BGR  4
+#define PIXEL_LAYOUT_RGBA 5
+#define PIXEL_LAYOUT_BGRA 6  // Most platform surfaces (CVPixelBuffer, Skia N32 on little-endian)
+#define PIXEL_LAYOUT_ARGB 7
+#define PIXEL_LAYOUT_ABGR 8
+
+#define PIXEL_LAYOUT_PLANAR 0x100  // Output flag: one plane per channel (RRR..GGG..BBB..)
+
 // ============================================================================
 // Crop anchor positions
 // ============================================================================
@@ -52,17 +95,59 @@ extern "C" {
 #define ASPECT_ORIGINAL 1  // Keep original aspect ratio
 #define ASPECT_CUSTOM   2  // Custom aspect ratio (use aspect_w/aspect_h)
 
+// ============================================================================
+// Float tensor layouts (ML preprocessing output)
+// ============================================================================
+
+#define TENSOR_NHWC 0  // Interleaved: HxWxC (default)
+#define TENSOR_NCHW 1  // Planar: CxHxW (one plane per channel)
+
+#define CHANNEL_ORDER_RGB 0  // R, G, B (default)
+#define CHANNEL_ORDER_BGR 1  // B, G, R (OpenCV / Caffe models)
+
+// ============================================================================
+// YUV color matrices (camera input)
+// ============================================================================
+
+#define YUV_BT601_FULL    0  // JFIF full range (default, most Android cameras)
+#define YUV_BT601_LIMITED 1  // SD video range (Y 16-235)
+#define YUV_BT709_LIMITED 2  // HD video range (Y 16-235)
+
+// YUV 4:2:0 chroma siting (horizontal position of each chroma sample)
+#define YUV_SITING_COSITED 0  // On the even luma column (MPEG-2, Android camera, default)
+#define YUV_SITING_CENTER  1  // Between two luma columns (JPEG/JFIF, MPEG-1)
+
+// ============================================================================
+// Encoder settings (per call, safe to vary across concurrent calls)
+// ============================================================================
+
+#define PNG_FILTER_ADAPTIVE -1  // Pick the best filter per row (default)
+#define PNG_FILTER_NONE      0
+#define PNG_FILTER_SUB       1
+#define PNG_FILTER_UP        2
+#define PNG_FILTER_AVERAGE   3
+#define PNG_FILTER_PAETH     4
+
+#define JPEG_SUBSAMPLING_AUTO -1  // 4:2:0 at quality <= 90, else 4:4:4 (default)
+#define JPEG_SUBSAMPLING_444   0  // Full-resolution chroma
+#define JPEG_SUBSAMPLING_420   1  // Half-resolution chroma (smaller files)
+
 // ============================================================================
 // Raw pixel data resize functions
 // ============================================================================
 
 // Resize RGB image using specified filter
-// filter: 0=Catmull-Rom (default), 1=Cubic B-Spline, 2=Mitchell
-// edge_mode: 0=clamp (default), 1=wrap, 2=reflect, 3=zero
+// filter: 0=Catmull-Rom (default), 1=Cubic B-Spline, 2=Mitchell, 3=auto
+//         (triangle/copy on axes scaled by less than 1.25x), or FILTER_AXES(h, v)
+// edge_mode: 0=clamp (default), 1=wrap, 2=reflect, 3=zero, or EDGE_AXES(h, v)
+// color_space: 0=gamma (default), 1=linear light (sRGB decoded before resampling)
+// reducing_gap: 0=off (default); >= 1 first box-averages the input down to
+//               about reducing_gap x the output size (faster extreme downscales)
 // crop: crop factor (0.0-1.0), 1.0 = no crop, 0.5 = 50%
 // crop_anchor: 0=center (default), 1-8 = other positions
 // aspect_mode: 0=square (default), 1=original, 2=custom
 // aspect_w, aspect_h: custom aspect ratio (only used if aspect_mode=2)
+// num_threads: 0=auto (one per CPU core), 1=single-threaded, N=up to N threads
 // Returns 0 on success, -1 on error
 FFI_EXPORT int bicubic_resize_rgb(
     const uint8_t* input,
@@ -73,20 +158,30 @@ FFI_EXPORT int bicubic_resize_rgb(
     int output_height,
     int filter,
     int edge_mode,
+    int color_space,
+    float reducing_gap,
     float crop,
     int crop_anchor,
     int aspect_mode,
     float aspect_w,
-    float aspect_h
+    float aspect_h,
+    int num_threads
 );
 
 // Resize RGBA image using specified filter
-// filter: 0=Catmull-Rom (default), 1=Cubic B-Spline, 2=Mitchell
-// edge_mode: 0=clamp (default), 1=wrap, 2=reflect, 3=zero
+// filter: 0=Catmull-Rom (default), 1=Cubic B-Spline, 2=Mitchell, 3=auto
+//         (triangle/copy on axes scaled by less than 1.25x), or FILTER_AXES(h, v)
+// edge_mode: 0=clamp (default), 1=wrap, 2=reflect, 3=zero, or EDGE_AXES(h, v)
+// color_space: 0=gamma (default), 1=linear light (sRGB decoded before resampling)
+// alpha_mode: 0=straight (default), 1=premultiplied input, 2=ignore alpha,
+//             3=straight with faster, lower-precision alpha weighting
+// reducing_gap: 0=off (default); >= 1 first box-averages the input down to
+//               about reducing_gap x the output size (faster extreme downscales)
 // crop: crop factor (0.0-1.0), 1.0 = no crop, 0.5 = 50%
 // crop_anchor: 0=center (default), 1-8 = other positions
 // aspect_mode: 0=square (default), 1=original, 2=custom
 // aspect_w, aspect_h: custom aspect ratio (only used if aspect_mode=2)
+// num_threads: 0=auto (one per CPU core), 1=single-threaded, N=up to N threads
 // Returns 0 on success, -1 on error
 FFI_EXPORT int bicubic_resize_rgba(
     const uint8_t* input,
@@ -97,26 +192,327 @@ FFI_EXPORT int bicubic_resize_rgba(
     int output_height,
     int filter,
     int edge_mode,
+    int color_space,
+    int alpha_mode,
+    float reducing_gap,
+    float crop,
+    int crop_anchor,
+    int aspect_mode,
+    float aspect_w,
+    float aspect_h,
+    int num_threads
+);
+
+// Resize RGB image with explicit row strides (padded rows, sub-views)
+// input_stride: bytes between input rows, 0 = input_width * 3
+// output_stride: bytes between output rows, 0 = output_width * 3
+// Other parameters have the same meaning as in bicubic_resize_rgb.
+// Returns 0 on success, -1 on error
+FFI_EXPORT int bicubic_resize_rgb_strided(
+    const uint8_t* input,
+    int input_width,
+    int input_height,
+    int input_stride,
+    uint8_t* output,
+    int output_width,
+    int output_height,
+    int output_stride,
+    int filter,
+    int edge_mode,
+    int color_space,
+    float reducing_gap,
+    float crop,
+    int crop_anchor,
+    int aspect_mode,
+    float aspect_w,
+    float aspect_h,
+    int num_threads
+);
+
+// Resize RGBA image with explicit row strides (padded rows, sub-views)
+// input_stride: bytes between input rows, 0 = input_width * 4
+// output_stride: bytes between output rows, 0 = output_width * 4
+// Other parameters have the same meaning as in bicubic_resize_rgba.
+// Returns 0 on success, -1 on error
+FFI_EXPORT int bicubic_resize_rgba_strided(
+    const uint8_t* input,
+    int input_width,
+    int input_height,
+    int input_stride,
+    uint8_t* output,
+    int output_width,
+    int output_height,
+    int output_stride,
+    int filter,
+    int edge_mode,
+    int color_space,
+    int alpha_mode,
+    float reducing_gap,
+    float crop,
+    int crop_anchor,
+    int aspect_mode,
+    float aspect_w,
+    float aspect_h,
+    int num_threads
+);
+
+// Resize single-channel (grayscale) image using specified filter
+// Parameters have the same meaning as in bicubic_resize_rgb.
+// Returns 0 on success, -1 on error
+FFI_EXPORT int bicubic_resize_gray(
+    const uint8_t* input,
+    int input_width,
+    int input_height,
+    uint8_t* output,
+    int output_width,
+    int output_height,
+    int filter,
+    int edge_mode,
+    int color_space,
+    float reducing_gap,
+    float crop,
+    int crop_anchor,
+    int aspect_mode,
+    float aspect_w,
+    float aspect_h,
+    int num_threads
+);
+
+// Resize single-channel (grayscale) image with explicit row strides
+// input_stride: bytes between input rows, 0 = input_width
+// output_stride: bytes between output rows, 0 = output_width
+// Other parameters have the same meaning as in bicubic_resize_gray.
+// Returns 0 on success, -1 on error
+FFI_EXPORT int bicubic_resize_gray_strided(
+    const uint8_t* input,
+    int input_width,
+    int input_height,
+    int input_stride,
+    uint8_t* output,
+    int output_width,
+    int output_height,
+    int output_stride,
+    int filter,
+    int edge_mode,
+    int color_space,
+    float reducing_gap,
+    float crop,
+    int crop_anchor,
+    int aspect_mode,
+    float aspect_w,
+    float aspect_h,
+    int num_threads
+);
+
+// Resize RGBA image, dropping the alpha channel when it is 255 everywhere in
+// the crop region (opaque images are resampled without alpha weighting)
+// input_stride: bytes between input rows, 0 = input_width * 4
+// output: output_width * output_height * 4 bytes; holds tightly packed RGB
+// when *output_channels is 3, RGBA when it is 4
+// Other parameters have the same meaning as in bicubic_resize_rgba.
+// Returns 0 on success, -1 on error
+FFI_EXPORT int bicubic_resize_rgba_drop_opaque_alpha(
+    const uint8_t* input,
+    int input_width,
+    int input_height,
+    int input_stride,
+    uint8_t* output,
+    int output_width,
+    int output_height,
+    int filter,
+    int edge_mode,
+    int color_space,
+    int alpha_mode,
+    float reducing_gap,
+    float crop,
+    int crop_anchor,
+    int aspect_mode,
+    float aspect_w,
+    float aspect_h,
+    int num_threads,
+    int* output_channels
+);
+
+// Resize raw pixels and convert their channel order in the same pass
+// input_layout, output_layout: PIXEL_LAYOUT_*, with the same channel count
+// (e.g. BGRA -> RGBA, ARGB -> BGRA, RGB -> BGR). Channels are reordered in the
+// resampler's load/store loops, with no separate swizzle pass.
+// output_layout | PIXEL_LAYOUT_PLANAR writes one plane per channel, in the
+// order of output_layout; each plane is output_height rows of output_stride bytes
+// input_stride: bytes between input rows, 0 = tightly packed
+// output_stride: bytes between output rows (of one plane when planar),
+//                0 = tightly packed
+// alpha_mode: see bicubic_resize_rgba (ignored for layouts without alpha)
+// Other parameters have the same meaning as in bicubic_resize_rgb.
+// Returns 0 on success, -1 on error
+FFI_EXPORT int bicubic_resize_layout(
+    const uint8_t* input,
+    int input_width,
+    int input_height,
+    int input_stride,
+    int input_layout,
+    uint8_t* output,
+    int output_width,
+    int output_height,
+    int output_stride,
+    int output_layout,
+    int filter,
+    int edge_mode,
+    int color_space,
+    int alpha_mode,
+    float reducing_gap,
+    float crop,
+    int crop_anchor,
+    int aspect_mode,
+    float aspect_w,
+    float aspect_h,
+    int num_threads
+);
+
+// Resize RGB/RGBA image straight into a normalized float32 tensor
+// input_channels: 3=RGB, 4=RGBA (alpha is dropped)
+// output: output_width * output_height * 3 floats
+// tensor_layout: 0=NHWC (default), 1=NCHW
+// channel_order: 0=RGB (default), 1=BGR
+// mean, std: per-channel normalization in output channel order, applied to
+//            values in 0.0-1.0 as (value - mean) / std; NULL = 0.0 / 1.0
+// With color_space=1 the resampled values are re-encoded to sRGB in float
+// (no 8-bit rounding) before normalization, so the value range matches
+// color_space=0.
+// filter, edge_mode, color_space, reducing_gap, crop, crop_anchor, aspect_mode,
+// aspect_w, aspect_h and num_threads have the same meaning as in bicubic_resize_rgb.
+// Returns 0 on success, -1 on error
+FFI_EXPORT int bicubic_resize_rgb_to_tensor(
+    const uint8_t* input,
+    int input_width,
+    int input_height,
+    int input_channels,
+    float* output,
+    int output_width,
+    int output_height,
+    int filter,
+    int edge_mode,
+    int color_space,
+    float reducing_gap,
+    float crop,
+    int crop_anchor,
+    int aspect_mode,
+    float aspect_w,
+    float aspect_h,
+    int tensor_layout,
+    int channel_order,
+    const float* mean,
+    const float* std,
+    int num_threads
+);
+
+// Resize a YUV 4:2:0 camera frame (Android YUV_420_888, NV21, NV12, I420)
+// and convert it to RGB/RGBA. Planes are resampled to the output size first
+// and converted there, so the work scales with output pixels.
+// y_plane, y_row_stride: luma plane (1 byte per pixel)
+// u_plane, v_plane: chroma planes at half width/height
+// uv_row_stride, uv_pixel_stride: chroma strides in bytes (pixel stride 2 for
+//                                 NV21/NV12 interleaved chroma, 1 for I420)
+// output_channels: 3=RGB, 4=RGBA (alpha = 255)
+// color_matrix: 0=BT.601 full range (default), 1=BT.601 limited, 2=BT.709 limited
+// chroma_siting: 0=co-sited with even luma columns (default), 1=centered;
+//                vertically chroma always sits between two luma rows
+// color_space=1 resamples luma in linear light; chroma is resampled as stored
+// filter, edge_mode, color_space, crop, crop_anchor, aspect_mode, aspect_w,
+// aspect_h and num_threads have the same meaning as in bicubic_resize_rgb.
+// Returns 0 on success, -1 on error
+FFI_EXPORT int bicubic_resize_yuv420(
+    const uint8_t* y_plane,
+    int y_row_stride,
+    const uint8_t* u_plane,
+    const uint8_t* v_plane,
+    int uv_row_stride,
+    int uv_pixel_stride,
+    int input_width,
+    int input_height,
+    uint8_t* output,
+    int output_width,
+    int output_height,
+    int output_channels,
+    int color_matrix,
+    int chroma_siting,
+    int filter,
+    int edge_mode,
+    int color_space,
+    float crop,
+    int crop_anchor,
+    int aspect_mode,
+    float aspect_w,
+    float aspect_h,
+    int num_threads
+);
+
+// ============================================================================
+// Resize plans (repeated resizes with the same geometry)
+// ============================================================================
+
+// Opaque handle holding prebuilt filter coefficients for one resize geometry
+typedef struct BicubicPlan BicubicPlan;
+
+// Create a plan for resizing input_width x input_height images with the given
+// channel count (3=RGB, 4=RGBA) to output_width x output_height.
+// Filter coefficients are computed once here instead of on every frame.
+// filter, edge_mode, color_space, reducing_gap, crop, crop_anchor, aspect_mode,
+// aspect_w, aspect_h and num_threads have the same meaning as in bicubic_resize_rgb;
+// alpha_mode as in bicubic_resize_rgba (ignored for RGB).
+// Returns NULL on error
+FFI_EXPORT BicubicPlan* bicubic_plan_create(
+    int input_width,
+    int input_height,
+    int channels,
+    int output_width,
+    int output_height,
+    int filter,
+    int edge_mode,
+    int color_space,
+    int alpha_mode,
+    float reducing_gap,
     float crop,
     int crop_anchor,
     int aspect_mode,
     float aspect_w,
-    float aspect_h
+    float aspect_h,
+    int num_threads
 );
 
+// Resize one frame with a plan. input must be tightly packed
+// input_width x input_height pixels, output must hold
+// output_width x output_height pixels.
+// A plan must not be executed from several threads at the same time.
+// Returns 0 on success, -1 on error
+FFI_EXPORT int bicubic_plan_execute(
+    BicubicPlan* plan,
+    const uint8_t* input,
+    uint8_t* output
+);
+
+// Destroy a plan created by bicubic_plan_create
+FFI_EXPORT void bicubic_plan_destroy(BicubicPlan* plan);
+
 // ============================================================================
 // JPEG resize functions (decode -> resize -> encode)
 // ============================================================================
 
-// Resize JPEG image
-// filter: 0=Catmull-Rom (default), 1=Cubic B-Spline, 2=Mitchell
-// edge_mode: 0=clamp (default), 1=wrap, 2=reflect, 3=zero
+// Resize JPEG image (grayscale JPEGs stay single-channel end to end)
+// filter: 0=Catmull-Rom (default), 1=Cubic B-Spline, 2=Mitchell, 3=auto
+//         (triangle/copy on axes scaled by less than 1.25x), or FILTER_AXES(h, v)
+// edge_mode: 0=clamp (default), 1=wrap, 2=reflect, 3=zero, or EDGE_AXES(h, v)
+// color_space: 0=gamma (default), 1=linear light (sRGB decoded before resampling)
+// reducing_gap: 0=off (default); >= 1 first box-averages the input down to
+//               about reducing_gap x the output size (faster extreme downscales)
 // quality: JPEG quality 1-100
+// chroma_subsampling: -1=auto (default), 0=4:4:4, 1=4:2:0
 // crop: crop factor (0.0-1.0), 1.0 = no crop, 0.5 = 50%
 // crop_anchor: 0=center (default), 1-8 = other positions
 // aspect_mode: 0=square (default), 1=original, 2=custom
 // aspect_w, aspect_h: custom aspect ratio (only used if aspect_mode=2)
 // apply_exif: 1=apply EXIF orientation (default), 0=ignore EXIF
+// num_threads: 0=auto (one per CPU core), 1=single-threaded, N=up to N threads
 // Returns 0 on success, -1 on error
 FFI_EXPORT int bicubic_resize_jpeg(
     const uint8_t* input_data,
@@ -124,14 +520,18 @@ FFI_EXPORT int bicubic_resize_jpeg(
     int output_width,
     int output_height,
     int quality,
+    int chroma_subsampling,
     int filter,
     int edge_mode,
+    int color_space,
+    float reducing_gap,
     float crop,
     int crop_anchor,
     int aspect_mode,
     float aspect_w,
     float aspect_h,
     int apply_exif,
+    int num_threads,
     uint8_t** output_data,
     int* output_size
 );
@@ -140,14 +540,21 @@ FFI_EXPORT int bicubic_resize_jpeg(
 // PNG resize functions (decode -> resize -> encode)
 // ============================================================================
 
-// Resize PNG image
-// filter: 0=Catmull-Rom (default), 1=Cubic B-Spline, 2=Mitchell
-// edge_mode: 0=clamp (default), 1=wrap, 2=reflect, 3=zero
+// Resize PNG image in its own channel count (gray, gray+alpha, RGB or RGBA);
+// a fully opaque alpha channel is dropped, so such PNGs are written as gray/RGB
+// filter: 0=Catmull-Rom (default), 1=Cubic B-Spline, 2=Mitchell, 3=auto
+//         (triangle/copy on axes scaled by less than 1.25x), or FILTER_AXES(h, v)
+// edge_mode: 0=clamp (default), 1=wrap, 2=reflect, 3=zero, or EDGE_AXES(h, v)
+// color_space: 0=gamma (default), 1=linear light (sRGB decoded before resampling)
+// reducing_gap: 0=off (default); >= 1 first box-averages the input down to
+//               about reducing_gap x the output size (faster extreme downscales)
 // crop: crop factor (0.0-1.0), 1.0 = no crop, 0.5 = 50%
 // crop_anchor: 0=center (default), 1-8 = other positions
 // aspect_mode: 0=square (default), 1=original, 2=custom
 // aspect_w, aspect_h: custom aspect ratio (only used if aspect_mode=2)
 // compression_level: PNG compression 0-9 (0=none, 9=max, default=6)
+// png_filter: -1=adaptive per row (default), 0-4=force none/sub/up/average/paeth
+// num_threads: 0=auto (one per CPU core), 1=single-threaded, N=up to N threads
 // Returns 0 on success, -1 on error
 FFI_EXPORT int bicubic_resize_png(
     const uint8_t* input_data,
@@ -156,16 +563,273 @@ FFI_EXPORT int bicubic_resize_png(
     int output_height,
     int filter,
     int edge_mode,
+    int color_space,
+    float reducing_gap,
+    float crop,
+    int crop_anchor,
+    int aspect_mode,
+    float aspect_w,
+    float aspect_h,
+    int compression_level,
+    int png_filter,
+    int num_threads,
+    uint8_t** output_data,
+    int* output_size
+);
+
+// ============================================================================
+// Batch resize (many JPEG/PNG images in one call)
+// ============================================================================
+
+// One image of a batch. Input fields are set by the caller; output_data,
+// output_size and result are filled in by bicubic_resize_batch.
+// The input format (JPEG or PNG) is detected from the data.
+typedef struct {
+    const uint8_t* input_data;
+    int input_size;
+    int output_width;
+    int output_height;
+    int quality;            // JPEG quality 1-100 (ignored for PNG)
+    int compression_level;  // PNG compression 0-9 (ignored for JPEG)
+    int chroma_subsampling; // JPEG_SUBSAMPLING_* (ignored for PNG)
+    int png_filter;         // PNG_FILTER_* (ignored for JPEG)
+    int filter;             // FILTER_* or FILTER_AXES(h, v)
+    int edge_mode;          // EDGE_* or EDGE_AXES(h, v)
+    int color_space;        // COLOR_SPACE_*
+    float reducing_gap;     // 0 = off, see bicubic_resize_rgb
+    float crop;
+    int crop_anchor;
+    int aspect_mode;
+    float aspect_w;
+    float aspect_h;
+    int apply_exif;         // JPEG only
+    uint8_t* output_data;   // Encoded output, free with free_buffer
+    int output_size;
+    int result;             // 0 on success, -1 on error
+} BicubicBatchItem;
+
+// Resize a batch of JPEG/PNG images, running items in parallel
+// items: array of count items (see BicubicBatchItem)
+// num_threads: 0=auto (one per CPU core), 1=single-threaded, N=up to N threads
+// Returns 0 if every item succeeded, -1 if any item failed
+FFI_EXPORT int bicubic_resize_batch(
+    BicubicBatchItem* items,
+    int count,
+    int num_threads
+);
+
+// ============================================================================
+// Multi-rendition resize (one decode, many output sizes)
+// ============================================================================
+
+#define OUTPUT_FORMAT_JPEG 0
+#define OUTPUT_FORMAT_PNG  1
+
+// One rendition of a bicubic_resize_multi call. Input fields are set by the
+// caller; output_data, output_size and result are filled in.
+typedef struct {
+    int output_width;
+    int output_height;
+    int format;             // OUTPUT_FORMAT_JPEG or OUTPUT_FORMAT_PNG
+    int quality;            // JPEG quality 1-100
+    int chroma_subsampling; // JPEG_SUBSAMPLING_*
+    int compression_level;  // PNG compression 0-9
+    int png_filter;         // PNG_FILTER_*
+    int filter;             // FILTER_* or FILTER_AXES(h, v)
+    int edge_mode;          // EDGE_* or EDGE_AXES(h, v)
+    int color_space;        // COLOR_SPACE_*
+    float reducing_gap;     // 0 = off, see bicubic_resize_rgb
+    float crop;
+    int crop_anchor;
+    int aspect_mode;
+    float aspect_w;
+    float aspect_h;
+    uint8_t* output_data;   // Encoded output, free with free_buffer
+    int output_size;
+    int result;             // 0 on success, -1 on error
+} BicubicOutputSpec;
+
+// Decode a JPEG/PNG once and produce every rendition in specs from it.
+// EXIF orientation (JPEG, apply_exif=1) is applied once to the decoded image.
+// Smaller renditions are resampled from the nearest rendition of the same
+// crop window that is at least 2x larger, instead of from the source.
+// num_threads: 0=auto (one per CPU core), 1=single-threaded, N=up to N threads
+// Returns 0 if every rendition succeeded, -1 if any failed
+FFI_EXPORT int bicubic_resize_multi(
+    const uint8_t* input_data,
+    int input_size,
+    BicubicOutputSpec* specs,
+    int count,
+    int apply_exif,
+    int num_threads
+);
+
+// ============================================================================
+// Decoded image handles (decode once, crop/resize/encode many times)
+// ============================================================================
+
+// Opaque handle holding fully decoded, EXIF-oriented pixels
+typedef struct BicubicImage BicubicImage;
+
+// Decode a JPEG/PNG into a handle. JPEGs decode to RGB (gray when grayscale),
+// PNGs keep their channel count (gray, gray+alpha, RGB or RGBA), minus a
+// fully opaque alpha channel.
+// apply_exif: 1 = apply JPEG EXIF orientation while decoding
+// Returns NULL on error. Destroy with bicubic_image_destroy.
+// A handle is read-only after creation, so it may be resized or encoded from
+// several threads at the same time.
+FFI_EXPORT BicubicImage* bicubic_image_create(
+    const uint8_t* input_data,
+    int input_size,
+    int apply_exif
+);
+
+// Get the oriented dimensions and channel count (1-4) of a handle
+// Returns 0 on success, -1 on error
+FFI_EXPORT int bicubic_image_info(
+    const BicubicImage* image,
+    int* width,
+    int* height,
+    int* channels
+);
+
+// Resize (and crop) a handle into raw pixels
+// output: output_width * output_height * channels bytes, tightly packed
+// Parameters as in bicubic_resize_jpeg
+// Returns 0 on success, -1 on error
+FFI_EXPORT int bicubic_image_resize(
+    const BicubicImage* image,
+    uint8_t* output,
+    int output_width,
+    int output_height,
+    int filter,
+    int edge_mode,
+    int color_space,
+    float reducing_gap,
     float crop,
     int crop_anchor,
     int aspect_mode,
     float aspect_w,
     float aspect_h,
+    int num_threads
+);
+
+// Resize (and crop) a handle and encode the result
+// format: OUTPUT_FORMAT_JPEG or OUTPUT_FORMAT_PNG (RGBA handles lose alpha
+// as JPEG); other parameters as in bicubic_resize_jpeg / bicubic_resize_png
+// output_data: encoded output, free with free_buffer
+// Returns 0 on success, -1 on error
+FFI_EXPORT int bicubic_image_encode(
+    const BicubicImage* image,
+    int output_width,
+    int output_height,
+    int format,
+    int quality,
+    int chroma_subsampling,
     int compression_level,
+    int png_filter,
+    int filter,
+    int edge_mode,
+    int color_space,
+    float reducing_gap,
+    float crop,
+    int crop_anchor,
+    int aspect_mode,
+    float aspect_w,
+    float aspect_h,
+    int num_threads,
     uint8_t** output_data,
     int* output_size
 );
 
+// Destroy a handle created by bicubic_image_create
+FFI_EXPORT void bicubic_image_destroy(BicubicImage* image);
+
+// ============================================================================
+// Image probing (header only, no pixel decode)
+// ============================================================================
+
+// Header information of a JPEG/PNG image, filled in by bicubic_probe
+typedef struct {
+    int width;        // Width after EXIF orientation
+    int height;       // Height after EXIF orientation
+    int channels;     // Stored channels: 1=gray, 2=gray+alpha, 3=RGB, 4=RGBA
+    int bit_depth;    // Bits per sample (JPEG 8/12, PNG 1/2/4/8/16)
+    int orientation;  // EXIF orientation 1-8 (always 1 for PNG)
+    int format;       // OUTPUT_FORMAT_JPEG or OUTPUT_FORMAT_PNG
+    int progressive;  // 1 = progressive JPEG or Adam7-interlaced PNG
+    int result;       // 0 on success, -1 on error
+} BicubicProbeInfo;
+
+// Read the dimensions, channels, bit depth and orientation of a JPEG/PNG
+// from its headers, without decoding pixels
+// Returns 0 on success, -1 on error (unsupported format or bad header)
+FFI_EXPORT int bicubic_probe(
+    const uint8_t* input_data,
+    int input_size,
+    BicubicProbeInfo* info
+);
+
+// Probe count images; inputs[i] holds input_sizes[i] bytes
+// Returns 0 if every image was probed, -1 if any failed (see infos[i].result)
+FFI_EXPORT int bicubic_probe_batch(
+    const uint8_t* const* inputs,
+    const int* input_sizes,
+    int count,
+    BicubicProbeInfo* infos
+);
+
+// ============================================================================
+// Async execution (completion posted to a Dart port)
+// ============================================================================
+
+// Async jobs run on internal native threads and report completion by posting
+// an array [result, outputs...] to a Dart SendPort (ReceivePort.sendPort's
+// nativePort). Outputs arrive as Uint8Lists that own the native buffers, or
+// null for a failed item. Inputs must stay valid until the message arrives.
+
+// Register the Dart_PostCObject function (NativeApi.postCObject in Dart).
+// Must be called before any async job; NULL is ignored.
+FFI_EXPORT void bicubic_async_init(void* post_cobject_fn);
+
+// Queue a raw gray/RGB/RGBA resize (see bicubic_resize_rgb_strided)
+// channels: 1 (gray), 2 (gray+alpha), 3 (RGB) or 4 (RGBA)
+// alpha_mode: see bicubic_resize_rgba (ignored without an alpha channel)
+// Posts [result, pixels] with tightly packed output rows
+// Returns 0 if the job was queued, -1 on error (nothing is posted)
+FFI_EXPORT int bicubic_resize_raw_async(
+    const uint8_t* input,
+    int input_width,
+    int input_height,
+    int input_stride,
+    int channels,
+    int output_width,
+    int output_height,
+    int filter,
+    int edge_mode,
+    int color_space,
+    int alpha_mode,
+    float reducing_gap,
+    float crop,
+    int crop_anchor,
+    int aspect_mode,
+    float aspect_w,
+    float aspect_h,
+    int num_threads,
+    int64_t port
+);
+
+// Queue a batch of JPEG/PNG resizes (see bicubic_resize_batch); a single
+// encoded image is a batch of one. Posts [result, output0, output1, ...];
+// the items' output_data fields are left NULL.
+// Returns 0 if the job was queued, -1 on error (nothing is posted)
+FFI_EXPORT int bicubic_resize_batch_async(
+    BicubicBatchItem* items,
+    int count,
+    int num_threads,
+    int64_t port
+);
+
 // ============================================================================
 // Memory management
 // ============================================================================
@@ -173,6 +837,15 @@ FFI_EXPORT int bicubic_resize_png(
 // Free buffer allocated by resize functions
 FFI_EXPORT void free_buffer(uint8_t* buffer);
 
+// Scratch memory (decoded pixels, resize samplers, encoder buffers) of each
+// resize call is carved from a pooled arena that is reused by later calls.
+// Set the most memory the pool keeps cached between calls (default 64 MB);
+// 0 disables the arenas and every allocation goes straight to malloc.
+FFI_EXPORT void bicubic_arena_set_limit(int64_t max_bytes);
+
+// Release all cached arena memory (e.g. on a low-memory warning)
+FFI_EXPORT void bicubic_arena_trim(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -421,7 +421,28 @@ typedef struct
 //
 
 STBIDEF stbi_uc *stbi_load_from_memory   (stbi_uc           const *buffer, int len   , int *x, int *y, int *channels_in_file, int desired_channels);
+#ifndef STBI_NO_JPEG
+// decode a JPEG at 1/(1<<scale_shift) size (scale_shift 0..3) using a reduced IDCT;
+// *x and *y receive the reduced dimensions
+STBIDEF stbi_uc *stbi_load_jpeg_from_memory_scaled(stbi_uc const *buffer, int len, int *x, int *y, int *channels_in_file, int desired_channels, int scale_shift);
+// as above, but only the region (rx,ry,rw,rh) of the reduced image is IDCT'd,
+// color converted and returned; *x and *y receive rw and rh
+STBIDEF stbi_uc *stbi_load_jpeg_from_memory_region(stbi_uc const *buffer, int len, int *x, int *y, int *channels_in_file, int desired_channels, int scale_shift, int rx, int ry, int rw, int rh);
+#endif
 STBIDEF stbi_uc *stbi_load_from_callbacks(stbi_io_callbacks const *clbk  , void *user, int *x, int *y, int *channels_in_file, int desired_channels);
+#ifndef STBI_NO_PNG
+// row-at-a-time decoding of non-interlaced 8/16-bit PNGs: memory is a few
+// scanlines plus a 64K inflate window instead of the whole image. open
+// returns NULL for PNGs it does not stream (interlaced, sub-byte depths,
+// tRNS on gray/RGB) so callers can fall back to stbi_load_from_memory;
+// *comp receives the 8-bit channels written per row (palettes expand to
+// the narrowest of 1-4 channels that holds them). read_row returns 0 on
+// corrupt data.
+typedef struct stbi_png_stream stbi_png_stream;
+STBIDEF stbi_png_stream *stbi_png_stream_open(stbi_uc const *buffer, int len, int *x, int *y, int *comp);
+STBIDEF int  stbi_png_stream_read_row(stbi_png_stream *ps, stbi_uc *row);
+STBIDEF void stbi_png_stream_close(stbi_png_stream *ps);
+#endif
 
 #ifndef STBI_NO_STDIO
 STBIDEF stbi_uc *stbi_load            (char const *filename, int *x, int *y, int *channels_in_file, int desired_channels);
@@ -1193,13 +1214,13 @@ static stbi_uc *stbi__convert_16_to_8(stbi__uint16 *orig, int w, int h, int chan
    int img_len = w * h * channels;
    stbi_uc *reduced;
 
-   reduced = (stbi_uc *) stbi__malloc(img_len);
-   if (reduced == NULL) return stbi__errpuc("outofmem", "Out of memory");
+   // narrow in place; byte i is written only after the 16-bit
+   // sample it overlaps has been read, so no second image-sized buffer
+   reduced = (stbi_uc *) orig;
 
    for (i = 0; i < img_len; ++i)
       reduced[i] = (stbi_uc)((orig[i] >> 8) & 0xFF); // top half of each byte is sufficient approx of 16->8 bit scaling
 
-   STBI_FREE(orig);
    return reduced;
 }
 
@@ -1994,6 +2015,9 @@ typedef struct
    int scan_n, order[4];
    int restart_interval, todo;
 
+   int scale_shift; // reduced-size decode: blocks are written as (8>>scale_shift)^2 pixels
+   int roi_x, roi_y, roi_w, roi_h; // region of the (reduced) image to output; roi_w 0 = whole image
+
 // kernels
    void (*idct_block_kernel)(stbi_uc *out, int out_stride, short data[64]);
    void (*YCbCr_to_RGB_kernel)(stbi_uc *out, const stbi_uc *y, const stbi_uc *pcb, const stbi_uc *pcr, int count, int step);
@@ -2946,6 +2970,72 @@ static void stbi__jpeg_reset(stbi__jpeg *j)
    // since we don't even allow 1<<30 pixels
 }
 
+// reduced-size IDCT: evaluates the block's lowest n x n frequencies at the
+// centres of an n x n grid, n = 8 >> shift. At 1/8 only the DC term is used.
+static void stbi__idct_scaled(stbi_uc *out, int out_stride, short data[64], int shift)
+{
+   // c(u) * cos((2x+1) * u * pi / 2n), indexed [x][u]
+   static const float t2[2][2] = {
+      { 0.70710678f,  0.70710678f },
+      { 0.70710678f, -0.70710678f },
+   };
+   static const float t4[4][4] = {
+      { 0.70710678f,  0.92387953f,  0.70710678f,  0.38268343f },
+      { 0.70710678f,  0.38268343f, -0.70710678f, -0.92387953f },
+      { 0.70710678f, -0.38268343f, -0.70710678f,  0.92387953f },
+      { 0.70710678f, -0.92387953f,  0.70710678f, -0.38268343f },
+   };
+   float tmp[4][4];
+   const float *t;
+   int n = 8 >> shift, x, y, u;
+
+   if (n == 1) {
+      out[0] = stbi__clamp(((data[0] + 4) >> 3) + 128);
+      return;
+   }
+   t = (n == 2) ? &t2[0][0] : &t4[0][0];
+
+   // rows, then columns
+   for (y=0; y < n; ++y) {
+      for (x=0; x < n; ++x) {
+         float sum = 0;
+         for (u=0; u < n; ++u)
+            sum += t[x*n+u] * data[y*8+u];
+         tmp[y][x] = sum;
+      }
+   }
+   for (y=0; y < n; ++y) {
+      for (x=0; x < n; ++x) {
+         float sum = 0;
+         for (u=0; u < n; ++u)
+            sum += t[y*n+u] * tmp[u][x];
+         out[y*out_stride+x] = stbi__clamp((int) (sum * 0.25f + 128.5f));
+      }
+   }
+}
+
+// write one dequantized block to its component plane at block (bx,by); blocks
+// more than one MCU away from the output region are skipped (the margin keeps
+// the chroma upsampler's neighbours valid)
+static void stbi__jpeg_put_block(stbi__jpeg *z, int n, int bx, int by, short data[64])
+{
+   int bs = 8 >> z->scale_shift;
+   stbi_uc *out = z->img_comp[n].data + z->img_comp[n].w2*by*bs + bx*bs;
+   if (z->roi_w > 0) {
+      int bw = bs * (z->img_h_max / z->img_comp[n].h);
+      int bh = bs * (z->img_v_max / z->img_comp[n].v);
+      int mx = z->img_mcu_w >> z->scale_shift;
+      int my = z->img_mcu_h >> z->scale_shift;
+      if ((bx+1)*bw + mx <= z->roi_x || bx*bw >= z->roi_x + z->roi_w + mx ||
+          (by+1)*bh + my <= z->roi_y || by*bh >= z->roi_y + z->roi_h + my)
+         return;
+   }
+   if (z->scale_shift == 0)
+      z->idct_block_kernel(out, z->img_comp[n].w2, data);
+   else
+      stbi__idct_scaled(out, z->img_comp[n].w2, data, z->scale_shift);
+}
+
 static int stbi__parse_entropy_coded_data(stbi__jpeg *z)
 {
    stbi__jpeg_reset(z);
@@ -2964,7 +3054,7 @@ static int stbi__parse_entropy_coded_data(stbi__jpeg *z)
             for (i=0; i < w; ++i) {
                int ha = z->img_comp[n].ha;
                if (!stbi__jpeg_decode_block(z, data, z->huff_dc+z->img_comp[n].hd, z->huff_ac+ha, z->fast_ac[ha], n, z->dequant[z->img_comp[n].tq])) return 0;
-               z->idct_block_kernel(z->img_comp[n].data+z->img_comp[n].w2*j*8+i*8, z->img_comp[n].w2, data);
+               stbi__jpeg_put_block(z, n, i, j, data);
                // every data block is an MCU, so countdown the restart interval
                if (--z->todo <= 0) {
                   if (z->code_bits < 24) stbi__grow_buffer_unsafe(z);
@@ -2988,11 +3078,11 @@ static int stbi__parse_entropy_coded_data(stbi__jpeg *z)
                   // by the basic H and V specified for the component
                   for (y=0; y < z->img_comp[n].v; ++y) {
                      for (x=0; x < z->img_comp[n].h; ++x) {
-                        int x2 = (i*z->img_comp[n].h + x)*8;
-                        int y2 = (j*z->img_comp[n].v + y)*8;
+                        int x2 = (i*z->img_comp[n].h + x);
+                        int y2 = (j*z->img_comp[n].v + y);
                         int ha = z->img_comp[n].ha;
                         if (!stbi__jpeg_decode_block(z, data, z->huff_dc+z->img_comp[n].hd, z->huff_ac+ha, z->fast_ac[ha], n, z->dequant[z->img_comp[n].tq])) return 0;
-                        z->idct_block_kernel(z->img_comp[n].data+z->img_comp[n].w2*y2+x2, z->img_comp[n].w2, data);
+                        stbi__jpeg_put_block(z, n, x2, y2, data);
                      }
                   }
                }
@@ -3089,7 +3179,7 @@ static void stbi__jpeg_finish(stbi__jpeg *z)
             for (i=0; i < w; ++i) {
                short *data = z->img_comp[n].coeff + 64 * (i + j * z->img_comp[n].coeff_w);
                stbi__jpeg_dequantize(data, z->dequant[z->img_comp[n].tq]);
-               z->idct_block_kernel(z->img_comp[n].data+z->img_comp[n].w2*j*8+i*8, z->img_comp[n].w2, data);
+               stbi__jpeg_put_block(z, n, i, j, data);
             }
          }
       }
@@ -3329,8 +3419,8 @@ static int stbi__process_frame_header(stbi__jpeg *z, int scan)
       //
       // img_mcu_x, img_mcu_y: <=17 bits; comp[i].h and .v are <=4 (checked earlier)
       // so these muls can't overflow with 32-bit ints (which we require)
-      z->img_comp[i].w2 = z->img_mcu_x * z->img_comp[i].h * 8;
-      z->img_comp[i].h2 = z->img_mcu_y * z->img_comp[i].v * 8;
+      z->img_comp[i].w2 = z->img_mcu_x * z->img_comp[i].h * (8 >> z->scale_shift);
+      z->img_comp[i].h2 = z->img_mcu_y * z->img_comp[i].v * (8 >> z->scale_shift);
       z->img_comp[i].coeff = 0;
       z->img_comp[i].raw_coeff = 0;
       z->img_comp[i].linebuf = NULL;
@@ -3340,10 +3430,10 @@ static int stbi__process_frame_header(stbi__jpeg *z, int scan)
       // align blocks for idct using mmx/sse
       z->img_comp[i].data = (stbi_uc*) (((size_t) z->img_comp[i].raw_data + 15) & ~15);
       if (z->progressive) {
-         // w2, h2 are multiples of 8 (see above)
-         z->img_comp[i].coeff_w = z->img_comp[i].w2 / 8;
-         z->img_comp[i].coeff_h = z->img_comp[i].h2 / 8;
-         z->img_comp[i].raw_coeff = stbi__malloc_mad3(z->img_comp[i].w2, z->img_comp[i].h2, sizeof(short), 15);
+         // coefficients are kept for every 8x8 block, whatever the output scale
+         z->img_comp[i].coeff_w = z->img_mcu_x * z->img_comp[i].h;
+         z->img_comp[i].coeff_h = z->img_mcu_y * z->img_comp[i].v;
+         z->img_comp[i].raw_coeff = stbi__malloc_mad3(z->img_comp[i].coeff_w * 8, z->img_comp[i].coeff_h * 8, sizeof(short), 15);
          if (z->img_comp[i].raw_coeff == NULL)
             return stbi__free_jpeg_components(z, i+1, stbi__err("outofmem", "Out of memory"));
          z->img_comp[i].coeff = (short*) (((size_t) z->img_comp[i].raw_coeff + 15) & ~15);
@@ -3873,6 +3963,33 @@ static stbi_uc *load_jpeg_image(stbi__jpeg *z, int *out_x, int *out_y, int *comp
    // load a jpeg image from whichever source, but leave in YCbCr format
    if (!stbi__decode_jpeg_image(z)) { stbi__cleanup_jpeg(z); return NULL; }
 
+   // reduced-size decode: everything below works on the scaled planes
+   if (z->scale_shift) {
+      int k, round = (1 << z->scale_shift) - 1;
+      z->s->img_x = (z->s->img_x + round) >> z->scale_shift;
+      z->s->img_y = (z->s->img_y + round) >> z->scale_shift;
+      for (k=0; k < z->s->img_n; ++k) {
+         z->img_comp[k].x = (z->img_comp[k].x + round) >> z->scale_shift;
+         z->img_comp[k].y = (z->img_comp[k].y + round) >> z->scale_shift;
+      }
+   }
+
+   // output region, clamped to the image
+   if (z->roi_w <= 0 || z->roi_h <= 0) {
+      z->roi_x = z->roi_y = 0;
+      z->roi_w = z->s->img_x;
+      z->roi_h = z->s->img_y;
+   } else {
+      int x1 = z->roi_x + z->roi_w, y1 = z->roi_y + z->roi_h;
+      if (z->roi_x < 0) z->roi_x = 0;
+      if (z->roi_y < 0) z->roi_y = 0;
+      if (x1 > (int) z->s->img_x) x1 = z->s->img_x;
+      if (y1 > (int) z->s->img_y) y1 = z->s->img_y;
+      if (x1 <= z->roi_x || y1 <= z->roi_y) { stbi__cleanup_jpeg(z); return stbi__errpuc("bad region", "Region outside image"); }
+      z->roi_w = x1 - z->roi_x;
+      z->roi_h = y1 - z->roi_y;
+   }
+
    // determine actual number of components to generate
    n = req_comp ? req_comp : z->s->img_n >= 3 ? 3 : 1;
 
@@ -3919,19 +4036,22 @@ static stbi_uc *load_jpeg_image(stbi__jpeg *z, int *out_x, int *out_y, int *comp
       }
 
       // can't error after this so, this is safe
-      output = (stbi_uc *) stbi__malloc_mad3(n, z->s->img_x, z->s->img_y, 1);
+      output = (stbi_uc *) stbi__malloc_mad3(n, z->roi_w, z->roi_h, 1);
       if (!output) { stbi__cleanup_jpeg(z); return stbi__errpuc("outofmem", "Out of memory"); }
 
-      // now go ahead and resample
-      for (j=0; j < z->s->img_y; ++j) {
-         stbi_uc *out = output + n * z->s->img_x * j;
+      // now go ahead and resample; rows above the region only advance the
+      // resamplers, columns outside it are not color converted
+      for (j=0; j < (unsigned int) (z->roi_y + z->roi_h); ++j) {
+         stbi_uc *out;
+         int in_region = j >= (unsigned int) z->roi_y;
          for (k=0; k < decode_n; ++k) {
             stbi__resample *r = &res_comp[k];
             int y_bot = r->ystep >= (r->vs >> 1);
-            coutput[k] = r->resample(z->img_comp[k].linebuf,
-                                     y_bot ? r->line1 : r->line0,
-                                     y_bot ? r->line0 : r->line1,
-                                     r->w_lores, r->hs);
+            if (in_region)
+               coutput[k] = r->resample(z->img_comp[k].linebuf,
+                                        y_bot ? r->line1 : r->line0,
+                                        y_bot ? r->line0 : r->line1,
+                                        r->w_lores, r->hs) + z->roi_x;
             if (++r->ystep >= r->vs) {
                r->ystep = 0;
                r->line0 = r->line1;
@@ -3939,11 +4059,13 @@ static stbi_uc *load_jpeg_image(stbi__jpeg *z, int *out_x, int *out_y, int *comp
                   r->line1 += z->img_comp[k].w2;
             }
          }
+         if (!in_region) continue;
+         out = output + n * z->roi_w * (j - z->roi_y);
          if (n >= 3) {
             stbi_uc *y = coutput[0];
             if (z->s->img_n == 3) {
                if (is_rgb) {
-                  for (i=0; i < z->s->img_x; ++i) {
+                  for (i=0; i < (unsigned int) z->roi_w; ++i) {
                      out[0] = y[i];
                      out[1] = coutput[1][i];
                      out[2] = coutput[2][i];
@@ -3951,11 +4073,11 @@ static stbi_uc *load_jpeg_image(stbi__jpeg *z, int *out_x, int *out_y, int *comp
                      out += n;
                   }
                } else {
-                  z->YCbCr_to_RGB_kernel(out, y, coutput[1], coutput[2], z->s->img_x, n);
+                  z->YCbCr_to_RGB_kernel(out, y, coutput[1], coutput[2], z->roi_w, n);
                }
             } else if (z->s->img_n == 4) {
                if (z->app14_color_transform == 0) { // CMYK
-                  for (i=0; i < z->s->img_x; ++i) {
+                  for (i=0; i < (unsigned int) z->roi_w; ++i) {
                      stbi_uc m = coutput[3][i];
                      out[0] = stbi__blinn_8x8(coutput[0][i], m);
                      out[1] = stbi__blinn_8x8(coutput[1][i], m);
@@ -3964,8 +4086,8 @@ static stbi_uc *load_jpeg_image(stbi__jpeg *z, int *out_x, int *out_y, int *comp
                      out += n;
                   }
                } else if (z->app14_color_transform == 2) { // YCCK
-                  z->YCbCr_to_RGB_kernel(out, y, coutput[1], coutput[2], z->s->img_x, n);
-                  for (i=0; i < z->s->img_x; ++i) {
+                  z->YCbCr_to_RGB_kernel(out, y, coutput[1], coutput[2], z->roi_w, n);
+                  for (i=0; i < (unsigned int) z->roi_w; ++i) {
                      stbi_uc m = coutput[3][i];
                      out[0] = stbi__blinn_8x8(255 - out[0], m);
                      out[1] = stbi__blinn_8x8(255 - out[1], m);
@@ -3973,10 +4095,10 @@ static stbi_uc *load_jpeg_image(stbi__jpeg *z, int *out_x, int *out_y, int *comp
                      out += n;
                   }
                } else { // YCbCr + alpha?  Ignore the fourth channel for now
-                  z->YCbCr_to_RGB_kernel(out, y, coutput[1], coutput[2], z->s->img_x, n);
+                  z->YCbCr_to_RGB_kernel(out, y, coutput[1], coutput[2], z->roi_w, n);
                }
             } else
-               for (i=0; i < z->s->img_x; ++i) {
+               for (i=0; i < (unsigned int) z->roi_w; ++i) {
                   out[0] = out[1] = out[2] = y[i];
                   out[3] = 255; // not used if n==3
                   out += n;
@@ -3984,16 +4106,16 @@ static stbi_uc *load_jpeg_image(stbi__jpeg *z, int *out_x, int *out_y, int *comp
          } else {
             if (is_rgb) {
                if (n == 1)
-                  for (i=0; i < z->s->img_x; ++i)
+                  for (i=0; i < (unsigned int) z->roi_w; ++i)
                      *out++ = stbi__compute_y(coutput[0][i], coutput[1][i], coutput[2][i]);
                else {
-                  for (i=0; i < z->s->img_x; ++i, out += 2) {
+                  for (i=0; i < (unsigned int) z->roi_w; ++i, out += 2) {
                      out[0] = stbi__compute_y(coutput[0][i], coutput[1][i], coutput[2][i]);
                      out[1] = 255;
                   }
                }
             } else if (z->s->img_n == 4 && z->app14_color_transform == 0) {
-               for (i=0; i < z->s->img_x; ++i) {
+               for (i=0; i < (unsigned int) z->roi_w; ++i) {
                   stbi_uc m = coutput[3][i];
                   stbi_uc r = stbi__blinn_8x8(coutput[0][i], m);
                   stbi_uc g = stbi__blinn_8x8(coutput[1][i], m);
@@ -4003,7 +4125,7 @@ static stbi_uc *load_jpeg_image(stbi__jpeg *z, int *out_x, int *out_y, int *comp
                   out += n;
                }
             } else if (z->s->img_n == 4 && z->app14_color_transform == 2) {
-               for (i=0; i < z->s->img_x; ++i) {
+               for (i=0; i < (unsigned int) z->roi_w; ++i) {
                   out[0] = stbi__blinn_8x8(255 - coutput[0][i], coutput[3][i]);
                   out[1] = 255;
                   out += n;
@@ -4011,15 +4133,15 @@ static stbi_uc *load_jpeg_image(stbi__jpeg *z, int *out_x, int *out_y, int *comp
             } else {
                stbi_uc *y = coutput[0];
                if (n == 1)
-                  for (i=0; i < z->s->img_x; ++i) out[i] = y[i];
+                  for (i=0; i < (unsigned int) z->roi_w; ++i) out[i] = y[i];
                else
-                  for (i=0; i < z->s->img_x; ++i) { *out++ = y[i]; *out++ = 255; }
+                  for (i=0; i < (unsigned int) z->roi_w; ++i) { *out++ = y[i]; *out++ = 255; }
             }
          }
       }
       stbi__cleanup_jpeg(z);
-      *out_x = z->s->img_x;
-      *out_y = z->s->img_y;
+      *out_x = z->roi_w;
+      *out_y = z->roi_h;
       if (comp) *comp = z->s->img_n >= 3 ? 3 : 1; // report original components, not output
       return output;
    }
@@ -4053,6 +4175,32 @@ static int stbi__jpeg_test(stbi__context *s)
    return r;
 }
 
+STBIDEF stbi_uc *stbi_load_jpeg_from_memory_scaled(stbi_uc const *buffer, int len, int *x, int *y, int *comp, int req_comp, int scale_shift)
+{
+   return stbi_load_jpeg_from_memory_region(buffer, len, x, y, comp, req_comp, scale_shift, 0, 0, 0, 0);
+}
+
+STBIDEF stbi_uc *stbi_load_jpeg_from_memory_region(stbi_uc const *buffer, int len, int *x, int *y, int *comp, int req_comp, int scale_shift, int rx, int ry, int rw, int rh)
+{
+   unsigned char* result;
+   stbi__context s;
+   stbi__jpeg* j;
+   stbi__start_mem(&s,buffer,len);
+   j = (stbi__jpeg*) stbi__malloc(sizeof(stbi__jpeg));
+   if (!j) return stbi__errpuc("outofmem", "Out of memory");
+   memset(j, 0, sizeof(stbi__jpeg));
+   j->s = &s;
+   j->scale_shift = scale_shift < 0 ? 0 : scale_shift > 3 ? 3 : scale_shift;
+   j->roi_x = rx;
+   j->roi_y = ry;
+   j->roi_w = rw;
+   j->roi_h = rh;
+   stbi__setup_jpeg(j);
+   result = load_jpeg_image(j, x,y,comp,req_comp);
+   STBI_FREE(j);
+   return result;
+}
+
 static int stbi__jpeg_info_raw(stbi__jpeg *j, int *x, int *y, int *comp)
 {
    if (!stbi__decode_jpeg_header(j, STBI__SCAN_header)) {
@@ -4517,6 +4665,163 @@ static int stbi__do_zlib(stbi__zbuf *a, char *obuf, int olen, int exp, int parse
    return stbi__parse_zlib(a, parse_header);
 }
 
+// streaming inflate for PNG rows: output goes into a sliding window instead of
+// one buffer for the whole stream, so a decoder can consume it a scanline at a
+// time. The window keeps the last 32K of output that matches may refer back to.
+#define STBI__ZSTREAM_HISTORY 32768
+#define STBI__ZSTREAM_WINDOW  (STBI__ZSTREAM_HISTORY * 2)
+
+typedef struct
+{
+   stbi__zbuf z;      // bit reader and the current block's huffman tables
+   stbi_uc *window;
+   int wpos, rpos;    // bytes produced into / consumed from window
+   int block;         // 0 = expecting a block header, 1 = stored, 2 = huffman
+   int final, done;
+   int stored_left;
+} stbi__zstream;
+
+static int stbi__zstream_init(stbi__zstream *zs, stbi_uc const *buffer, int len)
+{
+   memset(zs, 0, sizeof(*zs));
+   zs->z.zbuffer = (stbi_uc *) buffer;
+   zs->z.zbuffer_end = (stbi_uc *) buffer + len;
+   if (!stbi__parse_zlib_header(&zs->z)) return 0;
+   zs->window = (stbi_uc *) stbi__malloc(STBI__ZSTREAM_WINDOW);
+   if (zs->window == NULL) return stbi__err("outofmem", "Out of memory");
+   return 1;
+}
+
+static int stbi__zstream_block_header(stbi__zstream *zs)
+{
+   stbi__zbuf *a = &zs->z;
+   int type;
+   zs->final = stbi__zreceive(a,1);
+   type = stbi__zreceive(a,2);
+   if (type == 0) {
+      // same header handling as stbi__parse_uncompressed_block; the payload
+      // is copied out piecewise by stbi__zstream_fill
+      stbi_uc header[4];
+      int len,nlen,k;
+      if (a->num_bits & 7)
+         stbi__zreceive(a, a->num_bits & 7); // discard
+      k = 0;
+      while (a->num_bits > 0) {
+         header[k++] = (stbi_uc) (a->code_buffer & 255);
+         a->code_buffer >>= 8;
+         a->num_bits -= 8;
+      }
+      if (a->num_bits < 0) return stbi__err("zlib corrupt","Corrupt PNG");
+      while (k < 4)
+         header[k++] = stbi__zget8(a);
+      len  = header[1] * 256 + header[0];
+      nlen = header[3] * 256 + header[2];
+      if (nlen != (len ^ 0xffff)) return stbi__err("zlib corrupt","Corrupt PNG");
+      if (a->zbuffer + len > a->zbuffer_end) return stbi__err("read past buffer","Corrupt PNG");
+      zs->stored_left = len;
+      zs->block = 1;
+   } else if (type == 3) {
+      return stbi__err("bad block type","Corrupt PNG");
+   } else {
+      if (type == 1) {
+         if (!stbi__zbuild_huffman(&a->z_length  , stbi__zdefault_length  , STBI__ZNSYMS)) return 0;
+         if (!stbi__zbuild_huffman(&a->z_distance, stbi__zdefault_distance,  32)) return 0;
+      } else {
+         if (!stbi__compute_huffman_codes(a)) return 0;
+      }
+      zs->block = 2;
+   }
+   return 1;
+}
+
+// decode until the window is nearly full or the stream ends; must only be
+// called once everything produced so far has been consumed
+static int stbi__zstream_fill(stbi__zstream *zs)
+{
+   stbi__zbuf *a = &zs->z;
+   stbi_uc *win = zs->window;
+   int limit = STBI__ZSTREAM_WINDOW - 258; // leaves room for the longest match
+   int wpos;
+
+   // keep only the history matches may still refer to
+   if (zs->wpos > STBI__ZSTREAM_HISTORY) {
+      memmove(win, win + zs->wpos - STBI__ZSTREAM_HISTORY, STBI__ZSTREAM_HISTORY);
+      zs->wpos = zs->rpos = STBI__ZSTREAM_HISTORY;
+   }
+   wpos = zs->wpos;
+
+   while (wpos < limit && !zs->done) {
+      if (zs->block == 0) {
+         if (zs->final) { zs->done = 1; break; }
+         if (!stbi__zstream_block_header(zs)) return 0;
+      } else if (zs->block == 1) {
+         int n = zs->stored_left;
+         if (n > STBI__ZSTREAM_WINDOW - wpos) n = STBI__ZSTREAM_WINDOW - wpos;
+         memcpy(win + wpos, a->zbuffer, n);
+         a->zbuffer += n;
+         wpos += n;
+         zs->stored_left -= n;
+         if (zs->stored_left == 0) zs->block = 0;
+      } else {
+         // same symbol decoding as stbi__parse_huffman_block
+         while (wpos < limit) {
+            int z = stbi__zhuffman_decode(a, &a->z_length);
+            if (z < 256) {
+               if (z < 0) return stbi__err("bad huffman code","Corrupt PNG");
+               win[wpos++] = (stbi_uc) z;
+            } else {
+               stbi_uc *p, *q;
+               int len,dist;
+               if (z == 256) {
+                  if (a->hit_zeof_once && a->num_bits < 16)
+                     return stbi__err("unexpected end","Corrupt PNG");
+                  zs->block = 0;
+                  break;
+               }
+               if (z >= 286) return stbi__err("bad huffman code","Corrupt PNG");
+               z -= 257;
+               len = stbi__zlength_base[z];
+               if (stbi__zlength_extra[z]) len += stbi__zreceive(a, stbi__zlength_extra[z]);
+               z = stbi__zhuffman_decode(a, &a->z_distance);
+               if (z < 0 || z >= 30) return stbi__err("bad huffman code","Corrupt PNG");
+               dist = stbi__zdist_base[z];
+               if (stbi__zdist_extra[z]) dist += stbi__zreceive(a, stbi__zdist_extra[z]);
+               if (wpos < dist) return stbi__err("bad dist","Corrupt PNG");
+               p = win + wpos - dist;
+               q = win + wpos;
+               wpos += len;
+               if (dist == 1) {
+                  memset(q, *p, len);
+               } else {
+                  do *q++ = *p++; while (--len);
+               }
+            }
+         }
+      }
+   }
+   zs->wpos = wpos;
+   return 1;
+}
+
+// copy the next n bytes of inflated output into dst
+static int stbi__zstream_read(stbi__zstream *zs, stbi_uc *dst, int n)
+{
+   while (n > 0) {
+      int avail = zs->wpos - zs->rpos;
+      if (avail == 0) {
+         if (zs->done) return stbi__err("not enough pixels","Corrupt PNG");
+         if (!stbi__zstream_fill(zs)) return 0;
+         continue;
+      }
+      if (avail > n) avail = n;
+      memcpy(dst, zs->window + zs->rpos, avail);
+      zs->rpos += avail;
+      dst += avail;
+      n -= avail;
+   }
+   return 1;
+}
+
 STBIDEF char *stbi_zlib_decode_malloc_guesssize(const char *buffer, int len, int initial_size, int *outlen)
 {
    stbi__zbuf a;
@@ -4693,6 +4998,44 @@ static void stbi__create_png_alpha_expand8(stbi_uc *dest, stbi_uc *src, stbi__ui
 }
 
 // create the png data from post-deflated data
+// undo one scanline's filter; nk bytes of raw are reconstructed into cur
+// using the previous reconstructed line in prior
+static void stbi__unfilter_png_row(stbi_uc *cur, stbi_uc const *prior, stbi_uc const *raw, int filter, int nk, int filter_bytes)
+{
+   int k;
+   switch (filter) {
+   case STBI__F_none:
+      memcpy(cur, raw, nk);
+      break;
+   case STBI__F_sub:
+      memcpy(cur, raw, filter_bytes);
+      for (k = filter_bytes; k < nk; ++k)
+         cur[k] = STBI__BYTECAST(raw[k] + cur[k-filter_bytes]);
+      break;
+   case STBI__F_up:
+      for (k = 0; k < nk; ++k)
+         cur[k] = STBI__BYTECAST(raw[k] + prior[k]);
+      break;
+   case STBI__F_avg:
+      for (k = 0; k < filter_bytes; ++k)
+         cur[k] = STBI__BYTECAST(raw[k] + (prior[k]>>1));
+      for (k = filter_bytes; k < nk; ++k)
+         cur[k] = STBI__BYTECAST(raw[k] + ((prior[k] + cur[k-filter_bytes])>>1));
+      break;
+   case STBI__F_paeth:
+      for (k = 0; k < filter_bytes; ++k)
+         cur[k] = STBI__BYTECAST(raw[k] + prior[k]); // prior[k] == stbi__paeth(0,prior[k],0)
+      for (k = filter_bytes; k < nk; ++k)
+         cur[k] = STBI__BYTECAST(raw[k] + stbi__paeth(cur[k-filter_bytes], prior[k], prior[k-filter_bytes]));
+      break;
+   case STBI__F_avg_first:
+      memcpy(cur, raw, filter_bytes);
+      for (k = filter_bytes; k < nk; ++k)
+         cur[k] = STBI__BYTECAST(raw[k] + (cur[k-filter_bytes] >> 1));
+      break;
+   }
+}
+
 static int stbi__create_png_image_raw(stbi__png *a, stbi_uc *raw, stbi__uint32 raw_len, int out_n, stbi__uint32 x, stbi__uint32 y, int depth, int color)
 {
    int bytes = (depth == 16 ? 2 : 1);
@@ -4701,7 +5044,6 @@ static int stbi__create_png_image_raw(stbi__png *a, stbi_uc *raw, stbi__uint32 r
    stbi__uint32 img_len, img_width_bytes;
    stbi_uc *filter_buf;
    int all_ok = 1;
-   int k;
    int img_n = s->img_n; // copy it into a local for later
 
    int output_bytes = out_n*bytes;
@@ -4752,37 +5094,7 @@ static int stbi__create_png_image_raw(stbi__png *a, stbi_uc *raw, stbi__uint32 r
       if (j == 0) filter = first_row_filter[filter];
 
       // perform actual filtering
-      switch (filter) {
-      case STBI__F_none:
-         memcpy(cur, raw, nk);
-         break;
-      case STBI__F_sub:
-         memcpy(cur, raw, filter_bytes);
-         for (k = filter_bytes; k < nk; ++k)
-            cur[k] = STBI__BYTECAST(raw[k] + cur[k-filter_bytes]);
-         break;
-      case STBI__F_up:
-         for (k = 0; k < nk; ++k)
-            cur[k] = STBI__BYTECAST(raw[k] + prior[k]);
-         break;
-      case STBI__F_avg:
-         for (k = 0; k < filter_bytes; ++k)
-            cur[k] = STBI__BYTECAST(raw[k] + (prior[k]>>1));
-         for (k = filter_bytes; k < nk; ++k)
-            cur[k] = STBI__BYTECAST(raw[k] + ((prior[k] + cur[k-filter_bytes])>>1));
-         break;
-      case STBI__F_paeth:
-         for (k = 0; k < filter_bytes; ++k)
-            cur[k] = STBI__BYTECAST(raw[k] + prior[k]); // prior[k] == stbi__paeth(0,prior[k],0)
-         for (k = filter_bytes; k < nk; ++k)
-            cur[k] = STBI__BYTECAST(raw[k] + stbi__paeth(cur[k-filter_bytes], prior[k], prior[k-filter_bytes]));
-         break;
-      case STBI__F_avg_first:
-         memcpy(cur, raw, filter_bytes);
-         for (k = filter_bytes; k < nk; ++k)
-            cur[k] = STBI__BYTECAST(raw[k] + (cur[k-filter_bytes] >> 1));
-         break;
-      }
+      stbi__unfilter_png_row(cur, prior, raw, filter, nk, filter_bytes);
 
       raw += nk;
 
@@ -4964,7 +5276,17 @@ static int stbi__expand_png_palette(stbi__png *a, stbi_uc *palette, int len, int
    // between here and free(out) below, exitting would leak
    temp_out = p;
 
-   if (pal_img_n == 3) {
+   if (pal_img_n == 1) {
+      for (i=0; i < pixel_count; ++i)
+         p[i] = palette[orig[i]*4];
+   } else if (pal_img_n == 2) {
+      for (i=0; i < pixel_count; ++i) {
+         int n = orig[i]*4;
+         p[0] = palette[n  ];
+         p[1] = palette[n+3];
+         p += 2;
+      }
+   } else if (pal_img_n == 3) {
       for (i=0; i < pixel_count; ++i) {
          int n = orig[i]*4;
          p[0] = palette[n  ];
@@ -5223,6 +5545,18 @@ static int stbi__parse_png_file(stbi__png *z, int scan, int req_comp)
                stbi__de_iphone(z);
             if (pal_img_n) {
                // pal_img_n == 3 or 4
+               if (req_comp == 0) {
+                  // pick the expanded channel count from the palette
+                  // itself, so a fully opaque tRNS expands to RGB and a gray
+                  // palette to gray instead of being narrowed after the fact
+                  int gray = 1, opaque = 1;
+                  for (i=0; i < pal_len; ++i) {
+                     stbi_uc *e = palette + i*4;
+                     if (e[0] != e[1] || e[0] != e[2]) gray = 0;
+                     if (e[3] != 255) opaque = 0;
+                  }
+                  pal_img_n = (gray ? 1 : 3) + (opaque ? 0 : 1);
+               }
                s->img_n = pal_img_n; // record the actual colors we had
                s->img_out_n = pal_img_n;
                if (req_comp >= 3) s->img_out_n = req_comp;
@@ -5338,6 +5672,191 @@ static int stbi__png_is16(stbi__context *s)
    }
    return 1;
 }
+
+struct stbi_png_stream
+{
+   stbi__zstream zs;
+   stbi_uc *idata;        // IDAT payloads joined, when split over several chunks
+   stbi_uc *filter_buf;   // current and prior reconstructed scanlines
+   stbi_uc *raw;          // one filtered scanline (filter type byte first)
+   stbi_uc palette[1024];
+   int x, y, img_n, out_n, depth, color;
+   int row_bytes;
+   int row;
+};
+
+STBIDEF void stbi_png_stream_close(stbi_png_stream *ps)
+{
+   if (ps == NULL) return;
+   STBI_FREE(ps->zs.window);
+   STBI_FREE(ps->idata);
+   STBI_FREE(ps->filter_buf);
+   STBI_FREE(ps->raw);
+   STBI_FREE(ps);
+}
+
+STBIDEF stbi_png_stream *stbi_png_stream_open(stbi_uc const *buffer, int len, int *x, int *y, int *comp)
+{
+   stbi__context s;
+   stbi_png_stream *ps;
+   stbi_uc const *idat = NULL;
+   stbi__uint32 idat_len = 0, idat_cap = 0;
+   int pal_len = 0, first = 1, i;
+
+   stbi__start_mem(&s, buffer, len);
+   if (!stbi__check_png_header(&s)) return NULL;
+
+   ps = (stbi_png_stream *) stbi__malloc(sizeof(*ps));
+   if (ps == NULL) return (stbi_png_stream *) stbi__errpuc("outofmem", "Out of memory");
+   memset(ps, 0, sizeof(*ps));
+
+   for (;;) {
+      stbi__pngchunk c = stbi__get_chunk_header(&s);
+      if (first && c.type != STBI__PNG_TYPE('I','H','D','R')) goto fail;
+      if ((stbi__uint32) (s.img_buffer_end - s.img_buffer) < c.length) goto fail;
+      switch (c.type) {
+         case STBI__PNG_TYPE('I','H','D','R'): {
+            int comp_method, filter, interlace;
+            if (!first || c.length != 13) goto fail;
+            first = 0;
+            ps->x = stbi__get32be(&s);
+            ps->y = stbi__get32be(&s);
+            ps->depth = stbi__get8(&s);
+            ps->color = stbi__get8(&s);
+            comp_method = stbi__get8(&s);
+            filter = stbi__get8(&s);
+            interlace = stbi__get8(&s);
+            if (ps->x <= 0 || ps->y <= 0 || ps->x > STBI_MAX_DIMENSIONS || ps->y > STBI_MAX_DIMENSIONS) goto fail;
+            if (comp_method || filter) goto fail;
+            // rows of interlaced and sub-byte images are left to stbi__png_load
+            if (interlace) goto fail;
+            if (ps->color == 3 ? ps->depth != 8 : (ps->depth != 8 && ps->depth != 16)) goto fail;
+            if (ps->color > 6 || ps->color == 1 || ps->color == 5) goto fail;
+            ps->img_n = (ps->color == 3) ? 1 : ((ps->color & 2) ? 3 : 1) + (ps->color & 4 ? 1 : 0);
+            break;
+         }
+
+         case STBI__PNG_TYPE('P','L','T','E'): {
+            if (c.length > 256*3 || c.length % 3) goto fail;
+            pal_len = c.length / 3;
+            for (i=0; i < pal_len; ++i) {
+               ps->palette[i*4+0] = stbi__get8(&s);
+               ps->palette[i*4+1] = stbi__get8(&s);
+               ps->palette[i*4+2] = stbi__get8(&s);
+               ps->palette[i*4+3] = 255;
+            }
+            break;
+         }
+
+         case STBI__PNG_TYPE('t','R','N','S'): {
+            // a constant-alpha color key on gray/RGB is left to stbi__png_load
+            if (ps->color != 3 || idat || pal_len == 0 || c.length > (stbi__uint32) pal_len) goto fail;
+            for (i=0; i < (int) c.length; ++i)
+               ps->palette[i*4+3] = stbi__get8(&s);
+            break;
+         }
+
+         case STBI__PNG_TYPE('I','D','A','T'): {
+            if (ps->color == 3 && pal_len == 0) goto fail;
+            if (idat == NULL) {
+               // a single IDAT is inflated straight from the input
+               idat = s.img_buffer;
+               idat_len = c.length;
+            } else {
+               if (ps->idata == NULL) {
+                  idat_cap = (idat_len + c.length) * 2;
+                  ps->idata = (stbi_uc *) stbi__malloc(idat_cap);
+                  if (ps->idata == NULL) goto fail;
+                  memcpy(ps->idata, idat, idat_len);
+               } else if (idat_len + c.length > idat_cap) {
+                  stbi_uc *p;
+                  while (idat_len + c.length > idat_cap) idat_cap *= 2;
+                  p = (stbi_uc *) STBI_REALLOC_SIZED(ps->idata, idat_len, idat_cap);
+                  if (p == NULL) goto fail;
+                  ps->idata = p;
+               }
+               memcpy(ps->idata + idat_len, s.img_buffer, c.length);
+               idat = ps->idata;
+               idat_len += c.length;
+            }
+            stbi__skip(&s, c.length);
+            break;
+         }
+
+         case STBI__PNG_TYPE('I','E','N','D'): {
+            int filter_bytes;
+            if (idat == NULL) goto fail;
+            if (ps->color == 3) {
+               // same channel choice as stbi__parse_png_file with req_comp 0
+               int gray = 1, opaque = 1;
+               for (i=0; i < pal_len; ++i) {
+                  stbi_uc *e = ps->palette + i*4;
+                  if (e[0] != e[1] || e[0] != e[2]) gray = 0;
+                  if (e[3] != 255) opaque = 0;
+               }
+               ps->out_n = (gray ? 1 : 3) + (opaque ? 0 : 1);
+            } else {
+               ps->out_n = ps->img_n;
+            }
+            filter_bytes = ps->img_n * (ps->depth / 8);
+            ps->row_bytes = ps->x * filter_bytes;
+            ps->filter_buf = (stbi_uc *) stbi__malloc_mad2(ps->row_bytes, 2, 0);
+            ps->raw = (stbi_uc *) stbi__malloc(ps->row_bytes + 1);
+            if (ps->filter_buf == NULL || ps->raw == NULL) goto fail;
+            if (!stbi__zstream_init(&ps->zs, idat, (int) idat_len)) goto fail;
+            *x = ps->x;
+            *y = ps->y;
+            *comp = ps->out_n;
+            return ps;
+         }
+
+         default:
+            // unknown critical chunks are left to stbi__png_load to reject
+            if ((c.type & (1 << 29)) == 0) goto fail;
+            stbi__skip(&s, c.length);
+            break;
+      }
+      stbi__get32be(&s); // CRC
+   }
+
+fail:
+   stbi_png_stream_close(ps);
+   return NULL;
+}
+
+STBIDEF int stbi_png_stream_read_row(stbi_png_stream *ps, stbi_uc *row)
+{
+   int filter_bytes = ps->img_n * (ps->depth / 8);
+   stbi_uc *cur = ps->filter_buf + (ps->row & 1) * ps->row_bytes;
+   stbi_uc *prior = ps->filter_buf + (~ps->row & 1) * ps->row_bytes;
+   int filter, i;
+
+   if (ps->row >= ps->y) return stbi__err("no more rows", "Internal error");
+   if (!stbi__zstream_read(&ps->zs, ps->raw, ps->row_bytes + 1)) return 0;
+
+   filter = ps->raw[0];
+   if (filter > 4) return stbi__err("invalid filter","Corrupt PNG");
+   if (ps->row == 0) filter = first_row_filter[filter];
+   stbi__unfilter_png_row(cur, prior, ps->raw + 1, filter, ps->row_bytes, filter_bytes);
+   ps->row++;
+
+   if (ps->color == 3) {
+      stbi_uc *pal = ps->palette;
+      switch (ps->out_n) {
+         case 1: for (i=0; i < ps->x; ++i) row[i] = pal[cur[i]*4]; break;
+         case 2: for (i=0; i < ps->x; ++i, row += 2) { stbi_uc *e = pal + cur[i]*4; row[0] = e[0]; row[1] = e[3]; } break;
+         case 3: for (i=0; i < ps->x; ++i, row += 3) memcpy(row, pal + cur[i]*4, 3); break;
+         default: for (i=0; i < ps->x; ++i, row += 4) memcpy(row, pal + cur[i]*4, 4); break;
+      }
+   } else if (ps->depth == 16) {
+      int nsmp = ps->x * ps->img_n;
+      for (i=0; i < nsmp; ++i)
+         row[i] = cur[i*2]; // top half of each sample, as stbi__convert_16_to_8
+   } else {
+      memcpy(row, cur, ps->row_bytes);
+   }
+   return 1;
+}
 #endif
 
 // Microsoft/Windows BMP image
@@ -107,7 +107,8 @@ USAGE:
    data, set the global variable 'stbi_write_tga_with_rle' to 0.
 
    JPEG does ignore alpha channels in input data; quality is between 1 and 100.
-   Higher quality looks better but results in a bigger image.
+   Higher quality looks better but results in a bigger image. Y and YA input
+   is written as a single-component (grayscale) JPEG.
    JPEG baseline (no JPEG progressive).
 
 CREDITS:
@@ -194,6 +195,13 @@ STBIWDEF int stbi_write_jpg_to_func(stbi_write_func *func, void *context, int x,
 
 STBIWDEF void stbi_flip_vertically_on_write(int flip_boolean);
 
+// Per-call encoder settings (reentrant: no global state is read or written)
+// compression_level: zlib level as in stbi_write_png_compression_level
+// force_filter: -1 = adaptive per line, 0..4 = force that PNG filter
+// subsample: -1 = auto (4:2:0 when quality <= 90), 0 = 4:4:4, 1 = 4:2:0
+STBIWDEF int stbi_write_png_to_func_ex(stbi_write_func *func, void *context, int w, int h, int comp, const void  *data, int stride_in_bytes, int compression_level, int force_filter);
+STBIWDEF int stbi_write_jpg_to_func_ex(stbi_write_func *func, void *context, int x, int y, int comp, const void  *data, int quality, int subsample);
+
 #endif//INCLUDE_STB_IMAGE_WRITE_H
 
 #ifdef STB_IMAGE_WRITE_IMPLEMENTATION
@@ -1125,9 +1133,8 @@ static void stbiw__encode_png_line(unsigned char *pixels, int stride_bytes, int
    }
 }
 
-STBIWDEF unsigned char *stbi_write_png_to_mem(const unsigned char *pixels, int stride_bytes, int x, int y, int n, int *out_len)
+static unsigned char *stbi_write_png_to_mem_ex(const unsigned char *pixels, int stride_bytes, int x, int y, int n, int *out_len, int compression_level, int force_filter)
 {
-   int force_filter = stbi_write_force_png_filter;
    int ctype[5] = { -1, 0, 4, 2, 6 };
    unsigned char sig[8] = { 137,80,78,71,13,10,26,10 };
    unsigned char *out,*o, *filt, *zlib;
@@ -1173,7 +1180,7 @@ STBIWDEF unsigned char *stbi_write_png_to_mem(const unsigned char *pixels, int s
       STBIW_MEMMOVE(filt+j*(x*n+1)+1, line_buffer, x*n);
    }
    STBIW_FREE(line_buffer);
-   zlib = stbi_zlib_compress(filt, y*( x*n+1), &zlen, stbi_write_png_compression_level);
+   zlib = stbi_zlib_compress(filt, y*( x*n+1), &zlen, compression_level);
    STBIW_FREE(filt);
    if (!zlib) return 0;
 
@@ -1211,6 +1218,11 @@ STBIWDEF unsigned char *stbi_write_png_to_mem(const unsigned char *pixels, int s
    return out;
 }
 
+STBIWDEF unsigned char *stbi_write_png_to_mem(const unsigned char *pixels, int stride_bytes, int x, int y, int n, int *out_len)
+{
+   return stbi_write_png_to_mem_ex(pixels, stride_bytes, x, y, n, out_len, stbi_write_png_compression_level, stbi_write_force_png_filter);
+}
+
 #ifndef STBI_WRITE_NO_STDIO
 STBIWDEF int stbi_write_png(char const *filename, int x, int y, int comp, const void *data, int stride_bytes)
 {
@@ -1238,6 +1250,16 @@ STBIWDEF int stbi_write_png_to_func(stbi_write_func *func, void *context, int x,
    return 1;
 }
 
+STBIWDEF int stbi_write_png_to_func_ex(stbi_write_func *func, void *context, int x, int y, int comp, const void *data, int stride_bytes, int compression_level, int force_filter)
+{
+   int len;
+   unsigned char *png = stbi_write_png_to_mem_ex((const unsigned char *) data, stride_bytes, x, y, comp, &len, compression_level, force_filter);
+   if (png == NULL) return 0;
+   func(context, png, len);
+   STBIW_FREE(png);
+   return 1;
+}
+
 
 /* ***************************************************************************
  *
@@ -1395,7 +1417,7 @@ static int stbiw__jpg_processDU(stbi__write_context *s, int *bitBuf, int *bitCnt
    return DU[0];
 }
 
-static int stbi_write_jpg_core(stbi__write_context *s, int width, int height, int comp, const void* data, int quality) {
+static int stbi_write_jpg_core(stbi__write_context *s, int width, int height, int comp, const void* data, int quality, int subsample_mode) {
    // Constants that don't pollute global namespace
    static const unsigned char std_dc_luminance_nrcodes[] = {0,0,1,5,1,1,1,1,1,1,0,0,0,0,0,0,0};
    static const unsigned char std_dc_luminance_values[] = {0,1,2,3,4,5,6,7,8,9,10,11};
@@ -1476,7 +1498,7 @@ static int stbi_write_jpg_core(stbi__write_context *s, int width, int height, in
    }
 
    quality = quality ? quality : 90;
-   subsample = quality <= 90 ? 1 : 0;
+   subsample = subsample_mode >= 0 ? (subsample_mode != 0) : (quality <= 90 ? 1 : 0);
    quality = quality < 1 ? 1 : quality > 100 ? 100 : quality;
    quality = quality < 50 ? 5000 / quality : 200 - quality * 2;
 
@@ -1495,7 +1517,22 @@ static int stbi_write_jpg_core(stbi__write_context *s, int width, int height, in
    }
 
    // Write Headers
-   {
+   if(comp <= 2) {
+      // Grayscale: one component, luminance quantization and Huffman tables only
+      static const unsigned char head0[] = { 0xFF,0xD8,0xFF,0xE0,0,0x10,'J','F','I','F',0,1,1,0,0,1,0,1,0,0,0xFF,0xDB,0,0x43,0 };
+      static const unsigned char head2[] = { 0xFF,0xDA,0,0x8,1,1,0,0,0x3F,0 };
+      const unsigned char head1[] = { 0xFF,0xC0,0,0xB,8,(unsigned char)(height>>8),STBIW_UCHAR(height),(unsigned char)(width>>8),STBIW_UCHAR(width),
+                                      1,1,0x11,0,0xFF,0xC4,0,0xD2,0 };
+      s->func(s->context, (void*)head0, sizeof(head0));
+      s->func(s->context, (void*)YTable, sizeof(YTable));
+      s->func(s->context, (void*)head1, sizeof(head1));
+      s->func(s->context, (void*)(std_dc_luminance_nrcodes+1), sizeof(std_dc_luminance_nrcodes)-1);
+      s->func(s->context, (void*)std_dc_luminance_values, sizeof(std_dc_luminance_values));
+      stbiw__putc(s, 0x10); // HTYACinfo
+      s->func(s->context, (void*)(std_ac_luminance_nrcodes+1), sizeof(std_ac_luminance_nrcodes)-1);
+      s->func(s->context, (void*)std_ac_luminance_values, sizeof(std_ac_luminance_values));
+      s->func(s->context, (void*)head2, sizeof(head2));
+   } else {
       static const unsigned char head0[] = { 0xFF,0xD8,0xFF,0xE0,0,0x10,'J','F','I','F',0,1,1,0,0,1,0,1,0,0,0xFF,0xDB,0,0x84,0 };
       static const unsigned char head2[] = { 0xFF,0xDA,0,0xC,3,1,0,2,0x11,3,0x11,0,0x3F,0 };
       const unsigned char head1[] = { 0xFF,0xC0,0,0x11,8,(unsigned char)(height>>8),STBIW_UCHAR(height),(unsigned char)(width>>8),STBIW_UCHAR(width),
@@ -1530,7 +1567,25 @@ static int stbi_write_jpg_core(stbi__write_context *s, int width, int height, in
       const unsigned char *dataG = dataR + ofsG;
       const unsigned char *dataB = dataR + ofsB;
       int x, y, pos;
-      if(subsample) {
+      if(comp <= 2) {
+         for(y = 0; y < height; y += 8) {
+            for(x = 0; x < width; x += 8) {
+               float Y[64];
+               for(row = y, pos = 0; row < y+8; ++row) {
+                  // row >= height => use last input row
+                  int clamped_row = (row < height) ? row : height - 1;
+                  int base_p = (stbi__flip_vertically_on_write ? (height-1-clamped_row) : clamped_row)*width*comp;
+                  for(col = x; col < x+8; ++col, ++pos) {
+                     // if col >= width => use pixel from last input column
+                     int p = base_p + ((col < width) ? col : (width-1))*comp;
+                     Y[pos] = dataR[p] - 128.0f;
+                  }
+               }
+
+               DCY = stbiw__jpg_processDU(s, &bitBuf, &bitCnt, Y, 8, fdtbl_Y, DCY, YDC_HT, YAC_HT);
+            }
+         }
+      } else if(subsample) {
          for(y = 0; y < height; y += 16) {
             for(x = 0; x < width; x += 16) {
                float Y[256], U[256], V[256];
@@ -1608,7 +1663,14 @@ STBIWDEF int stbi_write_jpg_to_func(stbi_write_func *func, void *context, int x,
 {
    stbi__write_context s = { 0 };
    stbi__start_write_callbacks(&s, func, context);
-   return stbi_write_jpg_core(&s, x, y, comp, (void *) data, quality);
+   return stbi_write_jpg_core(&s, x, y, comp, (void *) data, quality, -1);
+}
+
+STBIWDEF int stbi_write_jpg_to_func_ex(stbi_write_func *func, void *context, int x, int y, int comp, const void *data, int quality, int subsample)
+{
+   stbi__write_context s = { 0 };
+   stbi__start_write_callbacks(&s, func, context);
+   return stbi_write_jpg_core(&s, x, y, comp, (void *) data, quality, subsample);
 }
 
 
@@ -1617,7 +1679,7 @@ STBIWDEF int stbi_write_jpg(char const *filename, int x, int y, int comp, const
 {
    stbi__write_context s = { 0 };
    if (stbi__start_write_file(&s,filename)) {
-      int r = stbi_write_jpg_core(&s, x, y, comp, data, quality);
+      int r = stbi_write_jpg_core(&s, x, y, comp, data, quality, -1);
       stbi__end_write_file(&s);
       return r;
    } else
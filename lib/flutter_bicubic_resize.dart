@@ -43,4 +43,6 @@
 /// for detailed usage information.
 library flutter_bicubic_resize;
 
+export 'src/bicubic_decoded_image.dart';
+export 'src/bicubic_resize_plan.dart';
 export 'src/bicubic_resizer.dart';
@@ -0,0 +1,253 @@
+import 'dart:ffi';
+import 'dart:typed_data';
+
+import 'package:ffi/ffi.dart';
+
+import 'bicubic_resizer.dart';
+import 'native_bindings.dart';
+
+/// JPEG/PNG image decoded once and kept in native memory.
+///
+/// Decoding is usually the most expensive step of a resize. A decoded image
+/// keeps the full-resolution, EXIF-oriented pixels so that interactive
+/// crops (e.g. a crop slider or a zoom preview) and repeated exports only
+/// pay for the resample and encode.
+///
+/// A decoded image is read-only, so [resizePixels] and [encode] may be
+/// called repeatedly. Call [dispose] to release the native pixels.
+///
+/// ```dart
+/// final image = BicubicDecodedImage.decode(photoBytes);
+/// final preview = image.encode(
+///   outputWidth: 512,
+///   outputHeight: 512,
+///   crop: 0.8,
+/// );
+/// image.dispose();
+/// ```
+class BicubicDecodedImage {
+  /// Width of the decoded (oriented) image in pixels
+  final int width;
+
+  /// Height of the decoded (oriented) image in pixels
+  final int height;
+
+  /// Bytes per pixel (1 = gray, 2 = gray + alpha, 3 = RGB, 4 = RGBA)
+  final int channels;
+
+  /// Format of the source bytes
+  final ImageFormat format;
+
+  final Pointer<BicubicImageHandle> _image;
+  bool _disposed = false;
+
+  BicubicDecodedImage._(
+    this._image, {
+    required this.width,
+    required this.height,
+    required this.channels,
+    required this.format,
+  });
+
+  /// Decode JPEG or PNG bytes
+  ///
+  /// JPEGs decode to RGB (gray when grayscale); PNGs keep their own
+  /// channel count (gray, gray + alpha, RGB or RGBA), except that an alpha
+  /// channel that is 255 everywhere is dropped. Indexed PNGs expand to the
+  /// narrowest of these that holds their palette.
+  ///
+  /// Throws [UnsupportedImageFormatException] if the format is not supported.
+  ///
+  /// [bytes] - Image data (JPEG or PNG)
+  /// [applyExifOrientation] - Whether to apply EXIF orientation for JPEG (default: true)
+  factory BicubicDecodedImage.decode(
+    Uint8List bytes, {
+    bool applyExifOrientation = true,
+  }) {
+    final format = BicubicResizer.detectFormat(bytes);
+    if (format == null) {
+      throw UnsupportedImageFormatException(bytes: bytes);
+    }
+
+    final inputPtr = malloc<Uint8>(bytes.length);
+    final infoPtr = calloc<Int32>(3);
+
+    try {
+      inputPtr.asTypedList(bytes.length).setAll(0, bytes);
+
+      final image = NativeBindings.instance.bicubicImageCreate(
+        inputPtr,
+        bytes.length,
+        applyExifOrientation ? 1 : 0,
+      );
+
+      if (image == nullptr) {
+        throw Exception('Native image decode failed');
+      }
+
+      NativeBindings.instance.bicubicImageInfo(
+        image,
+        infoPtr,
+        infoPtr + 1,
+        infoPtr + 2,
+      );
+
+      return BicubicDecodedImage._(
+        image,
+        width: infoPtr[0],
+        height: infoPtr[1],
+        channels: infoPtr[2],
+        format: format,
+      );
+    } finally {
+      malloc.free(inputPtr);
+      calloc.free(infoPtr);
+    }
+  }
+
+  /// Crop and resize into raw pixels
+  ///
+  /// Parameters have the same meaning as in [BicubicResizer.resizeRgb].
+  ///
+  /// Returns pixel data of `outputWidth * outputHeight * channels` bytes
+  Uint8List resizePixels({
+    required int outputWidth,
+    required int outputHeight,
+    BicubicFilter filter = BicubicFilter.catmullRom,
+    BicubicFilter? verticalFilter,
+    EdgeMode edgeMode = EdgeMode.clamp,
+    EdgeMode? verticalEdgeMode,
+    ResizeColorSpace colorSpace = ResizeColorSpace.gamma,
+    double reducingGap = 0.0,
+    double crop = 1.0,
+    CropAnchor cropAnchor = CropAnchor.center,
+    CropAspectRatio cropAspectRatio = CropAspectRatio.square,
+    double aspectRatioWidth = 1.0,
+    double aspectRatioHeight = 1.0,
+    int numThreads = 0,
+  }) {
+    _checkNotDisposed();
+
+    final outputSize = outputWidth * outputHeight * channels;
+    final outputPtr = malloc<Uint8>(outputSize);
+    var adopted = false;
+
+    try {
+      final result = NativeBindings.instance.bicubicImageResize(
+        _image,
+        outputPtr,
+        outputWidth,
+        outputHeight,
+        packAxes(filter.value, verticalFilter?.value),
+        packAxes(edgeMode.value, verticalEdgeMode?.value),
+        colorSpace.value,
+        reducingGap,
+        crop,
+        cropAnchor.value,
+        cropAspectRatio.value,
+        aspectRatioWidth,
+        aspectRatioHeight,
+        numThreads,
+      );
+
+      if (result != 0) {
+        throw Exception('Native bicubic resize failed with code: $result');
+      }
+
+      adopted = true;
+      return outputPtr.asTypedList(
+        outputSize,
+        finalizer: NativeBindings.instance.freeBufferPointer,
+      );
+    } finally {
+      if (!adopted) malloc.free(outputPtr);
+    }
+  }
+
+  /// Crop, resize and encode as JPEG or PNG
+  ///
+  /// [outputFormat] defaults to the format of the source bytes. Alpha is
+  /// dropped when an image with alpha is encoded as JPEG. Other parameters
+  /// have the same meaning as in [BicubicResizer.resizeJpeg] and
+  /// [BicubicResizer.resizePng].
+  ///
+  /// Returns the encoded image
+  Uint8List encode({
+    required int outputWidth,
+    required int outputHeight,
+    ImageFormat? outputFormat,
+    int quality = 95,
+    JpegChromaSubsampling chromaSubsampling = JpegChromaSubsampling.auto,
+    int compressionLevel = 6,
+    PngFilter pngFilter = PngFilter.adaptive,
+    BicubicFilter filter = BicubicFilter.catmullRom,
+    BicubicFilter? verticalFilter,
+    EdgeMode edgeMode = EdgeMode.clamp,
+    EdgeMode? verticalEdgeMode,
+    ResizeColorSpace colorSpace = ResizeColorSpace.gamma,
+    double reducingGap = 0.0,
+    double crop = 1.0,
+    CropAnchor cropAnchor = CropAnchor.center,
+    CropAspectRatio cropAspectRatio = CropAspectRatio.square,
+    double aspectRatioWidth = 1.0,
+    double aspectRatioHeight = 1.0,
+    int numThreads = 0,
+  }) {
+    _checkNotDisposed();
+
+    final outputDataPtr = calloc<Pointer<Uint8>>();
+    final outputSizePtr = calloc<Int32>();
+
+    try {
+      final result = NativeBindings.instance.bicubicImageEncode(
+        _image,
+        outputWidth,
+        outputHeight,
+        (outputFormat ?? format) == ImageFormat.png ? 1 : 0,
+        quality,
+        chromaSubsampling.value,
+        compressionLevel,
+        pngFilter.value,
+        packAxes(filter.value, verticalFilter?.value),
+        packAxes(edgeMode.value, verticalEdgeMode?.value),
+        colorSpace.value,
+        reducingGap,
+        crop,
+        cropAnchor.value,
+        cropAspectRatio.value,
+        aspectRatioWidth,
+        aspectRatioHeight,
+        numThreads,
+        outputDataPtr,
+        outputSizePtr,
+      );
+
+      if (result != 0) {
+        throw Exception('Native image encode failed with code: $result');
+      }
+
+      // Hand the native buffer to Dart; free_buffer runs when it is collected
+      return outputDataPtr.value.asTypedList(
+        outputSizePtr.value,
+        finalizer: NativeBindings.instance.freeBufferPointer,
+      );
+    } finally {
+      calloc.free(outputDataPtr);
+      calloc.free(outputSizePtr);
+    }
+  }
+
+  /// Release the native pixels
+  void dispose() {
+    if (_disposed) return;
+    _disposed = true;
+
+    NativeBindings.instance.bicubicImageDestroy(_image);
+  }
+
+  void _checkNotDisposed() {
+    if (_disposed) {
+      throw StateError('BicubicDecodedImage has been disposed');
+    }
+  }
+}
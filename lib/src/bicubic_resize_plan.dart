@@ -0,0 +1,247 @@
+import 'dart:ffi';
+import 'dart:typed_data';
+
+import 'package:ffi/ffi.dart';
+
+import 'bicubic_resizer.dart';
+import 'native_bindings.dart';
+
+/// Reusable resize plan for many resizes with the same geometry.
+///
+/// Creating a plan computes the bicubic filter coefficients for one
+/// input size, output size, crop and filter combination. Every call to
+/// [execute] then only resamples pixels, which makes a plan the fastest way
+/// to resize a stream of camera frames (e.g. to 224x224 ML inputs).
+///
+/// Native input and output buffers are allocated once per plan and reused.
+/// Call [dispose] when the plan is no longer needed.
+///
+/// ```dart
+/// final plan = BicubicResizePlan.rgb(
+///   inputWidth: 1920,
+///   inputHeight: 1080,
+///   outputWidth: 224,
+///   outputHeight: 224,
+/// );
+/// for (final frame in frames) {
+///   final resized = plan.execute(frame);
+/// }
+/// plan.dispose();
+/// ```
+class BicubicResizePlan {
+  /// Width of input frames in pixels
+  final int inputWidth;
+
+  /// Height of input frames in pixels
+  final int inputHeight;
+
+  /// Width of output frames in pixels
+  final int outputWidth;
+
+  /// Height of output frames in pixels
+  final int outputHeight;
+
+  /// Bytes per pixel (3 = RGB, 4 = RGBA)
+  final int channels;
+
+  final Pointer<BicubicPlanHandle> _plan;
+  final Pointer<Uint8> _inputPtr;
+  final Pointer<Uint8> _outputPtr;
+  bool _disposed = false;
+
+  BicubicResizePlan._(
+    this._plan,
+    this._inputPtr,
+    this._outputPtr, {
+    required this.inputWidth,
+    required this.inputHeight,
+    required this.outputWidth,
+    required this.outputHeight,
+    required this.channels,
+  });
+
+  /// Create a plan for raw RGB frames (3 bytes per pixel)
+  ///
+  /// Parameters have the same meaning as in [BicubicResizer.resizeRgb].
+  factory BicubicResizePlan.rgb({
+    required int inputWidth,
+    required int inputHeight,
+    required int outputWidth,
+    required int outputHeight,
+    BicubicFilter filter = BicubicFilter.catmullRom,
+    BicubicFilter? verticalFilter,
+    EdgeMode edgeMode = EdgeMode.clamp,
+    EdgeMode? verticalEdgeMode,
+    ResizeColorSpace colorSpace = ResizeColorSpace.gamma,
+    double reducingGap = 0.0,
+    double crop = 1.0,
+    CropAnchor cropAnchor = CropAnchor.center,
+    CropAspectRatio cropAspectRatio = CropAspectRatio.square,
+    double aspectRatioWidth = 1.0,
+    double aspectRatioHeight = 1.0,
+    int numThreads = 0,
+  }) {
+    return BicubicResizePlan._create(
+      channels: 3,
+      inputWidth: inputWidth,
+      inputHeight: inputHeight,
+      outputWidth: outputWidth,
+      outputHeight: outputHeight,
+      filter: filter,
+      verticalFilter: verticalFilter,
+      edgeMode: edgeMode,
+      verticalEdgeMode: verticalEdgeMode,
+      colorSpace: colorSpace,
+      alphaMode: AlphaMode.straight,
+      reducingGap: reducingGap,
+      crop: crop,
+      cropAnchor: cropAnchor,
+      cropAspectRatio: cropAspectRatio,
+      aspectRatioWidth: aspectRatioWidth,
+      aspectRatioHeight: aspectRatioHeight,
+      numThreads: numThreads,
+    );
+  }
+
+  /// Create a plan for raw RGBA frames (4 bytes per pixel)
+  ///
+  /// Parameters have the same meaning as in [BicubicResizer.resizeRgba].
+  factory BicubicResizePlan.rgba({
+    required int inputWidth,
+    required int inputHeight,
+    required int outputWidth,
+    required int outputHeight,
+    BicubicFilter filter = BicubicFilter.catmullRom,
+    BicubicFilter? verticalFilter,
+    EdgeMode edgeMode = EdgeMode.clamp,
+    EdgeMode? verticalEdgeMode,
+    ResizeColorSpace colorSpace = ResizeColorSpace.gamma,
+    AlphaMode alphaMode = AlphaMode.straight,
+    double reducingGap = 0.0,
+    double crop = 1.0,
+    CropAnchor cropAnchor = CropAnchor.center,
+    CropAspectRatio cropAspectRatio = CropAspectRatio.square,
+    double aspectRatioWidth = 1.0,
+    double aspectRatioHeight = 1.0,
+    int numThreads = 0,
+  }) {
+    return BicubicResizePlan._create(
+      channels: 4,
+      inputWidth: inputWidth,
+      inputHeight: inputHeight,
+      outputWidth: outputWidth,
+      outputHeight: outputHeight,
+      filter: filter,
+      verticalFilter: verticalFilter,
+      edgeMode: edgeMode,
+      verticalEdgeMode: verticalEdgeMode,
+      colorSpace: colorSpace,
+      alphaMode: alphaMode,
+      reducingGap: reducingGap,
+      crop: crop,
+      cropAnchor: cropAnchor,
+      cropAspectRatio: cropAspectRatio,
+      aspectRatioWidth: aspectRatioWidth,
+      aspectRatioHeight: aspectRatioHeight,
+      numThreads: numThreads,
+    );
+  }
+
+  factory BicubicResizePlan._create({
+    required int channels,
+    required int inputWidth,
+    required int inputHeight,
+    required int outputWidth,
+    required int outputHeight,
+    required BicubicFilter filter,
+    required BicubicFilter? verticalFilter,
+    required EdgeMode edgeMode,
+    required EdgeMode? verticalEdgeMode,
+    required ResizeColorSpace colorSpace,
+    required AlphaMode alphaMode,
+    required double reducingGap,
+    required double crop,
+    required CropAnchor cropAnchor,
+    required CropAspectRatio cropAspectRatio,
+    required double aspectRatioWidth,
+    required double aspectRatioHeight,
+    required int numThreads,
+  }) {
+    final plan = NativeBindings.instance.bicubicPlanCreate(
+      inputWidth,
+      inputHeight,
+      channels,
+      outputWidth,
+      outputHeight,
+      packAxes(filter.value, verticalFilter?.value),
+      packAxes(edgeMode.value, verticalEdgeMode?.value),
+      colorSpace.value,
+      alphaMode.value,
+      reducingGap,
+      crop,
+      cropAnchor.value,
+      cropAspectRatio.value,
+      aspectRatioWidth,
+      aspectRatioHeight,
+      numThreads,
+    );
+
+    if (plan == nullptr) {
+      throw Exception('Native resize plan creation failed');
+    }
+
+    return BicubicResizePlan._(
+      plan,
+      malloc<Uint8>(inputWidth * inputHeight * channels),
+      malloc<Uint8>(outputWidth * outputHeight * channels),
+      inputWidth: inputWidth,
+      inputHeight: inputHeight,
+      outputWidth: outputWidth,
+      outputHeight: outputHeight,
+      channels: channels,
+    );
+  }
+
+  /// Resize one frame with this plan
+  ///
+  /// [input] - Raw pixel data of `inputWidth * inputHeight * channels` bytes
+  ///
+  /// Returns resized pixel data of `outputWidth * outputHeight * channels` bytes
+  Uint8List execute(Uint8List input) {
+    if (_disposed) {
+      throw StateError('BicubicResizePlan has been disposed');
+    }
+
+    final expectedInputSize = inputWidth * inputHeight * channels;
+    if (input.length != expectedInputSize) {
+      throw ArgumentError(
+        'Input size mismatch: expected $expectedInputSize bytes, got ${input.length}',
+      );
+    }
+
+    _inputPtr.asTypedList(input.length).setAll(0, input);
+
+    final result = NativeBindings.instance.bicubicPlanExecute(
+      _plan,
+      _inputPtr,
+      _outputPtr,
+    );
+
+    if (result != 0) {
+      throw Exception('Native bicubic resize failed with code: $result');
+    }
+
+    final outputSize = outputWidth * outputHeight * channels;
+    return Uint8List.fromList(_outputPtr.asTypedList(outputSize));
+  }
+
+  /// Release the native plan and its buffers
+  void dispose() {
+    if (_disposed) return;
+    _disposed = true;
+
+    NativeBindings.instance.bicubicPlanDestroy(_plan);
+    malloc.free(_inputPtr);
+    malloc.free(_outputPtr);
+  }
+}
@@ -1,4 +1,7 @@
+import 'dart:async';
 import 'dart:ffi';
+import 'dart:isolate';
+import 'dart:math' show max;
 import 'dart:typed_data';
 
 import 'package:ffi/ffi.dart';
@@ -44,7 +47,11 @@ enum BicubicFilter {
   cubicBSpline(1),
 
   /// Mitchell-Netravali (balanced between sharp and smooth)
-  mitchell(2);
+  mitchell(2),
+
+  /// Catmull-Rom, with a cheaper kernel on axes scaled by less than 1.25x
+  /// (triangle) or not scaled at all (straight copy)
+  auto(3);
 
   final int value;
   const BicubicFilter(this.value);
@@ -68,6 +75,76 @@ enum EdgeMode {
   const EdgeMode(this.value);
 }
 
+/// Color space the resampling filter operates in
+enum ResizeColorSpace {
+  /// Filter the stored sRGB values directly (default, fastest)
+  gamma(0),
+
+  /// Decode sRGB to linear light, filter, then re-encode. Avoids darkened
+  /// edges and fine detail when downscaling; alpha stays linear.
+  linear(1);
+
+  final int value;
+  const ResizeColorSpace(this.value);
+}
+
+/// How the alpha channel of RGBA input is treated while resampling
+enum AlphaMode {
+  /// Straight (non-premultiplied) alpha; colors are premultiplied before
+  /// filtering and unpremultiplied after (default)
+  straight(0),
+
+  /// Input is already premultiplied (canvas/compositor buffers); output stays
+  /// premultiplied and both conversion passes are skipped
+  premultiplied(1),
+
+  /// Alpha is filtered as an independent channel, without weighting colors
+  ignore(2),
+
+  /// Straight alpha with a faster, slightly less precise premultiply
+  straightFast(3);
+
+  final int value;
+  const AlphaMode(this.value);
+}
+
+/// Channel order of raw pixel buffers (see [BicubicResizer.resizeRaw])
+enum PixelLayout {
+  /// Single-channel grayscale
+  gray(0, 1),
+
+  /// Gray + alpha
+  ra(1, 2),
+
+  /// Alpha + gray
+  ar(2, 2),
+
+  /// Red, green, blue
+  rgb(3, 3),
+
+  /// Blue, green, red (OpenCV)
+  bgr(4, 3),
+
+  /// Red, green, blue, alpha
+  rgba(5, 4),
+
+  /// Blue, green, red, alpha (most platform surfaces and camera buffers)
+  bgra(6, 4),
+
+  /// Alpha, red, green, blue
+  argb(7, 4),
+
+  /// Alpha, blue, green, red
+  abgr(8, 4);
+
+  final int value;
+
+  /// Bytes per pixel
+  final int channels;
+
+  const PixelLayout(this.value, this.channels);
+}
+
 /// Crop anchor positions
 enum CropAnchor {
   /// Center of the image (default)
@@ -116,7 +193,314 @@ enum CropAspectRatio {
   const CropAspectRatio(this.value);
 }
 
+/// Memory layout of float tensor output
+enum TensorLayout {
+  /// Interleaved height x width x channels (default, TensorFlow Lite)
+  nhwc(0),
+
+  /// Planar channels x height x width (PyTorch / ONNX)
+  nchw(1);
+
+  final int value;
+  const TensorLayout(this.value);
+}
+
+/// Channel order of float tensor output
+enum ChannelOrder {
+  /// Red, green, blue (default)
+  rgb(0),
+
+  /// Blue, green, red (OpenCV / Caffe models)
+  bgr(1);
+
+  final int value;
+  const ChannelOrder(this.value);
+}
+
+/// YUV to RGB conversion matrix for camera frames
+enum YuvColorMatrix {
+  /// BT.601 full range (JFIF). Default, used by most Android cameras.
+  bt601Full(0),
+
+  /// BT.601 limited range (Y 16-235, SD video)
+  bt601Limited(1),
+
+  /// BT.709 limited range (Y 16-235, HD video)
+  bt709Limited(2);
+
+  final int value;
+  const YuvColorMatrix(this.value);
+}
+
+/// Horizontal position of the chroma samples in a YUV 4:2:0 frame
+enum YuvChromaSiting {
+  /// On the even luma columns (MPEG-2, Android camera). Default.
+  cosited(0),
+
+  /// Halfway between two luma columns (JPEG/JFIF, MPEG-1)
+  center(1);
+
+  final int value;
+  const YuvChromaSiting(this.value);
+}
+
+/// Chroma subsampling of JPEG output
+enum JpegChromaSubsampling {
+  /// 4:2:0 at quality 90 or below, 4:4:4 above (default)
+  auto(-1),
+
+  /// Full-resolution chroma (sharper color edges, larger files)
+  yuv444(0),
+
+  /// Half-resolution chroma in both directions (smaller files)
+  yuv420(1);
+
+  final int value;
+  const JpegChromaSubsampling(this.value);
+}
+
+/// Row filter used by the PNG encoder
+enum PngFilter {
+  /// Pick the filter with the smallest residual per row (default)
+  adaptive(-1),
+
+  /// No filtering (fastest encode)
+  none(0),
+
+  /// Difference to the left pixel
+  sub(1),
+
+  /// Difference to the pixel above
+  up(2),
+
+  /// Difference to the average of left and above
+  average(3),
+
+  /// Paeth predictor (usually smallest for photos)
+  paeth(4);
+
+  final int value;
+  const PngFilter(this.value);
+}
+
+/// One output of a [BicubicResizer.resizeMulti] call.
+///
+/// Parameters have the same meaning as in [BicubicResizer.resize].
+class ResizeOutputSpec {
+  /// Desired output width
+  final int outputWidth;
+
+  /// Desired output height
+  final int outputHeight;
+
+  /// Output format, or `null` to use the input's format
+  final ImageFormat? format;
+
+  /// JPEG output quality (1-100). Ignored for PNG output.
+  final int quality;
+
+  /// JPEG chroma subsampling. Ignored for PNG output.
+  final JpegChromaSubsampling chromaSubsampling;
+
+  /// PNG compression level (0-9). Ignored for JPEG output.
+  final int compressionLevel;
+
+  /// PNG row filter. Ignored for JPEG output.
+  final PngFilter pngFilter;
+
+  /// Bicubic filter type
+  final BicubicFilter filter;
+
+  /// Filter for the vertical axis (null = same as [filter])
+  final BicubicFilter? verticalFilter;
+
+  /// How to handle pixels outside image bounds
+  final EdgeMode edgeMode;
+
+  /// Edge mode for the vertical axis (null = same as [edgeMode])
+  final EdgeMode? verticalEdgeMode;
+
+  /// Resample stored values or in linear light
+  final ResizeColorSpace colorSpace;
+
+  /// Box-average to about this many times the output size before
+  /// filtering, for fast extreme downscales (0 = off)
+  final double reducingGap;
+
+  /// Crop factor (0.0-1.0), 1.0 = no crop
+  final double crop;
+
+  /// Position to anchor the crop
+  final CropAnchor cropAnchor;
+
+  /// Aspect ratio mode for crop
+  final CropAspectRatio cropAspectRatio;
+
+  /// Custom aspect ratio width (only used with CropAspectRatio.custom)
+  final double aspectRatioWidth;
+
+  /// Custom aspect ratio height (only used with CropAspectRatio.custom)
+  final double aspectRatioHeight;
+
+  const ResizeOutputSpec({
+    required this.outputWidth,
+    required this.outputHeight,
+    this.format,
+    this.quality = 95,
+    this.chromaSubsampling = JpegChromaSubsampling.auto,
+    this.compressionLevel = 6,
+    this.pngFilter = PngFilter.adaptive,
+    this.filter = BicubicFilter.catmullRom,
+    this.verticalFilter,
+    this.edgeMode = EdgeMode.clamp,
+    this.verticalEdgeMode,
+    this.colorSpace = ResizeColorSpace.gamma,
+    this.reducingGap = 0.0,
+    this.crop = 1.0,
+    this.cropAnchor = CropAnchor.center,
+    this.cropAspectRatio = CropAspectRatio.square,
+    this.aspectRatioWidth = 1.0,
+    this.aspectRatioHeight = 1.0,
+  });
+}
+
+/// One image of a [BicubicResizer.resizeBatch] call.
+///
+/// The input format (JPEG or PNG) is detected from [bytes]; the output is
+/// encoded in the same format. Parameters have the same meaning as in
+/// [BicubicResizer.resize].
+class BatchResizeRequest {
+  /// Image data (JPEG or PNG)
+  final Uint8List bytes;
+
+  /// Desired output width
+  final int outputWidth;
+
+  /// Desired output height
+  final int outputHeight;
+
+  /// JPEG output quality (1-100). Ignored for PNG.
+  final int quality;
+
+  /// PNG compression level (0-9). Ignored for JPEG.
+  final int compressionLevel;
+
+  /// JPEG chroma subsampling. Ignored for PNG.
+  final JpegChromaSubsampling chromaSubsampling;
+
+  /// PNG row filter. Ignored for JPEG.
+  final PngFilter pngFilter;
+
+  /// Bicubic filter type
+  final BicubicFilter filter;
+
+  /// Filter for the vertical axis (null = same as [filter])
+  final BicubicFilter? verticalFilter;
+
+  /// How to handle pixels outside image bounds
+  final EdgeMode edgeMode;
+
+  /// Edge mode for the vertical axis (null = same as [edgeMode])
+  final EdgeMode? verticalEdgeMode;
+
+  /// Resample stored values or in linear light
+  final ResizeColorSpace colorSpace;
+
+  /// Box-average to about this many times the output size before
+  /// filtering, for fast extreme downscales (0 = off)
+  final double reducingGap;
+
+  /// Crop factor (0.0-1.0), 1.0 = no crop
+  final double crop;
+
+  /// Position to anchor the crop
+  final CropAnchor cropAnchor;
+
+  /// Aspect ratio mode for crop
+  final CropAspectRatio cropAspectRatio;
+
+  /// Custom aspect ratio width (only used with CropAspectRatio.custom)
+  final double aspectRatioWidth;
+
+  /// Custom aspect ratio height (only used with CropAspectRatio.custom)
+  final double aspectRatioHeight;
+
+  /// Whether to apply EXIF orientation for JPEG
+  final bool applyExifOrientation;
+
+  const BatchResizeRequest({
+    required this.bytes,
+    required this.outputWidth,
+    required this.outputHeight,
+    this.quality = 95,
+    this.compressionLevel = 6,
+    this.chromaSubsampling = JpegChromaSubsampling.auto,
+    this.pngFilter = PngFilter.adaptive,
+    this.filter = BicubicFilter.catmullRom,
+    this.verticalFilter,
+    this.edgeMode = EdgeMode.clamp,
+    this.verticalEdgeMode,
+    this.colorSpace = ResizeColorSpace.gamma,
+    this.reducingGap = 0.0,
+    this.crop = 1.0,
+    this.cropAnchor = CropAnchor.center,
+    this.cropAspectRatio = CropAspectRatio.square,
+    this.aspectRatioWidth = 1.0,
+    this.aspectRatioHeight = 1.0,
+    this.applyExifOrientation = true,
+  });
+}
+
+/// Header information of a JPEG/PNG image, from [BicubicResizer.probe].
+class ImageProbeInfo {
+  /// Source format
+  final ImageFormat format;
+
+  /// Width after EXIF orientation (the width resize calls see)
+  final int width;
+
+  /// Height after EXIF orientation (the height resize calls see)
+  final int height;
+
+  /// Stored channels: 1 = gray, 2 = gray + alpha, 3 = RGB, 4 = RGBA
+  final int channels;
+
+  /// Bits per sample (JPEG 8 or 12, PNG 1, 2, 4, 8 or 16)
+  final int bitDepth;
+
+  /// EXIF orientation 1-8 (always 1 for PNG)
+  final int orientation;
+
+  /// Whether the image is a progressive JPEG or an interlaced PNG
+  final bool progressive;
+
+  const ImageProbeInfo({
+    required this.format,
+    required this.width,
+    required this.height,
+    required this.channels,
+    required this.bitDepth,
+    required this.orientation,
+    required this.progressive,
+  });
+
+  factory ImageProbeInfo._fromNative(BicubicProbeInfo info) {
+    return ImageProbeInfo(
+      format: info.format == 1 ? ImageFormat.png : ImageFormat.jpeg,
+      width: info.width,
+      height: info.height,
+      channels: info.channels,
+      bitDepth: info.bitDepth,
+      orientation: info.orientation,
+      progressive: info.progressive != 0,
+    );
+  }
+}
+
 class BicubicResizer {
+  // PIXEL_LAYOUT_PLANAR in resize.h: one output plane per channel
+  static const _planarLayoutFlag = 0x100;
+
   // ============================================================================
   // Raw pixel resize (sync)
   // ============================================================================
@@ -126,15 +510,21 @@ class BicubicResizer {
   /// [input] - Raw RGB pixel data (3 bytes per pixel)
   /// [inputWidth] - Width of input image in pixels
   /// [inputHeight] - Height of input image in pixels
+  /// [inputRowStride] - Bytes between input rows, for padded buffers (0 = tightly packed)
   /// [outputWidth] - Desired output width
   /// [outputHeight] - Desired output height
   /// [filter] - Bicubic filter type (default: Catmull-Rom)
+  /// [verticalFilter] - Vertical-axis filter (default: same as [filter])
   /// [edgeMode] - How to handle pixels outside image bounds (default: clamp)
+  /// [verticalEdgeMode] - Vertical-axis edge mode (default: [edgeMode])
+  /// [colorSpace] - Resample stored values or in linear light (default: gamma)
+  /// [reducingGap] - Box-average to ~reducingGap x the output size before filtering (0 = off)
   /// [crop] - Crop factor (0.0-1.0), 1.0 = no crop, 0.5 = 50%
   /// [cropAnchor] - Position to anchor the crop (default: center)
   /// [cropAspectRatio] - Aspect ratio mode for crop (default: square)
   /// [aspectRatioWidth] - Custom aspect ratio width (only used with CropAspectRatio.custom)
   /// [aspectRatioHeight] - Custom aspect ratio height (only used with CropAspectRatio.custom)
+  /// [numThreads] - Threads used for the resize pass (0 = auto, 1 = single-threaded)
   ///
   /// Returns resized RGB pixel data
   static Uint8List resizeRgb({
@@ -143,291 +533,1355 @@ class BicubicResizer {
     required int inputHeight,
     required int outputWidth,
     required int outputHeight,
+    int inputRowStride = 0,
     BicubicFilter filter = BicubicFilter.catmullRom,
+    BicubicFilter? verticalFilter,
     EdgeMode edgeMode = EdgeMode.clamp,
+    EdgeMode? verticalEdgeMode,
+    ResizeColorSpace colorSpace = ResizeColorSpace.gamma,
+    double reducingGap = 0.0,
     double crop = 1.0,
     CropAnchor cropAnchor = CropAnchor.center,
     CropAspectRatio cropAspectRatio = CropAspectRatio.square,
     double aspectRatioWidth = 1.0,
     double aspectRatioHeight = 1.0,
+    int numThreads = 0,
   }) {
-    final expectedInputSize = inputWidth * inputHeight * 3;
-    if (input.length != expectedInputSize) {
-      throw ArgumentError(
-        'Input size mismatch: expected $expectedInputSize bytes, got ${input.length}',
-      );
-    }
-
-    final outputSize = outputWidth * outputHeight * 3;
-    final inputPtr = calloc<Uint8>(input.length);
-    final outputPtr = calloc<Uint8>(outputSize);
+    _checkRawInputSize(input, inputWidth, inputHeight, 3, inputRowStride);
 
+    final inputPtr = _copyToNative(input);
     try {
-      inputPtr.asTypedList(input.length).setAll(0, input);
-
-      final result = NativeBindings.instance.bicubicResizeRgb(
-        inputPtr,
-        inputWidth,
-        inputHeight,
-        outputPtr,
-        outputWidth,
-        outputHeight,
-        filter.value,
-        edgeMode.value,
-        crop,
-        cropAnchor.value,
-        cropAspectRatio.value,
-        aspectRatioWidth,
-        aspectRatioHeight,
+      return resizeRgbFromPointer(
+        input: inputPtr,
+        inputWidth: inputWidth,
+        inputHeight: inputHeight,
+        outputWidth: outputWidth,
+        outputHeight: outputHeight,
+        inputRowStride: inputRowStride,
+        filter: filter,
+        verticalFilter: verticalFilter,
+        edgeMode: edgeMode,
+        verticalEdgeMode: verticalEdgeMode,
+        colorSpace: colorSpace,
+        reducingGap: reducingGap,
+        crop: crop,
+        cropAnchor: cropAnchor,
+        cropAspectRatio: cropAspectRatio,
+        aspectRatioWidth: aspectRatioWidth,
+        aspectRatioHeight: aspectRatioHeight,
+        numThreads: numThreads,
       );
-
-      if (result != 0) {
-        throw Exception('Native bicubic resize failed with code: $result');
-      }
-
-      return Uint8List.fromList(outputPtr.asTypedList(outputSize));
     } finally {
-      calloc.free(inputPtr);
-      calloc.free(outputPtr);
+      malloc.free(inputPtr);
     }
   }
 
+  /// Resize raw RGB pixels from a caller-owned native buffer
+  ///
+  /// Same as [resizeRgb] but reads the input in place (no copy), e.g.
+  /// from a camera plugin or a buffer reused across frames. The caller keeps
+  /// ownership of [input], which must hold `inputHeight` rows of
+  /// [inputRowStride] bytes (or `inputWidth * 3` bytes when 0).
+  ///
+  /// Returns resized RGB pixel data backed by native memory (freed when
+  /// the list is garbage collected)
+  static Uint8List resizeRgbFromPointer({
+    required Pointer<Uint8> input,
+    required int inputWidth,
+    required int inputHeight,
+    required int outputWidth,
+    required int outputHeight,
+    int inputRowStride = 0,
+    BicubicFilter filter = BicubicFilter.catmullRom,
+    BicubicFilter? verticalFilter,
+    EdgeMode edgeMode = EdgeMode.clamp,
+    EdgeMode? verticalEdgeMode,
+    ResizeColorSpace colorSpace = ResizeColorSpace.gamma,
+    double reducingGap = 0.0,
+    double crop = 1.0,
+    CropAnchor cropAnchor = CropAnchor.center,
+    CropAspectRatio cropAspectRatio = CropAspectRatio.square,
+    double aspectRatioWidth = 1.0,
+    double aspectRatioHeight = 1.0,
+    int numThreads = 0,
+  }) {
+    final outputSize = outputWidth * outputHeight * 3;
+    final outputPtr = malloc<Uint8>(outputSize);
+
+    final result = NativeBindings.instance.bicubicResizeRgbStrided(
+      input,
+      inputWidth,
+      inputHeight,
+      inputRowStride,
+      outputPtr,
+      outputWidth,
+      outputHeight,
+      0,
+      packAxes(filter.value, verticalFilter?.value),
+      packAxes(edgeMode.value, verticalEdgeMode?.value),
+      colorSpace.value,
+      reducingGap,
+      crop,
+      cropAnchor.value,
+      cropAspectRatio.value,
+      aspectRatioWidth,
+      aspectRatioHeight,
+      numThreads,
+    );
+
+    if (result != 0) {
+      malloc.free(outputPtr);
+      throw Exception('Native bicubic resize failed with code: $result');
+    }
+
+    return _adoptNative(outputPtr, outputSize);
+  }
+
   /// Resize raw RGBA bytes using bicubic interpolation
   ///
   /// [input] - Raw RGBA pixel data (4 bytes per pixel)
   /// [inputWidth] - Width of input image in pixels
   /// [inputHeight] - Height of input image in pixels
+  /// [inputRowStride] - Bytes between input rows, for padded buffers (0 = tightly packed)
   /// [outputWidth] - Desired output width
   /// [outputHeight] - Desired output height
   /// [filter] - Bicubic filter type (default: Catmull-Rom)
+  /// [verticalFilter] - Vertical-axis filter (default: same as [filter])
   /// [edgeMode] - How to handle pixels outside image bounds (default: clamp)
+  /// [verticalEdgeMode] - Vertical-axis edge mode (default: [edgeMode])
+  /// [colorSpace] - Resample stored values or in linear light (default: gamma)
+  /// [alphaMode] - Straight, premultiplied or ignored alpha (default: straight)
+  /// [reducingGap] - Box-average to ~reducingGap x the output size before filtering (0 = off)
   /// [crop] - Crop factor (0.0-1.0), 1.0 = no crop, 0.5 = 50%
   /// [cropAnchor] - Position to anchor the crop (default: center)
   /// [cropAspectRatio] - Aspect ratio mode for crop (default: square)
   /// [aspectRatioWidth] - Custom aspect ratio width (only used with CropAspectRatio.custom)
   /// [aspectRatioHeight] - Custom aspect ratio height (only used with CropAspectRatio.custom)
+  /// [numThreads] - Threads used for the resize pass (0 = auto, 1 = single-threaded)
+  /// [dropOpaqueAlpha] - Return RGB when every alpha value in the crop is 255
   ///
-  /// Returns resized RGBA pixel data
+  /// Returns resized RGBA pixel data, or RGB pixel data (3 bytes per pixel,
+  /// `outputWidth * outputHeight * 3` bytes) when [dropOpaqueAlpha] is set
+  /// and the input is opaque. Opaque input is also resampled faster, since
+  /// no alpha weighting is needed.
   static Uint8List resizeRgba({
     required Uint8List input,
     required int inputWidth,
     required int inputHeight,
     required int outputWidth,
     required int outputHeight,
+    int inputRowStride = 0,
     BicubicFilter filter = BicubicFilter.catmullRom,
+    BicubicFilter? verticalFilter,
     EdgeMode edgeMode = EdgeMode.clamp,
+    EdgeMode? verticalEdgeMode,
+    ResizeColorSpace colorSpace = ResizeColorSpace.gamma,
+    AlphaMode alphaMode = AlphaMode.straight,
+    double reducingGap = 0.0,
     double crop = 1.0,
     CropAnchor cropAnchor = CropAnchor.center,
     CropAspectRatio cropAspectRatio = CropAspectRatio.square,
     double aspectRatioWidth = 1.0,
     double aspectRatioHeight = 1.0,
+    int numThreads = 0,
+    bool dropOpaqueAlpha = false,
   }) {
-    final expectedInputSize = inputWidth * inputHeight * 4;
-    if (input.length != expectedInputSize) {
-      throw ArgumentError(
-        'Input size mismatch: expected $expectedInputSize bytes, got ${input.length}',
-      );
-    }
-
-    final outputSize = outputWidth * outputHeight * 4;
-    final inputPtr = calloc<Uint8>(input.length);
-    final outputPtr = calloc<Uint8>(outputSize);
+    _checkRawInputSize(input, inputWidth, inputHeight, 4, inputRowStride);
 
+    final inputPtr = _copyToNative(input);
     try {
-      inputPtr.asTypedList(input.length).setAll(0, input);
-
-      final result = NativeBindings.instance.bicubicResizeRgba(
-        inputPtr,
-        inputWidth,
-        inputHeight,
-        outputPtr,
-        outputWidth,
-        outputHeight,
-        filter.value,
-        edgeMode.value,
-        crop,
-        cropAnchor.value,
-        cropAspectRatio.value,
-        aspectRatioWidth,
-        aspectRatioHeight,
+      return resizeRgbaFromPointer(
+        input: inputPtr,
+        inputWidth: inputWidth,
+        inputHeight: inputHeight,
+        outputWidth: outputWidth,
+        outputHeight: outputHeight,
+        inputRowStride: inputRowStride,
+        filter: filter,
+        verticalFilter: verticalFilter,
+        edgeMode: edgeMode,
+        verticalEdgeMode: verticalEdgeMode,
+        colorSpace: colorSpace,
+        alphaMode: alphaMode,
+        reducingGap: reducingGap,
+        crop: crop,
+        cropAnchor: cropAnchor,
+        cropAspectRatio: cropAspectRatio,
+        aspectRatioWidth: aspectRatioWidth,
+        aspectRatioHeight: aspectRatioHeight,
+        numThreads: numThreads,
+        dropOpaqueAlpha: dropOpaqueAlpha,
       );
-
-      if (result != 0) {
-        throw Exception('Native bicubic resize failed with code: $result');
-      }
-
-      return Uint8List.fromList(outputPtr.asTypedList(outputSize));
     } finally {
-      calloc.free(inputPtr);
-      calloc.free(outputPtr);
+      malloc.free(inputPtr);
     }
   }
 
-  // ============================================================================
-  // JPEG resize (full native pipeline)
-  // ============================================================================
-
-  /// Resize JPEG image bytes using bicubic interpolation
-  ///
-  /// Entire pipeline (decode -> resize -> encode) runs in native C code.
-  /// This is synchronous but very fast due to native performance.
+  /// Resize raw RGBA pixels from a caller-owned native buffer
   ///
-  /// [jpegBytes] - JPEG encoded image data
-  /// [outputWidth] - Desired output width
-  /// [outputHeight] - Desired output height
-  /// [quality] - JPEG output quality (1-100, default 95)
-  /// [filter] - Bicubic filter type (default: Catmull-Rom)
-  /// [edgeMode] - How to handle pixels outside image bounds (default: clamp)
-  /// [crop] - Crop factor (0.0-1.0), 1.0 = no crop, 0.5 = 50%
-  /// [cropAnchor] - Position to anchor the crop (default: center)
-  /// [cropAspectRatio] - Aspect ratio mode for crop (default: square)
-  /// [aspectRatioWidth] - Custom aspect ratio width (only used with CropAspectRatio.custom)
-  /// [aspectRatioHeight] - Custom aspect ratio height (only used with CropAspectRatio.custom)
-  /// [applyExifOrientation] - Whether to apply EXIF orientation (default: true)
+  /// Same as [resizeRgba] but reads the input in place (no copy), e.g.
+  /// from a camera plugin or a buffer reused across frames. The caller keeps
+  /// ownership of [input], which must hold `inputHeight` rows of
+  /// [inputRowStride] bytes (or `inputWidth * 4` bytes when 0).
   ///
-  /// Returns resized JPEG encoded data
-  static Uint8List resizeJpeg({
-    required Uint8List jpegBytes,
+  /// Returns resized RGBA (or, with [dropOpaqueAlpha], possibly RGB) pixel
+  /// data backed by native memory (freed when the list is garbage collected)
+  static Uint8List resizeRgbaFromPointer({
+    required Pointer<Uint8> input,
+    required int inputWidth,
+    required int inputHeight,
     required int outputWidth,
     required int outputHeight,
-    int quality = 95,
+    int inputRowStride = 0,
     BicubicFilter filter = BicubicFilter.catmullRom,
+    BicubicFilter? verticalFilter,
     EdgeMode edgeMode = EdgeMode.clamp,
+    EdgeMode? verticalEdgeMode,
+    ResizeColorSpace colorSpace = ResizeColorSpace.gamma,
+    AlphaMode alphaMode = AlphaMode.straight,
+    double reducingGap = 0.0,
     double crop = 1.0,
     CropAnchor cropAnchor = CropAnchor.center,
     CropAspectRatio cropAspectRatio = CropAspectRatio.square,
     double aspectRatioWidth = 1.0,
     double aspectRatioHeight = 1.0,
-    bool applyExifOrientation = true,
+    int numThreads = 0,
+    bool dropOpaqueAlpha = false,
   }) {
-    final inputPtr = calloc<Uint8>(jpegBytes.length);
-    final outputDataPtr = calloc<Pointer<Uint8>>();
-    final outputSizePtr = calloc<Int32>();
-
-    try {
-      inputPtr.asTypedList(jpegBytes.length).setAll(0, jpegBytes);
+    final outputSize = outputWidth * outputHeight * 4;
+    final outputPtr = malloc<Uint8>(outputSize);
+
+    if (dropOpaqueAlpha) {
+      final channelsPtr = calloc<Int32>();
+      try {
+        final result = NativeBindings.instance.bicubicResizeRgbaDropOpaqueAlpha(
+          input,
+          inputWidth,
+          inputHeight,
+          inputRowStride,
+          outputPtr,
+          outputWidth,
+          outputHeight,
+          packAxes(filter.value, verticalFilter?.value),
+          packAxes(edgeMode.value, verticalEdgeMode?.value),
+          colorSpace.value,
+          alphaMode.value,
+          reducingGap,
+          crop,
+          cropAnchor.value,
+          cropAspectRatio.value,
+          aspectRatioWidth,
+          aspectRatioHeight,
+          numThreads,
+          channelsPtr,
+        );
 
-      final result = NativeBindings.instance.bicubicResizeJpeg(
-        inputPtr,
-        jpegBytes.length,
-        outputWidth,
-        outputHeight,
-        quality,
-        filter.value,
-        edgeMode.value,
-        crop,
-        cropAnchor.value,
-        cropAspectRatio.value,
-        aspectRatioWidth,
-        aspectRatioHeight,
-        applyExifOrientation ? 1 : 0,
-        outputDataPtr,
-        outputSizePtr,
-      );
+        if (result != 0) {
+          malloc.free(outputPtr);
+          throw Exception('Native bicubic resize failed with code: $result');
+        }
 
-      if (result != 0) {
-        throw Exception('Native JPEG resize failed with code: $result');
+        return _adoptNative(
+          outputPtr,
+          outputWidth * outputHeight * channelsPtr.value,
+        );
+      } finally {
+        calloc.free(channelsPtr);
       }
+    }
 
-      final outputData = outputDataPtr.value;
-      final outputSize = outputSizePtr.value;
-
-      // Copy data before freeing native buffer
-      final resultBytes = Uint8List.fromList(
-        outputData.asTypedList(outputSize),
-      );
-
-      // Free the native-allocated buffer
-      NativeBindings.instance.freeBuffer(outputData);
-
-      return resultBytes;
-    } finally {
-      calloc.free(inputPtr);
-      calloc.free(outputDataPtr);
-      calloc.free(outputSizePtr);
+    final result = NativeBindings.instance.bicubicResizeRgbaStrided(
+      input,
+      inputWidth,
+      inputHeight,
+      inputRowStride,
+      outputPtr,
+      outputWidth,
+      outputHeight,
+      0,
+      packAxes(filter.value, verticalFilter?.value),
+      packAxes(edgeMode.value, verticalEdgeMode?.value),
+      colorSpace.value,
+      alphaMode.value,
+      reducingGap,
+      crop,
+      cropAnchor.value,
+      cropAspectRatio.value,
+      aspectRatioWidth,
+      aspectRatioHeight,
+      numThreads,
+    );
+
+    if (result != 0) {
+      malloc.free(outputPtr);
+      throw Exception('Native bicubic resize failed with code: $result');
     }
-  }
 
-  // ============================================================================
-  // PNG resize (full native pipeline)
-  // ============================================================================
+    return _adoptNative(outputPtr, outputSize);
+  }
 
-  /// Resize PNG image bytes using bicubic interpolation
-  ///
-  /// Entire pipeline (decode -> resize -> encode) runs in native C code.
-  /// Preserves alpha channel if present.
-  /// This is synchronous but very fast due to native performance.
+  /// Resize raw grayscale bytes using bicubic interpolation
   ///
-  /// [pngBytes] - PNG encoded image data
+  /// [input] - Raw grayscale pixel data (1 byte per pixel)
+  /// [inputWidth] - Width of input image in pixels
+  /// [inputHeight] - Height of input image in pixels
+  /// [inputRowStride] - Bytes between input rows, for padded buffers (0 = tightly packed)
   /// [outputWidth] - Desired output width
   /// [outputHeight] - Desired output height
   /// [filter] - Bicubic filter type (default: Catmull-Rom)
+  /// [verticalFilter] - Vertical-axis filter (default: same as [filter])
   /// [edgeMode] - How to handle pixels outside image bounds (default: clamp)
+  /// [verticalEdgeMode] - Vertical-axis edge mode (default: [edgeMode])
+  /// [colorSpace] - Resample stored values or in linear light (default: gamma)
+  /// [reducingGap] - Box-average to ~reducingGap x the output size before filtering (0 = off)
   /// [crop] - Crop factor (0.0-1.0), 1.0 = no crop, 0.5 = 50%
   /// [cropAnchor] - Position to anchor the crop (default: center)
   /// [cropAspectRatio] - Aspect ratio mode for crop (default: square)
   /// [aspectRatioWidth] - Custom aspect ratio width (only used with CropAspectRatio.custom)
   /// [aspectRatioHeight] - Custom aspect ratio height (only used with CropAspectRatio.custom)
-  /// [compressionLevel] - PNG compression level (0-9, default 6, 0=none, 9=max)
+  /// [numThreads] - Threads used for the resize pass (0 = auto, 1 = single-threaded)
   ///
-  /// Returns resized PNG encoded data
-  static Uint8List resizePng({
-    required Uint8List pngBytes,
+  /// Returns resized grayscale pixel data
+  static Uint8List resizeGray({
+    required Uint8List input,
+    required int inputWidth,
+    required int inputHeight,
     required int outputWidth,
     required int outputHeight,
+    int inputRowStride = 0,
     BicubicFilter filter = BicubicFilter.catmullRom,
+    BicubicFilter? verticalFilter,
     EdgeMode edgeMode = EdgeMode.clamp,
+    EdgeMode? verticalEdgeMode,
+    ResizeColorSpace colorSpace = ResizeColorSpace.gamma,
+    double reducingGap = 0.0,
     double crop = 1.0,
     CropAnchor cropAnchor = CropAnchor.center,
     CropAspectRatio cropAspectRatio = CropAspectRatio.square,
     double aspectRatioWidth = 1.0,
     double aspectRatioHeight = 1.0,
-    int compressionLevel = 6,
+    int numThreads = 0,
   }) {
-    final inputPtr = calloc<Uint8>(pngBytes.length);
-    final outputDataPtr = calloc<Pointer<Uint8>>();
-    final outputSizePtr = calloc<Int32>();
+    _checkRawInputSize(input, inputWidth, inputHeight, 1, inputRowStride);
 
+    final inputPtr = _copyToNative(input);
     try {
-      inputPtr.asTypedList(pngBytes.length).setAll(0, pngBytes);
+      return resizeGrayFromPointer(
+        input: inputPtr,
+        inputWidth: inputWidth,
+        inputHeight: inputHeight,
+        outputWidth: outputWidth,
+        outputHeight: outputHeight,
+        inputRowStride: inputRowStride,
+        filter: filter,
+        verticalFilter: verticalFilter,
+        edgeMode: edgeMode,
+        verticalEdgeMode: verticalEdgeMode,
+        colorSpace: colorSpace,
+        reducingGap: reducingGap,
+        crop: crop,
+        cropAnchor: cropAnchor,
+        cropAspectRatio: cropAspectRatio,
+        aspectRatioWidth: aspectRatioWidth,
+        aspectRatioHeight: aspectRatioHeight,
+        numThreads: numThreads,
+      );
+    } finally {
+      malloc.free(inputPtr);
+    }
+  }
 
-      final result = NativeBindings.instance.bicubicResizePng(
+  /// Resize raw grayscale pixels from a caller-owned native buffer
+  ///
+  /// Same as [resizeGray] but reads the input in place (no copy), e.g.
+  /// from the Y plane of a camera frame. The caller keeps ownership of
+  /// [input], which must hold `inputHeight` rows of [inputRowStride] bytes
+  /// (or `inputWidth` bytes when 0).
+  ///
+  /// Returns resized grayscale pixel data backed by native memory (freed
+  /// when the list is garbage collected)
+  static Uint8List resizeGrayFromPointer({
+    required Pointer<Uint8> input,
+    required int inputWidth,
+    required int inputHeight,
+    required int outputWidth,
+    required int outputHeight,
+    int inputRowStride = 0,
+    BicubicFilter filter = BicubicFilter.catmullRom,
+    BicubicFilter? verticalFilter,
+    EdgeMode edgeMode = EdgeMode.clamp,
+    EdgeMode? verticalEdgeMode,
+    ResizeColorSpace colorSpace = ResizeColorSpace.gamma,
+    double reducingGap = 0.0,
+    double crop = 1.0,
+    CropAnchor cropAnchor = CropAnchor.center,
+    CropAspectRatio cropAspectRatio = CropAspectRatio.square,
+    double aspectRatioWidth = 1.0,
+    double aspectRatioHeight = 1.0,
+    int numThreads = 0,
+  }) {
+    final outputSize = outputWidth * outputHeight;
+    final outputPtr = malloc<Uint8>(outputSize);
+
+    final result = NativeBindings.instance.bicubicResizeGrayStrided(
+      input,
+      inputWidth,
+      inputHeight,
+      inputRowStride,
+      outputPtr,
+      outputWidth,
+      outputHeight,
+      0,
+      packAxes(filter.value, verticalFilter?.value),
+      packAxes(edgeMode.value, verticalEdgeMode?.value),
+      colorSpace.value,
+      reducingGap,
+      crop,
+      cropAnchor.value,
+      cropAspectRatio.value,
+      aspectRatioWidth,
+      aspectRatioHeight,
+      numThreads,
+    );
+
+    if (result != 0) {
+      malloc.free(outputPtr);
+      throw Exception('Native bicubic resize failed with code: $result');
+    }
+
+    return _adoptNative(outputPtr, outputSize);
+  }
+
+  /// Resize raw pixels and convert their channel order in the same pass
+  ///
+  /// [input] - Raw pixel data in [inputLayout]
+  /// [inputLayout] - Channel order of [input]
+  /// [outputLayout] - Channel order of the result (default: same as input);
+  /// must have the same channel count as [inputLayout]
+  /// [planarOutput] - Write one plane per channel (e.g. RRR..GGG..BBB..)
+  /// in [outputLayout] order instead of interleaved pixels
+  /// [alphaMode] - Straight, premultiplied or ignored alpha (default: straight)
+  ///
+  /// Other parameters have the same meaning as in [resizeRgb]. Channels are
+  /// reordered inside the native resampler's load/store loops, so e.g. BGRA
+  /// surfaces need no swizzle pass in Dart.
+  ///
+  /// Returns `outputWidth * outputHeight * channels` bytes of resized pixels
+  static Uint8List resizeRaw({
+    required Uint8List input,
+    required int inputWidth,
+    required int inputHeight,
+    required PixelLayout inputLayout,
+    required int outputWidth,
+    required int outputHeight,
+    PixelLayout? outputLayout,
+    bool planarOutput = false,
+    int inputRowStride = 0,
+    BicubicFilter filter = BicubicFilter.catmullRom,
+    BicubicFilter? verticalFilter,
+    EdgeMode edgeMode = EdgeMode.clamp,
+    EdgeMode? verticalEdgeMode,
+    ResizeColorSpace colorSpace = ResizeColorSpace.gamma,
+    AlphaMode alphaMode = AlphaMode.straight,
+    double reducingGap = 0.0,
+    double crop = 1.0,
+    CropAnchor cropAnchor = CropAnchor.center,
+    CropAspectRatio cropAspectRatio = CropAspectRatio.square,
+    double aspectRatioWidth = 1.0,
+    double aspectRatioHeight = 1.0,
+    int numThreads = 0,
+  }) {
+    _checkRawInputSize(
+      input,
+      inputWidth,
+      inputHeight,
+      inputLayout.channels,
+      inputRowStride,
+    );
+
+    final inputPtr = _copyToNative(input);
+    try {
+      return resizeRawFromPointer(
+        input: inputPtr,
+        inputWidth: inputWidth,
+        inputHeight: inputHeight,
+        inputLayout: inputLayout,
+        outputWidth: outputWidth,
+        outputHeight: outputHeight,
+        outputLayout: outputLayout,
+        planarOutput: planarOutput,
+        inputRowStride: inputRowStride,
+        filter: filter,
+        verticalFilter: verticalFilter,
+        edgeMode: edgeMode,
+        verticalEdgeMode: verticalEdgeMode,
+        colorSpace: colorSpace,
+        alphaMode: alphaMode,
+        reducingGap: reducingGap,
+        crop: crop,
+        cropAnchor: cropAnchor,
+        cropAspectRatio: cropAspectRatio,
+        aspectRatioWidth: aspectRatioWidth,
+        aspectRatioHeight: aspectRatioHeight,
+        numThreads: numThreads,
+      );
+    } finally {
+      malloc.free(inputPtr);
+    }
+  }
+
+  /// Resize raw pixels in any [PixelLayout] from a caller-owned native buffer
+  ///
+  /// Same as [resizeRaw] but reads the input in place (no copy), e.g. a
+  /// locked BGRA platform surface. The caller keeps ownership of [input],
+  /// which must hold `inputHeight` rows of [inputRowStride] bytes (or
+  /// `inputWidth * inputLayout.channels` bytes when 0).
+  ///
+  /// Returns resized pixel data backed by native memory (freed when the list
+  /// is garbage collected)
+  static Uint8List resizeRawFromPointer({
+    required Pointer<Uint8> input,
+    required int inputWidth,
+    required int inputHeight,
+    required PixelLayout inputLayout,
+    required int outputWidth,
+    required int outputHeight,
+    PixelLayout? outputLayout,
+    bool planarOutput = false,
+    int inputRowStride = 0,
+    BicubicFilter filter = BicubicFilter.catmullRom,
+    BicubicFilter? verticalFilter,
+    EdgeMode edgeMode = EdgeMode.clamp,
+    EdgeMode? verticalEdgeMode,
+    ResizeColorSpace colorSpace = ResizeColorSpace.gamma,
+    AlphaMode alphaMode = AlphaMode.straight,
+    double reducingGap = 0.0,
+    double crop = 1.0,
+    CropAnchor cropAnchor = CropAnchor.center,
+    CropAspectRatio cropAspectRatio = CropAspectRatio.square,
+    double aspectRatioWidth = 1.0,
+    double aspectRatioHeight = 1.0,
+    int numThreads = 0,
+  }) {
+    final layout = outputLayout ?? inputLayout;
+    if (layout.channels != inputLayout.channels) {
+      throw ArgumentError(
+        'Output layout ${layout.name} has ${layout.channels} channels, '
+        'input layout ${inputLayout.name} has ${inputLayout.channels}',
+      );
+    }
+
+    final outputSize = outputWidth * outputHeight * layout.channels;
+    final outputPtr = malloc<Uint8>(outputSize);
+
+    final result = NativeBindings.instance.bicubicResizeLayout(
+      input,
+      inputWidth,
+      inputHeight,
+      inputRowStride,
+      inputLayout.value,
+      outputPtr,
+      outputWidth,
+      outputHeight,
+      0,
+      layout.value | (planarOutput ? _planarLayoutFlag : 0),
+      packAxes(filter.value, verticalFilter?.value),
+      packAxes(edgeMode.value, verticalEdgeMode?.value),
+      colorSpace.value,
+      alphaMode.value,
+      reducingGap,
+      crop,
+      cropAnchor.value,
+      cropAspectRatio.value,
+      aspectRatioWidth,
+      aspectRatioHeight,
+      numThreads,
+    );
+
+    if (result != 0) {
+      malloc.free(outputPtr);
+      throw Exception('Native bicubic resize failed with code: $result');
+    }
+
+    return _adoptNative(outputPtr, outputSize);
+  }
+
+  /// Resize raw RGB/RGBA bytes directly into a normalized float32 tensor
+  ///
+  /// Resampling, normalization, channel reordering and layout transposition
+  /// happen in a single native pass, so no intermediate uint8 image or
+  /// second conversion pass is needed for ML preprocessing.
+  ///
+  /// [input] - Raw pixel data (3 or 4 bytes per pixel, see [inputChannels])
+  /// [inputWidth] - Width of input image in pixels
+  /// [inputHeight] - Height of input image in pixels
+  /// [outputWidth] - Desired output width
+  /// [outputHeight] - Desired output height
+  /// [inputChannels] - 3 for RGB, 4 for RGBA (alpha is dropped)
+  /// [layout] - Tensor memory layout (default: NHWC)
+  /// [channelOrder] - Output channel order (default: RGB)
+  /// [mean] - Per-channel mean in output channel order, on a 0.0-1.0 scale
+  /// [std] - Per-channel standard deviation in output channel order, on a 0.0-1.0 scale
+  /// [filter] - Bicubic filter type (default: Catmull-Rom)
+  /// [verticalFilter] - Vertical-axis filter (default: same as [filter])
+  /// [edgeMode] - How to handle pixels outside image bounds (default: clamp)
+  /// [verticalEdgeMode] - Vertical-axis edge mode (default: [edgeMode])
+  /// [colorSpace] - Resample stored values or in linear light (default: gamma)
+  /// [reducingGap] - Box-average to ~reducingGap x the output size before filtering (0 = off)
+  /// [crop] - Crop factor (0.0-1.0), 1.0 = no crop, 0.5 = 50%
+  /// [cropAnchor] - Position to anchor the crop (default: center)
+  /// [cropAspectRatio] - Aspect ratio mode for crop (default: square)
+  /// [aspectRatioWidth] - Custom aspect ratio width (only used with CropAspectRatio.custom)
+  /// [aspectRatioHeight] - Custom aspect ratio height (only used with CropAspectRatio.custom)
+  /// [numThreads] - Threads used for the resize pass (0 = auto, 1 = single-threaded)
+  ///
+  /// Returns `outputWidth * outputHeight * 3` floats where each value is
+  /// `(pixel / 255 - mean[c]) / std[c]`
+  static Float32List resizeRgbToTensor({
+    required Uint8List input,
+    required int inputWidth,
+    required int inputHeight,
+    required int outputWidth,
+    required int outputHeight,
+    int inputChannels = 3,
+    TensorLayout layout = TensorLayout.nhwc,
+    ChannelOrder channelOrder = ChannelOrder.rgb,
+    List<double> mean = const [0.0, 0.0, 0.0],
+    List<double> std = const [1.0, 1.0, 1.0],
+    BicubicFilter filter = BicubicFilter.catmullRom,
+    BicubicFilter? verticalFilter,
+    EdgeMode edgeMode = EdgeMode.clamp,
+    EdgeMode? verticalEdgeMode,
+    ResizeColorSpace colorSpace = ResizeColorSpace.gamma,
+    double reducingGap = 0.0,
+    double crop = 1.0,
+    CropAnchor cropAnchor = CropAnchor.center,
+    CropAspectRatio cropAspectRatio = CropAspectRatio.square,
+    double aspectRatioWidth = 1.0,
+    double aspectRatioHeight = 1.0,
+    int numThreads = 0,
+  }) {
+    if (inputChannels != 3 && inputChannels != 4) {
+      throw ArgumentError.value(inputChannels, 'inputChannels', 'must be 3 or 4');
+    }
+    if (mean.length != 3 || std.length != 3) {
+      throw ArgumentError('mean and std must have exactly 3 values');
+    }
+
+    final expectedInputSize = inputWidth * inputHeight * inputChannels;
+    if (input.length != expectedInputSize) {
+      throw ArgumentError(
+        'Input size mismatch: expected $expectedInputSize bytes, got ${input.length}',
+      );
+    }
+
+    final outputSize = outputWidth * outputHeight * 3;
+    final inputPtr = _copyToNative(input);
+    final outputPtr = malloc<Float>(outputSize);
+    final meanPtr = calloc<Float>(3);
+    final stdPtr = calloc<Float>(3);
+    var adopted = false;
+
+    try {
+      meanPtr.asTypedList(3).setAll(0, mean);
+      stdPtr.asTypedList(3).setAll(0, std);
+
+      final result = NativeBindings.instance.bicubicResizeRgbToTensor(
+        inputPtr,
+        inputWidth,
+        inputHeight,
+        inputChannels,
+        outputPtr,
+        outputWidth,
+        outputHeight,
+        packAxes(filter.value, verticalFilter?.value),
+        packAxes(edgeMode.value, verticalEdgeMode?.value),
+        colorSpace.value,
+        reducingGap,
+        crop,
+        cropAnchor.value,
+        cropAspectRatio.value,
+        aspectRatioWidth,
+        aspectRatioHeight,
+        layout.value,
+        channelOrder.value,
+        meanPtr,
+        stdPtr,
+        numThreads,
+      );
+
+      if (result != 0) {
+        throw Exception('Native tensor resize failed with code: $result');
+      }
+
+      adopted = true;
+      return outputPtr.asTypedList(
+        outputSize,
+        finalizer: NativeBindings.instance.freeBufferPointer,
+      );
+    } finally {
+      malloc.free(inputPtr);
+      if (!adopted) malloc.free(outputPtr);
+      calloc.free(meanPtr);
+      calloc.free(stdPtr);
+    }
+  }
+
+  /// Resize a YUV 4:2:0 camera frame and convert it to RGB/RGBA
+  ///
+  /// Accepts the planes of an Android `YUV_420_888` image (NV21, NV12 or
+  /// I420 memory layouts) directly. The planes are resampled to the output
+  /// size first and converted to RGB there, so no full-resolution RGB frame
+  /// is ever produced.
+  ///
+  /// [yPlane] - Luma plane bytes
+  /// [uPlane] - U (Cb) plane bytes, half width and height
+  /// [vPlane] - V (Cr) plane bytes, half width and height
+  /// [yRowStride] - Bytes between luma rows
+  /// [uvRowStride] - Bytes between chroma rows
+  /// [uvPixelStride] - Bytes between chroma samples (2 for NV21/NV12, 1 for I420)
+  /// [inputWidth] - Width of the frame in pixels
+  /// [inputHeight] - Height of the frame in pixels
+  /// [outputWidth] - Desired output width
+  /// [outputHeight] - Desired output height
+  /// [outputChannels] - 3 for RGB, 4 for RGBA (alpha = 255)
+  /// [colorMatrix] - YUV to RGB conversion matrix (default: BT.601 full range)
+  /// [chromaSiting] - Horizontal chroma sample position (default: co-sited)
+  /// [filter] - Bicubic filter type (default: Catmull-Rom)
+  /// [verticalFilter] - Vertical-axis filter (default: same as [filter])
+  /// [edgeMode] - How to handle pixels outside image bounds (default: clamp)
+  /// [verticalEdgeMode] - Vertical-axis edge mode (default: [edgeMode])
+  /// [colorSpace] - Resample stored values or in linear light (default: gamma)
+  /// [crop] - Crop factor (0.0-1.0), 1.0 = no crop, 0.5 = 50%
+  /// [cropAnchor] - Position to anchor the crop (default: center)
+  /// [cropAspectRatio] - Aspect ratio mode for crop (default: square)
+  /// [aspectRatioWidth] - Custom aspect ratio width (only used with CropAspectRatio.custom)
+  /// [aspectRatioHeight] - Custom aspect ratio height (only used with CropAspectRatio.custom)
+  /// [numThreads] - Threads used for the resize pass (0 = auto, 1 = single-threaded)
+  ///
+  /// Returns resized RGB or RGBA pixel data
+  static Uint8List resizeYuv420({
+    required Uint8List yPlane,
+    required Uint8List uPlane,
+    required Uint8List vPlane,
+    required int yRowStride,
+    required int uvRowStride,
+    required int uvPixelStride,
+    required int inputWidth,
+    required int inputHeight,
+    required int outputWidth,
+    required int outputHeight,
+    int outputChannels = 3,
+    YuvColorMatrix colorMatrix = YuvColorMatrix.bt601Full,
+    YuvChromaSiting chromaSiting = YuvChromaSiting.cosited,
+    BicubicFilter filter = BicubicFilter.catmullRom,
+    BicubicFilter? verticalFilter,
+    EdgeMode edgeMode = EdgeMode.clamp,
+    EdgeMode? verticalEdgeMode,
+    ResizeColorSpace colorSpace = ResizeColorSpace.gamma,
+    double crop = 1.0,
+    CropAnchor cropAnchor = CropAnchor.center,
+    CropAspectRatio cropAspectRatio = CropAspectRatio.square,
+    double aspectRatioWidth = 1.0,
+    double aspectRatioHeight = 1.0,
+    int numThreads = 0,
+  }) {
+    if (outputChannels != 3 && outputChannels != 4) {
+      throw ArgumentError.value(outputChannels, 'outputChannels', 'must be 3 or 4');
+    }
+
+    _checkRawInputSize(yPlane, inputWidth, inputHeight, 1, yRowStride);
+
+    final chromaWidth = (inputWidth + 1) ~/ 2;
+    final chromaHeight = (inputHeight + 1) ~/ 2;
+    final minChromaSize =
+        uvRowStride * (chromaHeight - 1) + (chromaWidth - 1) * uvPixelStride + 1;
+    if (uPlane.length < minChromaSize || vPlane.length < minChromaSize) {
+      throw ArgumentError(
+        'Chroma plane too small: expected at least $minChromaSize bytes',
+      );
+    }
+
+    // One input block for all three planes. With a pixel stride of 2 the
+    // chroma is copied as a single interleaved U,V plane (NV12 order) so the
+    // native side resamples both channels in one pass
+    final interleaved = uvPixelStride == 2;
+    final uvSize = interleaved
+        ? max(uPlane.length, vPlane.length) + 1
+        : uPlane.length + vPlane.length;
+    final inputSize = yPlane.length + uvSize;
+    final outputSize = outputWidth * outputHeight * outputChannels;
+    final inputPtr = malloc<Uint8>(inputSize);
+    final outputPtr = malloc<Uint8>(outputSize);
+    var adopted = false;
+
+    try {
+      final yPtr = inputPtr;
+      final uPtr = Pointer<Uint8>.fromAddress(inputPtr.address + yPlane.length);
+      final vPtr = Pointer<Uint8>.fromAddress(
+        uPtr.address + (interleaved ? 1 : uPlane.length),
+      );
+      yPtr.asTypedList(yPlane.length).setAll(0, yPlane);
+      if (interleaved) {
+        final uv = uPtr.asTypedList(uvSize);
+        uv.setAll(0, uPlane);
+        for (var i = 0; i < vPlane.length; i += 2) {
+          uv[i + 1] = vPlane[i];
+        }
+      } else {
+        uPtr.asTypedList(uPlane.length).setAll(0, uPlane);
+        vPtr.asTypedList(vPlane.length).setAll(0, vPlane);
+      }
+
+      final result = NativeBindings.instance.bicubicResizeYuv420(
+        yPtr,
+        yRowStride,
+        uPtr,
+        vPtr,
+        uvRowStride,
+        uvPixelStride,
+        inputWidth,
+        inputHeight,
+        outputPtr,
+        outputWidth,
+        outputHeight,
+        outputChannels,
+        colorMatrix.value,
+        chromaSiting.value,
+        packAxes(filter.value, verticalFilter?.value),
+        packAxes(edgeMode.value, verticalEdgeMode?.value),
+        colorSpace.value,
+        crop,
+        cropAnchor.value,
+        cropAspectRatio.value,
+        aspectRatioWidth,
+        aspectRatioHeight,
+        numThreads,
+      );
+
+      if (result != 0) {
+        throw Exception('Native YUV resize failed with code: $result');
+      }
+
+      adopted = true;
+      return _adoptNative(outputPtr, outputSize);
+    } finally {
+      malloc.free(inputPtr);
+      if (!adopted) malloc.free(outputPtr);
+    }
+  }
+
+  // ============================================================================
+  // JPEG resize (full native pipeline)
+  // ============================================================================
+
+  /// Resize JPEG image bytes using bicubic interpolation
+  ///
+  /// Entire pipeline (decode -> resize -> encode) runs in native C code.
+  /// This is synchronous but very fast due to native performance.
+  ///
+  /// [jpegBytes] - JPEG encoded image data
+  /// [outputWidth] - Desired output width
+  /// [outputHeight] - Desired output height
+  /// [quality] - JPEG output quality (1-100, default 95)
+  /// [chromaSubsampling] - JPEG chroma subsampling (default: auto)
+  /// [filter] - Bicubic filter type (default: Catmull-Rom)
+  /// [verticalFilter] - Vertical-axis filter (default: same as [filter])
+  /// [edgeMode] - How to handle pixels outside image bounds (default: clamp)
+  /// [verticalEdgeMode] - Vertical-axis edge mode (default: [edgeMode])
+  /// [colorSpace] - Resample stored values or in linear light (default: gamma)
+  /// [reducingGap] - Box-average to ~reducingGap x the output size before filtering (0 = off)
+  /// [crop] - Crop factor (0.0-1.0), 1.0 = no crop, 0.5 = 50%
+  /// [cropAnchor] - Position to anchor the crop (default: center)
+  /// [cropAspectRatio] - Aspect ratio mode for crop (default: square)
+  /// [aspectRatioWidth] - Custom aspect ratio width (only used with CropAspectRatio.custom)
+  /// [aspectRatioHeight] - Custom aspect ratio height (only used with CropAspectRatio.custom)
+  /// [applyExifOrientation] - Whether to apply EXIF orientation (default: true)
+  /// [numThreads] - Threads used for the resize pass (0 = auto, 1 = single-threaded)
+  ///
+  /// Returns resized JPEG encoded data
+  static Uint8List resizeJpeg({
+    required Uint8List jpegBytes,
+    required int outputWidth,
+    required int outputHeight,
+    int quality = 95,
+    JpegChromaSubsampling chromaSubsampling = JpegChromaSubsampling.auto,
+    BicubicFilter filter = BicubicFilter.catmullRom,
+    BicubicFilter? verticalFilter,
+    EdgeMode edgeMode = EdgeMode.clamp,
+    EdgeMode? verticalEdgeMode,
+    ResizeColorSpace colorSpace = ResizeColorSpace.gamma,
+    double reducingGap = 0.0,
+    double crop = 1.0,
+    CropAnchor cropAnchor = CropAnchor.center,
+    CropAspectRatio cropAspectRatio = CropAspectRatio.square,
+    double aspectRatioWidth = 1.0,
+    double aspectRatioHeight = 1.0,
+    bool applyExifOrientation = true,
+    int numThreads = 0,
+  }) {
+    final inputPtr = _copyToNative(jpegBytes);
+    try {
+      return resizeJpegFromPointer(
+        jpegBytes: inputPtr,
+        length: jpegBytes.length,
+        outputWidth: outputWidth,
+        outputHeight: outputHeight,
+        quality: quality,
+        chromaSubsampling: chromaSubsampling,
+        filter: filter,
+        verticalFilter: verticalFilter,
+        edgeMode: edgeMode,
+        verticalEdgeMode: verticalEdgeMode,
+        colorSpace: colorSpace,
+        reducingGap: reducingGap,
+        crop: crop,
+        cropAnchor: cropAnchor,
+        cropAspectRatio: cropAspectRatio,
+        aspectRatioWidth: aspectRatioWidth,
+        aspectRatioHeight: aspectRatioHeight,
+        applyExifOrientation: applyExifOrientation,
+        numThreads: numThreads,
+      );
+    } finally {
+      malloc.free(inputPtr);
+    }
+  }
+
+  /// Resize JPEG data from a caller-owned native buffer
+  ///
+  /// Same as [resizeJpeg] but reads [jpegBytes] in place (no copy). The caller
+  /// keeps ownership of the [length]-byte input buffer.
+  ///
+  /// Returns resized JPEG data backed by native memory (freed when the
+  /// list is garbage collected)
+  static Uint8List resizeJpegFromPointer({
+    required Pointer<Uint8> jpegBytes,
+    required int length,
+    required int outputWidth,
+    required int outputHeight,
+    int quality = 95,
+    JpegChromaSubsampling chromaSubsampling = JpegChromaSubsampling.auto,
+    BicubicFilter filter = BicubicFilter.catmullRom,
+    BicubicFilter? verticalFilter,
+    EdgeMode edgeMode = EdgeMode.clamp,
+    EdgeMode? verticalEdgeMode,
+    ResizeColorSpace colorSpace = ResizeColorSpace.gamma,
+    double reducingGap = 0.0,
+    double crop = 1.0,
+    CropAnchor cropAnchor = CropAnchor.center,
+    CropAspectRatio cropAspectRatio = CropAspectRatio.square,
+    double aspectRatioWidth = 1.0,
+    double aspectRatioHeight = 1.0,
+    bool applyExifOrientation = true,
+    int numThreads = 0,
+  }) {
+    final outputDataPtr = calloc<Pointer<Uint8>>();
+    final outputSizePtr = calloc<Int32>();
+
+    try {
+      final result = NativeBindings.instance.bicubicResizeJpeg(
+        jpegBytes,
+        length,
+        outputWidth,
+        outputHeight,
+        quality,
+        chromaSubsampling.value,
+        packAxes(filter.value, verticalFilter?.value),
+        packAxes(edgeMode.value, verticalEdgeMode?.value),
+        colorSpace.value,
+        reducingGap,
+        crop,
+        cropAnchor.value,
+        cropAspectRatio.value,
+        aspectRatioWidth,
+        aspectRatioHeight,
+        applyExifOrientation ? 1 : 0,
+        numThreads,
+        outputDataPtr,
+        outputSizePtr,
+      );
+
+      if (result != 0) {
+        throw Exception('Native JPEG resize failed with code: $result');
+      }
+
+      // Hand the native buffer to Dart; free_buffer runs when it is collected
+      return _adoptNative(outputDataPtr.value, outputSizePtr.value);
+    } finally {
+      calloc.free(outputDataPtr);
+      calloc.free(outputSizePtr);
+    }
+  }
+
+  // ============================================================================
+  // PNG resize (full native pipeline)
+  // ============================================================================
+
+  /// Resize PNG image bytes using bicubic interpolation
+  ///
+  /// Entire pipeline (decode -> resize -> encode) runs in native C code.
+  /// Preserves alpha channel if present.
+  /// This is synchronous but very fast due to native performance.
+  /// Very large PNGs (over 32 MB decoded) are decoded and resampled a few
+  /// rows at a time, on one thread, so the full image is never in memory.
+  ///
+  /// [pngBytes] - PNG encoded image data
+  /// [outputWidth] - Desired output width
+  /// [outputHeight] - Desired output height
+  /// [filter] - Bicubic filter type (default: Catmull-Rom)
+  /// [verticalFilter] - Vertical-axis filter (default: same as [filter])
+  /// [edgeMode] - How to handle pixels outside image bounds (default: clamp)
+  /// [verticalEdgeMode] - Vertical-axis edge mode (default: [edgeMode])
+  /// [colorSpace] - Resample stored values or in linear light (default: gamma)
+  /// [reducingGap] - Box-average to ~reducingGap x the output size before filtering (0 = off)
+  /// [crop] - Crop factor (0.0-1.0), 1.0 = no crop, 0.5 = 50%
+  /// [cropAnchor] - Position to anchor the crop (default: center)
+  /// [cropAspectRatio] - Aspect ratio mode for crop (default: square)
+  /// [aspectRatioWidth] - Custom aspect ratio width (only used with CropAspectRatio.custom)
+  /// [aspectRatioHeight] - Custom aspect ratio height (only used with CropAspectRatio.custom)
+  /// [compressionLevel] - PNG compression level (0-9, default 6, 0=none, 9=max)
+  /// [pngFilter] - PNG row filter (default: adaptive)
+  /// [numThreads] - Threads used for the resize pass (0 = auto, 1 = single-threaded)
+  ///
+  /// Returns resized PNG encoded data
+  static Uint8List resizePng({
+    required Uint8List pngBytes,
+    required int outputWidth,
+    required int outputHeight,
+    BicubicFilter filter = BicubicFilter.catmullRom,
+    BicubicFilter? verticalFilter,
+    EdgeMode edgeMode = EdgeMode.clamp,
+    EdgeMode? verticalEdgeMode,
+    ResizeColorSpace colorSpace = ResizeColorSpace.gamma,
+    double reducingGap = 0.0,
+    double crop = 1.0,
+    CropAnchor cropAnchor = CropAnchor.center,
+    CropAspectRatio cropAspectRatio = CropAspectRatio.square,
+    double aspectRatioWidth = 1.0,
+    double aspectRatioHeight = 1.0,
+    int compressionLevel = 6,
+    PngFilter pngFilter = PngFilter.adaptive,
+    int numThreads = 0,
+  }) {
+    final inputPtr = _copyToNative(pngBytes);
+    try {
+      return resizePngFromPointer(
+        pngBytes: inputPtr,
+        length: pngBytes.length,
+        outputWidth: outputWidth,
+        outputHeight: outputHeight,
+        filter: filter,
+        verticalFilter: verticalFilter,
+        edgeMode: edgeMode,
+        verticalEdgeMode: verticalEdgeMode,
+        colorSpace: colorSpace,
+        reducingGap: reducingGap,
+        crop: crop,
+        cropAnchor: cropAnchor,
+        cropAspectRatio: cropAspectRatio,
+        aspectRatioWidth: aspectRatioWidth,
+        aspectRatioHeight: aspectRatioHeight,
+        compressionLevel: compressionLevel,
+        pngFilter: pngFilter,
+        numThreads: numThreads,
+      );
+    } finally {
+      malloc.free(inputPtr);
+    }
+  }
+
+  /// Resize PNG data from a caller-owned native buffer
+  ///
+  /// Same as [resizePng] but reads [pngBytes] in place (no copy). The caller
+  /// keeps ownership of the [length]-byte input buffer.
+  ///
+  /// Returns resized PNG data backed by native memory (freed when the
+  /// list is garbage collected)
+  static Uint8List resizePngFromPointer({
+    required Pointer<Uint8> pngBytes,
+    required int length,
+    required int outputWidth,
+    required int outputHeight,
+    BicubicFilter filter = BicubicFilter.catmullRom,
+    BicubicFilter? verticalFilter,
+    EdgeMode edgeMode = EdgeMode.clamp,
+    EdgeMode? verticalEdgeMode,
+    ResizeColorSpace colorSpace = ResizeColorSpace.gamma,
+    double reducingGap = 0.0,
+    double crop = 1.0,
+    CropAnchor cropAnchor = CropAnchor.center,
+    CropAspectRatio cropAspectRatio = CropAspectRatio.square,
+    double aspectRatioWidth = 1.0,
+    double aspectRatioHeight = 1.0,
+    int compressionLevel = 6,
+    PngFilter pngFilter = PngFilter.adaptive,
+    int numThreads = 0,
+  }) {
+    final outputDataPtr = calloc<Pointer<Uint8>>();
+    final outputSizePtr = calloc<Int32>();
+
+    try {
+      final result = NativeBindings.instance.bicubicResizePng(
+        pngBytes,
+        length,
+        outputWidth,
+        outputHeight,
+        packAxes(filter.value, verticalFilter?.value),
+        packAxes(edgeMode.value, verticalEdgeMode?.value),
+        colorSpace.value,
+        reducingGap,
+        crop,
+        cropAnchor.value,
+        cropAspectRatio.value,
+        aspectRatioWidth,
+        aspectRatioHeight,
+        compressionLevel,
+        pngFilter.value,
+        numThreads,
+        outputDataPtr,
+        outputSizePtr,
+      );
+
+      if (result != 0) {
+        throw Exception('Native PNG resize failed with code: $result');
+      }
+
+      // Hand the native buffer to Dart; free_buffer runs when it is collected
+      return _adoptNative(outputDataPtr.value, outputSizePtr.value);
+    } finally {
+      calloc.free(outputDataPtr);
+      calloc.free(outputSizePtr);
+    }
+  }
+
+  // ============================================================================
+  // Batch resize (many images in one native call)
+  // ============================================================================
+
+  /// Resize many JPEG/PNG images in a single native call
+  ///
+  /// Items are decoded, resized and encoded in parallel on a native thread
+  /// pool, which is much faster than calling [resize] once per image when
+  /// thumbnailing large selections.
+  ///
+  /// [requests] - Images and per-image resize parameters
+  /// [numThreads] - Threads used to process items (0 = auto, 1 = single-threaded)
+  ///
+  /// Returns one entry per request, in order: the resized image data in the
+  /// same format as its input, or `null` if that image could not be
+  /// processed (unsupported format, corrupt data, ...)
+  static List<Uint8List?> resizeBatch(
+    List<BatchResizeRequest> requests, {
+    int numThreads = 0,
+  }) {
+    if (requests.isEmpty) return [];
+
+    final (inputPtr, itemsPtr) = _prepareBatch(requests);
+
+    try {
+      NativeBindings.instance.bicubicResizeBatch(
+        itemsPtr,
+        requests.length,
+        numThreads,
+      );
+
+      final results = <Uint8List?>[];
+      for (var i = 0; i < requests.length; i++) {
+        final item = itemsPtr[i];
+        if (item.result != 0 || item.outputData == nullptr) {
+          results.add(null);
+          continue;
+        }
+
+        results.add(_adoptNative(item.outputData, item.outputSize));
+      }
+      return results;
+    } finally {
+      malloc.free(inputPtr);
+      calloc.free(itemsPtr);
+    }
+  }
+
+  // ============================================================================
+  // Multi-rendition resize (one decode, many outputs)
+  // ============================================================================
+
+  /// Produce several renditions of one JPEG/PNG image from a single decode
+  ///
+  /// The image is decoded (and EXIF-oriented) once; each rendition is then
+  /// cropped, resized and encoded from it. Smaller renditions are resampled
+  /// from the nearest rendition of the same crop that is at least twice as
+  /// large instead of from the full image, so e.g. 2048/1024/320/64 px
+  /// upload renditions cost little more than the largest one.
+  ///
+  /// Throws [UnsupportedImageFormatException] if the format is not supported.
+  ///
+  /// [bytes] - Image data (JPEG or PNG)
+  /// [outputs] - Renditions to produce
+  /// [applyExifOrientation] - Whether to apply EXIF orientation for JPEG (default: true)
+  /// [numThreads] - Threads used for resizing and encoding (0 = auto, 1 = single-threaded)
+  ///
+  /// Returns one entry per output spec, in order: the encoded rendition, or
+  /// `null` if that rendition could not be produced
+  static List<Uint8List?> resizeMulti({
+    required Uint8List bytes,
+    required List<ResizeOutputSpec> outputs,
+    bool applyExifOrientation = true,
+    int numThreads = 0,
+  }) {
+    final inputFormat = detectFormat(bytes);
+    if (inputFormat == null) {
+      throw UnsupportedImageFormatException(bytes: bytes);
+    }
+    if (outputs.isEmpty) return [];
+
+    final inputPtr = _copyToNative(bytes);
+    final specsPtr = calloc<BicubicOutputSpec>(outputs.length);
+
+    try {
+      for (var i = 0; i < outputs.length; i++) {
+        final output = outputs[i];
+        final spec = specsPtr[i];
+        spec.outputWidth = output.outputWidth;
+        spec.outputHeight = output.outputHeight;
+        spec.format = (output.format ?? inputFormat) == ImageFormat.png ? 1 : 0;
+        spec.quality = output.quality;
+        spec.chromaSubsampling = output.chromaSubsampling.value;
+        spec.compressionLevel = output.compressionLevel;
+        spec.pngFilter = output.pngFilter.value;
+        spec.filter = packAxes(
+          output.filter.value,
+          output.verticalFilter?.value,
+        );
+        spec.edgeMode = packAxes(
+          output.edgeMode.value,
+          output.verticalEdgeMode?.value,
+        );
+        spec.colorSpace = output.colorSpace.value;
+        spec.reducingGap = output.reducingGap;
+        spec.crop = output.crop;
+        spec.cropAnchor = output.cropAnchor.value;
+        spec.aspectMode = output.cropAspectRatio.value;
+        spec.aspectW = output.aspectRatioWidth;
+        spec.aspectH = output.aspectRatioHeight;
+      }
+
+      NativeBindings.instance.bicubicResizeMulti(
         inputPtr,
-        pngBytes.length,
-        outputWidth,
-        outputHeight,
-        filter.value,
-        edgeMode.value,
-        crop,
-        cropAnchor.value,
-        cropAspectRatio.value,
-        aspectRatioWidth,
-        aspectRatioHeight,
-        compressionLevel,
-        outputDataPtr,
-        outputSizePtr,
+        bytes.length,
+        specsPtr,
+        outputs.length,
+        applyExifOrientation ? 1 : 0,
+        numThreads,
       );
 
-      if (result != 0) {
-        throw Exception('Native PNG resize failed with code: $result');
+      final results = <Uint8List?>[];
+      for (var i = 0; i < outputs.length; i++) {
+        final spec = specsPtr[i];
+        if (spec.result != 0 || spec.outputData == nullptr) {
+          results.add(null);
+          continue;
+        }
+
+        results.add(_adoptNative(spec.outputData, spec.outputSize));
       }
+      return results;
+    } finally {
+      malloc.free(inputPtr);
+      calloc.free(specsPtr);
+    }
+  }
+
+  // ============================================================================
+  // Image probing (header only, no pixel decode)
+  // ============================================================================
+
+  /// Read an image's size, channels, bit depth and orientation from its headers
+  ///
+  /// No pixels are decoded, so this is cheap enough to lay out a gallery or
+  /// plan crops before resizing. [ImageProbeInfo.width] and
+  /// [ImageProbeInfo.height] already account for EXIF orientation.
+  ///
+  /// Throws [UnsupportedImageFormatException] if the format is not supported.
+  ///
+  /// [bytes] - Image data (JPEG or PNG)
+  static ImageProbeInfo probe(Uint8List bytes) {
+    if (detectFormat(bytes) == null) {
+      throw UnsupportedImageFormatException(bytes: bytes);
+    }
 
-      final outputData = outputDataPtr.value;
-      final outputSize = outputSizePtr.value;
+    final inputPtr = _copyToNative(bytes);
+    final infoPtr = calloc<BicubicProbeInfo>();
 
-      // Copy data before freeing native buffer
-      final resultBytes = Uint8List.fromList(
-        outputData.asTypedList(outputSize),
+    try {
+      final result = NativeBindings.instance.bicubicProbe(
+        inputPtr,
+        bytes.length,
+        infoPtr,
       );
 
-      // Free the native-allocated buffer
-      NativeBindings.instance.freeBuffer(outputData);
+      if (result != 0) {
+        throw Exception('Native image probe failed with code: $result');
+      }
+
+      return ImageProbeInfo._fromNative(infoPtr.ref);
+    } finally {
+      malloc.free(inputPtr);
+      calloc.free(infoPtr);
+    }
+  }
+
+  /// Probe many images in one native call
+  ///
+  /// Returns one entry per image, in order: its header information, or `null`
+  /// if the image is not a readable JPEG/PNG
+  ///
+  /// [images] - Image data (JPEG or PNG)
+  static List<ImageProbeInfo?> probeBatch(List<Uint8List> images) {
+    if (images.isEmpty) return [];
+
+    var totalInputSize = 0;
+    for (final bytes in images) {
+      totalInputSize += bytes.length;
+    }
+
+    // One input block for the whole batch instead of one allocation per image
+    final inputPtr = malloc<Uint8>(totalInputSize == 0 ? 1 : totalInputSize);
+    final inputsPtr = calloc<Pointer<Uint8>>(images.length);
+    final sizesPtr = calloc<Int32>(images.length);
+    final infosPtr = calloc<BicubicProbeInfo>(images.length);
+
+    try {
+      var offset = 0;
+      for (var i = 0; i < images.length; i++) {
+        final bytes = images[i];
+        final itemInput = Pointer<Uint8>.fromAddress(inputPtr.address + offset);
+        itemInput.asTypedList(bytes.length).setAll(0, bytes);
+        offset += bytes.length;
+
+        inputsPtr[i] = itemInput;
+        sizesPtr[i] = bytes.length;
+      }
+
+      NativeBindings.instance.bicubicProbeBatch(
+        inputsPtr,
+        sizesPtr,
+        images.length,
+        infosPtr,
+      );
 
-      return resultBytes;
+      return [
+        for (var i = 0; i < images.length; i++)
+          infosPtr[i].result == 0
+              ? ImageProbeInfo._fromNative(infosPtr[i])
+              : null,
+      ];
     } finally {
-      calloc.free(inputPtr);
-      calloc.free(outputDataPtr);
-      calloc.free(outputSizePtr);
+      malloc.free(inputPtr);
+      calloc.free(inputsPtr);
+      calloc.free(sizesPtr);
+      calloc.free(infosPtr);
     }
   }
 
@@ -477,15 +1931,22 @@ class BicubicResizer {
   /// [outputWidth] - Desired output width
   /// [outputHeight] - Desired output height
   /// [quality] - JPEG output quality (1-100, default 95). Ignored for PNG.
+  /// [chromaSubsampling] - JPEG chroma subsampling (default: auto). Ignored for PNG.
   /// [compressionLevel] - PNG compression level (0-9, default 6). Ignored for JPEG.
+  /// [pngFilter] - PNG row filter (default: adaptive). Ignored for JPEG.
   /// [filter] - Bicubic filter type (default: Catmull-Rom)
+  /// [verticalFilter] - Vertical-axis filter (default: same as [filter])
   /// [edgeMode] - How to handle pixels outside image bounds (default: clamp)
+  /// [verticalEdgeMode] - Vertical-axis edge mode (default: [edgeMode])
+  /// [colorSpace] - Resample stored values or in linear light (default: gamma)
+  /// [reducingGap] - Box-average to ~reducingGap x the output size before filtering (0 = off)
   /// [crop] - Crop factor (0.0-1.0), 1.0 = no crop, 0.5 = 50%
   /// [cropAnchor] - Position to anchor the crop (default: center)
   /// [cropAspectRatio] - Aspect ratio mode for crop (default: square)
   /// [aspectRatioWidth] - Custom aspect ratio width (only used with CropAspectRatio.custom)
   /// [aspectRatioHeight] - Custom aspect ratio height (only used with CropAspectRatio.custom)
   /// [applyExifOrientation] - Whether to apply EXIF orientation for JPEG (default: true)
+  /// [numThreads] - Threads used for the resize pass (0 = auto, 1 = single-threaded)
   ///
   /// Returns resized image data in the same format as input
   static Uint8List resize({
@@ -493,15 +1954,22 @@ class BicubicResizer {
     required int outputWidth,
     required int outputHeight,
     int quality = 95,
+    JpegChromaSubsampling chromaSubsampling = JpegChromaSubsampling.auto,
     int compressionLevel = 6,
+    PngFilter pngFilter = PngFilter.adaptive,
     BicubicFilter filter = BicubicFilter.catmullRom,
+    BicubicFilter? verticalFilter,
     EdgeMode edgeMode = EdgeMode.clamp,
+    EdgeMode? verticalEdgeMode,
+    ResizeColorSpace colorSpace = ResizeColorSpace.gamma,
+    double reducingGap = 0.0,
     double crop = 1.0,
     CropAnchor cropAnchor = CropAnchor.center,
     CropAspectRatio cropAspectRatio = CropAspectRatio.square,
     double aspectRatioWidth = 1.0,
     double aspectRatioHeight = 1.0,
     bool applyExifOrientation = true,
+    int numThreads = 0,
   }) {
     final format = detectFormat(bytes);
 
@@ -516,14 +1984,20 @@ class BicubicResizer {
           outputWidth: outputWidth,
           outputHeight: outputHeight,
           quality: quality,
+          chromaSubsampling: chromaSubsampling,
           filter: filter,
+          verticalFilter: verticalFilter,
           edgeMode: edgeMode,
+          verticalEdgeMode: verticalEdgeMode,
+          colorSpace: colorSpace,
+          reducingGap: reducingGap,
           crop: crop,
           cropAnchor: cropAnchor,
           cropAspectRatio: cropAspectRatio,
           aspectRatioWidth: aspectRatioWidth,
           aspectRatioHeight: aspectRatioHeight,
           applyExifOrientation: applyExifOrientation,
+          numThreads: numThreads,
         );
       case ImageFormat.png:
         return resizePng(
@@ -531,14 +2005,605 @@ class BicubicResizer {
           outputWidth: outputWidth,
           outputHeight: outputHeight,
           filter: filter,
+          verticalFilter: verticalFilter,
           edgeMode: edgeMode,
+          verticalEdgeMode: verticalEdgeMode,
+          colorSpace: colorSpace,
+          reducingGap: reducingGap,
           crop: crop,
           cropAnchor: cropAnchor,
           cropAspectRatio: cropAspectRatio,
           aspectRatioWidth: aspectRatioWidth,
           aspectRatioHeight: aspectRatioHeight,
           compressionLevel: compressionLevel,
+          pngFilter: pngFilter,
+          numThreads: numThreads,
+        );
+    }
+  }
+
+  // ============================================================================
+  // Async resize (native threads, no isolate)
+  // ============================================================================
+
+  /// Resize image bytes off the calling isolate
+  ///
+  /// Same as [resize], but the decode/resize/encode pipeline runs on an
+  /// internal native thread and the result is posted back to this isolate,
+  /// so the UI isolate never blocks and no helper isolate is spawned.
+  ///
+  /// Throws [UnsupportedImageFormatException] if the format is not supported.
+  ///
+  /// Returns a future with the resized image data in the same format as input
+  static Future<Uint8List> resizeAsync({
+    required Uint8List bytes,
+    required int outputWidth,
+    required int outputHeight,
+    int quality = 95,
+    JpegChromaSubsampling chromaSubsampling = JpegChromaSubsampling.auto,
+    int compressionLevel = 6,
+    PngFilter pngFilter = PngFilter.adaptive,
+    BicubicFilter filter = BicubicFilter.catmullRom,
+    BicubicFilter? verticalFilter,
+    EdgeMode edgeMode = EdgeMode.clamp,
+    EdgeMode? verticalEdgeMode,
+    ResizeColorSpace colorSpace = ResizeColorSpace.gamma,
+    double reducingGap = 0.0,
+    double crop = 1.0,
+    CropAnchor cropAnchor = CropAnchor.center,
+    CropAspectRatio cropAspectRatio = CropAspectRatio.square,
+    double aspectRatioWidth = 1.0,
+    double aspectRatioHeight = 1.0,
+    bool applyExifOrientation = true,
+    int numThreads = 0,
+  }) async {
+    final format = detectFormat(bytes);
+
+    if (format == null) {
+      throw UnsupportedImageFormatException(bytes: bytes);
+    }
+
+    return _resizeEncodedAsync(
+      BatchResizeRequest(
+        bytes: bytes,
+        outputWidth: outputWidth,
+        outputHeight: outputHeight,
+        quality: quality,
+        chromaSubsampling: chromaSubsampling,
+        compressionLevel: compressionLevel,
+        pngFilter: pngFilter,
+        filter: filter,
+        verticalFilter: verticalFilter,
+        edgeMode: edgeMode,
+        verticalEdgeMode: verticalEdgeMode,
+        colorSpace: colorSpace,
+        reducingGap: reducingGap,
+        crop: crop,
+        cropAnchor: cropAnchor,
+        cropAspectRatio: cropAspectRatio,
+        aspectRatioWidth: aspectRatioWidth,
+        aspectRatioHeight: aspectRatioHeight,
+        applyExifOrientation: applyExifOrientation,
+      ),
+      format == ImageFormat.jpeg ? 'JPEG' : 'PNG',
+      numThreads,
+    );
+  }
+
+  /// Resize JPEG image bytes off the calling isolate
+  ///
+  /// Same as [resizeJpeg], but runs on an internal native thread.
+  ///
+  /// Returns a future with the resized JPEG encoded data
+  static Future<Uint8List> resizeJpegAsync({
+    required Uint8List jpegBytes,
+    required int outputWidth,
+    required int outputHeight,
+    int quality = 95,
+    JpegChromaSubsampling chromaSubsampling = JpegChromaSubsampling.auto,
+    BicubicFilter filter = BicubicFilter.catmullRom,
+    BicubicFilter? verticalFilter,
+    EdgeMode edgeMode = EdgeMode.clamp,
+    EdgeMode? verticalEdgeMode,
+    ResizeColorSpace colorSpace = ResizeColorSpace.gamma,
+    double reducingGap = 0.0,
+    double crop = 1.0,
+    CropAnchor cropAnchor = CropAnchor.center,
+    CropAspectRatio cropAspectRatio = CropAspectRatio.square,
+    double aspectRatioWidth = 1.0,
+    double aspectRatioHeight = 1.0,
+    bool applyExifOrientation = true,
+    int numThreads = 0,
+  }) async {
+    // The native batch job picks the codec from the data itself
+    if (detectFormat(jpegBytes) != ImageFormat.jpeg) {
+      throw Exception('Native JPEG resize failed with code: -1');
+    }
+
+    return _resizeEncodedAsync(
+      BatchResizeRequest(
+        bytes: jpegBytes,
+        outputWidth: outputWidth,
+        outputHeight: outputHeight,
+        quality: quality,
+        chromaSubsampling: chromaSubsampling,
+        filter: filter,
+        verticalFilter: verticalFilter,
+        edgeMode: edgeMode,
+        verticalEdgeMode: verticalEdgeMode,
+        colorSpace: colorSpace,
+        reducingGap: reducingGap,
+        crop: crop,
+        cropAnchor: cropAnchor,
+        cropAspectRatio: cropAspectRatio,
+        aspectRatioWidth: aspectRatioWidth,
+        aspectRatioHeight: aspectRatioHeight,
+        applyExifOrientation: applyExifOrientation,
+      ),
+      'JPEG',
+      numThreads,
+    );
+  }
+
+  /// Resize PNG image bytes off the calling isolate
+  ///
+  /// Same as [resizePng], but runs on an internal native thread.
+  ///
+  /// Returns a future with the resized PNG encoded data
+  static Future<Uint8List> resizePngAsync({
+    required Uint8List pngBytes,
+    required int outputWidth,
+    required int outputHeight,
+    BicubicFilter filter = BicubicFilter.catmullRom,
+    BicubicFilter? verticalFilter,
+    EdgeMode edgeMode = EdgeMode.clamp,
+    EdgeMode? verticalEdgeMode,
+    ResizeColorSpace colorSpace = ResizeColorSpace.gamma,
+    double reducingGap = 0.0,
+    double crop = 1.0,
+    CropAnchor cropAnchor = CropAnchor.center,
+    CropAspectRatio cropAspectRatio = CropAspectRatio.square,
+    double aspectRatioWidth = 1.0,
+    double aspectRatioHeight = 1.0,
+    int compressionLevel = 6,
+    PngFilter pngFilter = PngFilter.adaptive,
+    int numThreads = 0,
+  }) async {
+    if (detectFormat(pngBytes) != ImageFormat.png) {
+      throw Exception('Native PNG resize failed with code: -1');
+    }
+
+    return _resizeEncodedAsync(
+      BatchResizeRequest(
+        bytes: pngBytes,
+        outputWidth: outputWidth,
+        outputHeight: outputHeight,
+        compressionLevel: compressionLevel,
+        pngFilter: pngFilter,
+        filter: filter,
+        verticalFilter: verticalFilter,
+        edgeMode: edgeMode,
+        verticalEdgeMode: verticalEdgeMode,
+        colorSpace: colorSpace,
+        reducingGap: reducingGap,
+        crop: crop,
+        cropAnchor: cropAnchor,
+        cropAspectRatio: cropAspectRatio,
+        aspectRatioWidth: aspectRatioWidth,
+        aspectRatioHeight: aspectRatioHeight,
+      ),
+      'PNG',
+      numThreads,
+    );
+  }
+
+  /// Resize many JPEG/PNG images off the calling isolate
+  ///
+  /// Same as [resizeBatch], but the whole batch runs on internal native
+  /// threads and completes the returned future when every item is done.
+  static Future<List<Uint8List?>> resizeBatchAsync(
+    List<BatchResizeRequest> requests, {
+    int numThreads = 0,
+  }) async {
+    if (requests.isEmpty) return [];
+
+    final (inputPtr, itemsPtr) = _prepareBatch(requests);
+    final message = await _runAsync(
+      (port) => NativeBindings.instance.bicubicResizeBatchAsync(
+        itemsPtr,
+        requests.length,
+        numThreads,
+        port,
+      ),
+      () {
+        malloc.free(inputPtr);
+        calloc.free(itemsPtr);
+      },
+    );
+
+    return [
+      for (var i = 1; i < message.length; i++) message[i] as Uint8List?,
+    ];
+  }
+
+  /// Resize raw RGB bytes off the calling isolate
+  ///
+  /// Same as [resizeRgb], but runs on an internal native thread.
+  ///
+  /// Returns a future with the resized RGB pixel data
+  static Future<Uint8List> resizeRgbAsync({
+    required Uint8List input,
+    required int inputWidth,
+    required int inputHeight,
+    required int outputWidth,
+    required int outputHeight,
+    int inputRowStride = 0,
+    BicubicFilter filter = BicubicFilter.catmullRom,
+    BicubicFilter? verticalFilter,
+    EdgeMode edgeMode = EdgeMode.clamp,
+    EdgeMode? verticalEdgeMode,
+    ResizeColorSpace colorSpace = ResizeColorSpace.gamma,
+    double reducingGap = 0.0,
+    double crop = 1.0,
+    CropAnchor cropAnchor = CropAnchor.center,
+    CropAspectRatio cropAspectRatio = CropAspectRatio.square,
+    double aspectRatioWidth = 1.0,
+    double aspectRatioHeight = 1.0,
+    int numThreads = 0,
+  }) {
+    return _resizeRawAsync(
+      input,
+      inputWidth,
+      inputHeight,
+      inputRowStride,
+      3,
+      outputWidth,
+      outputHeight,
+      filter,
+      verticalFilter,
+      edgeMode,
+      verticalEdgeMode,
+      colorSpace,
+      AlphaMode.straight,
+      reducingGap,
+      crop,
+      cropAnchor,
+      cropAspectRatio,
+      aspectRatioWidth,
+      aspectRatioHeight,
+      numThreads,
+    );
+  }
+
+  /// Resize raw RGBA bytes off the calling isolate
+  ///
+  /// Same as [resizeRgba], but runs on an internal native thread.
+  ///
+  /// Returns a future with the resized RGBA pixel data
+  static Future<Uint8List> resizeRgbaAsync({
+    required Uint8List input,
+    required int inputWidth,
+    required int inputHeight,
+    required int outputWidth,
+    required int outputHeight,
+    int inputRowStride = 0,
+    BicubicFilter filter = BicubicFilter.catmullRom,
+    BicubicFilter? verticalFilter,
+    EdgeMode edgeMode = EdgeMode.clamp,
+    EdgeMode? verticalEdgeMode,
+    ResizeColorSpace colorSpace = ResizeColorSpace.gamma,
+    AlphaMode alphaMode = AlphaMode.straight,
+    double reducingGap = 0.0,
+    double crop = 1.0,
+    CropAnchor cropAnchor = CropAnchor.center,
+    CropAspectRatio cropAspectRatio = CropAspectRatio.square,
+    double aspectRatioWidth = 1.0,
+    double aspectRatioHeight = 1.0,
+    int numThreads = 0,
+  }) {
+    return _resizeRawAsync(
+      input,
+      inputWidth,
+      inputHeight,
+      inputRowStride,
+      4,
+      outputWidth,
+      outputHeight,
+      filter,
+      verticalFilter,
+      edgeMode,
+      verticalEdgeMode,
+      colorSpace,
+      alphaMode,
+      reducingGap,
+      crop,
+      cropAnchor,
+      cropAspectRatio,
+      aspectRatioWidth,
+      aspectRatioHeight,
+      numThreads,
+    );
+  }
+
+  /// Resize raw grayscale bytes off the calling isolate
+  ///
+  /// Same as [resizeGray], but runs on an internal native thread.
+  ///
+  /// Returns a future with the resized grayscale pixel data
+  static Future<Uint8List> resizeGrayAsync({
+    required Uint8List input,
+    required int inputWidth,
+    required int inputHeight,
+    required int outputWidth,
+    required int outputHeight,
+    int inputRowStride = 0,
+    BicubicFilter filter = BicubicFilter.catmullRom,
+    BicubicFilter? verticalFilter,
+    EdgeMode edgeMode = EdgeMode.clamp,
+    EdgeMode? verticalEdgeMode,
+    ResizeColorSpace colorSpace = ResizeColorSpace.gamma,
+    double reducingGap = 0.0,
+    double crop = 1.0,
+    CropAnchor cropAnchor = CropAnchor.center,
+    CropAspectRatio cropAspectRatio = CropAspectRatio.square,
+    double aspectRatioWidth = 1.0,
+    double aspectRatioHeight = 1.0,
+    int numThreads = 0,
+  }) {
+    return _resizeRawAsync(
+      input,
+      inputWidth,
+      inputHeight,
+      inputRowStride,
+      1,
+      outputWidth,
+      outputHeight,
+      filter,
+      verticalFilter,
+      edgeMode,
+      verticalEdgeMode,
+      colorSpace,
+      AlphaMode.straight,
+      reducingGap,
+      crop,
+      cropAnchor,
+      cropAspectRatio,
+      aspectRatioWidth,
+      aspectRatioHeight,
+      numThreads,
+    );
+  }
+
+  // ============================================================================
+  // Native scratch memory
+  // ============================================================================
+
+  /// Set how much scratch memory the native side keeps cached between calls
+  ///
+  /// Every JPEG/PNG/raw resize carves its temporary buffers (decoded pixels,
+  /// filter coefficients, encoder state) from a pooled arena that is reused by
+  /// the next call, instead of making fresh large heap allocations each time.
+  ///
+  /// [maxBytes] - Most memory kept cached (default: 64 MB). 0 disables the
+  /// arenas so every allocation goes straight to malloc.
+  static void setArenaLimit(int maxBytes) {
+    if (maxBytes < 0) {
+      throw ArgumentError.value(maxBytes, 'maxBytes', 'must not be negative');
+    }
+    NativeBindings.instance.bicubicArenaSetLimit(maxBytes);
+  }
+
+  /// Release all cached native scratch memory (e.g. on a low-memory warning)
+  static void trimArenas() {
+    NativeBindings.instance.bicubicArenaTrim();
+  }
+
+  // ============================================================================
+  // Helpers
+  // ============================================================================
+
+  /// Copy batch inputs into one native block (free with malloc.free) and
+  /// build the matching item array (free with calloc.free)
+  static (Pointer<Uint8>, Pointer<BicubicBatchItem>) _prepareBatch(
+    List<BatchResizeRequest> requests,
+  ) {
+    var totalInputSize = 0;
+    for (final request in requests) {
+      totalInputSize += request.bytes.length;
+    }
+
+    // One input block for the whole batch instead of one allocation per image
+    final inputPtr = malloc<Uint8>(totalInputSize == 0 ? 1 : totalInputSize);
+    final itemsPtr = calloc<BicubicBatchItem>(requests.length);
+
+    var offset = 0;
+    for (var i = 0; i < requests.length; i++) {
+      final request = requests[i];
+      final itemInput = Pointer<Uint8>.fromAddress(inputPtr.address + offset);
+      itemInput.asTypedList(request.bytes.length).setAll(0, request.bytes);
+      offset += request.bytes.length;
+
+      final item = itemsPtr[i];
+      item.inputData = itemInput;
+      item.inputSize = request.bytes.length;
+      item.outputWidth = request.outputWidth;
+      item.outputHeight = request.outputHeight;
+      item.quality = request.quality;
+      item.compressionLevel = request.compressionLevel;
+      item.chromaSubsampling = request.chromaSubsampling.value;
+      item.pngFilter = request.pngFilter.value;
+      item.filter = packAxes(
+        request.filter.value,
+        request.verticalFilter?.value,
+      );
+      item.edgeMode = packAxes(
+        request.edgeMode.value,
+        request.verticalEdgeMode?.value,
+      );
+      item.colorSpace = request.colorSpace.value;
+      item.reducingGap = request.reducingGap;
+      item.crop = request.crop;
+      item.cropAnchor = request.cropAnchor.value;
+      item.aspectMode = request.cropAspectRatio.value;
+      item.aspectW = request.aspectRatioWidth;
+      item.aspectH = request.aspectRatioHeight;
+      item.applyExif = request.applyExifOrientation ? 1 : 0;
+    }
+
+    return (inputPtr, itemsPtr);
+  }
+
+  /// Queue a native async job and wait for its completion message
+  ///
+  /// [start] queues the job with the native port to post to (0 = queued);
+  /// [release] frees the job's native inputs once the job can no longer
+  /// touch them. The message is `[result, outputs...]`.
+  static Future<List<Object?>> _runAsync(
+    int Function(int port) start,
+    void Function() release,
+  ) {
+    final completer = Completer<List<Object?>>();
+    final port = RawReceivePort();
+    port.handler = (Object? message) {
+      port.close();
+      release();
+      completer.complete(message! as List<Object?>);
+    };
+
+    final queued = start(port.sendPort.nativePort);
+    if (queued != 0) {
+      port.close();
+      release();
+      throw Exception('Failed to queue native resize job');
+    }
+    return completer.future;
+  }
+
+  /// Run one encoded image through the async batch path
+  static Future<Uint8List> _resizeEncodedAsync(
+    BatchResizeRequest request,
+    String formatName,
+    int numThreads,
+  ) async {
+    final results = await resizeBatchAsync([request], numThreads: numThreads);
+    final output = results.first;
+    if (output == null) {
+      throw Exception('Native $formatName resize failed with code: -1');
+    }
+    return output;
+  }
+
+  /// Run a raw RGB/RGBA resize (copied input) through the async raw path
+  static Future<Uint8List> _resizeRawAsync(
+    Uint8List input,
+    int inputWidth,
+    int inputHeight,
+    int inputRowStride,
+    int channels,
+    int outputWidth,
+    int outputHeight,
+    BicubicFilter filter,
+    BicubicFilter? verticalFilter,
+    EdgeMode edgeMode,
+    EdgeMode? verticalEdgeMode,
+    ResizeColorSpace colorSpace,
+    AlphaMode alphaMode,
+    double reducingGap,
+    double crop,
+    CropAnchor cropAnchor,
+    CropAspectRatio cropAspectRatio,
+    double aspectRatioWidth,
+    double aspectRatioHeight,
+    int numThreads,
+  ) async {
+    _checkRawInputSize(
+      input,
+      inputWidth,
+      inputHeight,
+      channels,
+      inputRowStride,
+    );
+
+    final inputPtr = _copyToNative(input);
+    final message = await _runAsync(
+      (port) => NativeBindings.instance.bicubicResizeRawAsync(
+        inputPtr,
+        inputWidth,
+        inputHeight,
+        inputRowStride,
+        channels,
+        outputWidth,
+        outputHeight,
+        packAxes(filter.value, verticalFilter?.value),
+        packAxes(edgeMode.value, verticalEdgeMode?.value),
+        colorSpace.value,
+        alphaMode.value,
+        reducingGap,
+        crop,
+        cropAnchor.value,
+        cropAspectRatio.value,
+        aspectRatioWidth,
+        aspectRatioHeight,
+        numThreads,
+        port,
+      ),
+      () => malloc.free(inputPtr),
+    );
+
+    final result = message[0]! as int;
+    if (result != 0) {
+      throw Exception('Native bicubic resize failed with code: $result');
+    }
+    return message[1]! as Uint8List;
+  }
+
+  /// Copy Dart bytes into a new malloc'd native buffer (free with malloc.free)
+  static Pointer<Uint8> _copyToNative(Uint8List bytes) {
+    final ptr = malloc<Uint8>(bytes.isEmpty ? 1 : bytes.length);
+    ptr.asTypedList(bytes.length).setAll(0, bytes);
+    return ptr;
+  }
+
+  /// Wrap a malloc'd native buffer as a Uint8List without copying; the
+  /// buffer is released with `free_buffer` when the list is garbage collected
+  static Uint8List _adoptNative(Pointer<Uint8> data, int length) {
+    return data.asTypedList(
+      length,
+      finalizer: NativeBindings.instance.freeBufferPointer,
+    );
+  }
+
+  /// Validate raw pixel input length for tightly packed or padded rows
+  static void _checkRawInputSize(
+    Uint8List input,
+    int width,
+    int height,
+    int channels,
+    int rowStride,
+  ) {
+    final rowBytes = width * channels;
+    if (rowStride == 0) {
+      final expectedInputSize = rowBytes * height;
+      if (input.length != expectedInputSize) {
+        throw ArgumentError(
+          'Input size mismatch: expected $expectedInputSize bytes, got ${input.length}',
         );
+      }
+      return;
+    }
+
+    if (rowStride < rowBytes) {
+      throw ArgumentError(
+        'Row stride too small: expected at least $rowBytes bytes, got $rowStride',
+      );
+    }
+
+    // The last row does not need trailing padding
+    final minInputSize = rowStride * (height - 1) + rowBytes;
+    if (input.length < minInputSize) {
+      throw ArgumentError(
+        'Input size mismatch: expected at least $minInputSize bytes, got ${input.length}',
+      );
     }
   }
 }
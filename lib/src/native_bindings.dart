@@ -1,6 +1,15 @@
 import 'dart:ffi';
 import 'dart:io';
 
+// ============================================================================
+// Argument packing
+// ============================================================================
+
+/// Pack per-axis FILTER_* / EDGE_* values like FILTER_AXES / EDGE_AXES in
+/// resize.h. Without a vertical value the horizontal one applies to both axes.
+int packAxes(int horizontal, int? vertical) =>
+    vertical == null ? horizontal : 0x100 | (vertical << 4) | horizontal;
+
 // ============================================================================
 // C function signatures - Raw pixel resize
 // ============================================================================
@@ -14,11 +23,14 @@ typedef BicubicResizeRgbNative = Int32 Function(
   Int32 outputHeight,
   Int32 filter,
   Int32 edgeMode,
+  Int32 colorSpace,
+  Float reducingGap,
   Float crop,
   Int32 cropAnchor,
   Int32 aspectMode,
   Float aspectW,
   Float aspectH,
+  Int32 numThreads,
 );
 
 typedef BicubicResizeRgbDart = int Function(
@@ -30,11 +42,14 @@ typedef BicubicResizeRgbDart = int Function(
   int outputHeight,
   int filter,
   int edgeMode,
+  int colorSpace,
+  double reducingGap,
   double crop,
   int cropAnchor,
   int aspectMode,
   double aspectW,
   double aspectH,
+  int numThreads,
 );
 
 typedef BicubicResizeRgbaNative = Int32 Function(
@@ -46,11 +61,15 @@ typedef BicubicResizeRgbaNative = Int32 Function(
   Int32 outputHeight,
   Int32 filter,
   Int32 edgeMode,
+  Int32 colorSpace,
+  Int32 alphaMode,
+  Float reducingGap,
   Float crop,
   Int32 cropAnchor,
   Int32 aspectMode,
   Float aspectW,
   Float aspectH,
+  Int32 numThreads,
 );
 
 typedef BicubicResizeRgbaDart = int Function(
@@ -62,13 +81,355 @@ typedef BicubicResizeRgbaDart = int Function(
   int outputHeight,
   int filter,
   int edgeMode,
+  int colorSpace,
+  int alphaMode,
+  double reducingGap,
+  double crop,
+  int cropAnchor,
+  int aspectMode,
+  double aspectW,
+  double aspectH,
+  int numThreads,
+);
+
+typedef BicubicResizeStridedNative = Int32 Function(
+  Pointer<Uint8> input,
+  Int32 inputWidth,
+  Int32 inputHeight,
+  Int32 inputStride,
+  Pointer<Uint8> output,
+  Int32 outputWidth,
+  Int32 outputHeight,
+  Int32 outputStride,
+  Int32 filter,
+  Int32 edgeMode,
+  Int32 colorSpace,
+  Float reducingGap,
+  Float crop,
+  Int32 cropAnchor,
+  Int32 aspectMode,
+  Float aspectW,
+  Float aspectH,
+  Int32 numThreads,
+);
+
+typedef BicubicResizeStridedDart = int Function(
+  Pointer<Uint8> input,
+  int inputWidth,
+  int inputHeight,
+  int inputStride,
+  Pointer<Uint8> output,
+  int outputWidth,
+  int outputHeight,
+  int outputStride,
+  int filter,
+  int edgeMode,
+  int colorSpace,
+  double reducingGap,
+  double crop,
+  int cropAnchor,
+  int aspectMode,
+  double aspectW,
+  double aspectH,
+  int numThreads,
+);
+
+typedef BicubicResizeRgbaStridedNative = Int32 Function(
+  Pointer<Uint8> input,
+  Int32 inputWidth,
+  Int32 inputHeight,
+  Int32 inputStride,
+  Pointer<Uint8> output,
+  Int32 outputWidth,
+  Int32 outputHeight,
+  Int32 outputStride,
+  Int32 filter,
+  Int32 edgeMode,
+  Int32 colorSpace,
+  Int32 alphaMode,
+  Float reducingGap,
+  Float crop,
+  Int32 cropAnchor,
+  Int32 aspectMode,
+  Float aspectW,
+  Float aspectH,
+  Int32 numThreads,
+);
+
+typedef BicubicResizeRgbaStridedDart = int Function(
+  Pointer<Uint8> input,
+  int inputWidth,
+  int inputHeight,
+  int inputStride,
+  Pointer<Uint8> output,
+  int outputWidth,
+  int outputHeight,
+  int outputStride,
+  int filter,
+  int edgeMode,
+  int colorSpace,
+  int alphaMode,
+  double reducingGap,
+  double crop,
+  int cropAnchor,
+  int aspectMode,
+  double aspectW,
+  double aspectH,
+  int numThreads,
+);
+
+typedef BicubicResizeLayoutNative = Int32 Function(
+  Pointer<Uint8> input,
+  Int32 inputWidth,
+  Int32 inputHeight,
+  Int32 inputStride,
+  Int32 inputLayout,
+  Pointer<Uint8> output,
+  Int32 outputWidth,
+  Int32 outputHeight,
+  Int32 outputStride,
+  Int32 outputLayout,
+  Int32 filter,
+  Int32 edgeMode,
+  Int32 colorSpace,
+  Int32 alphaMode,
+  Float reducingGap,
+  Float crop,
+  Int32 cropAnchor,
+  Int32 aspectMode,
+  Float aspectW,
+  Float aspectH,
+  Int32 numThreads,
+);
+
+typedef BicubicResizeLayoutDart = int Function(
+  Pointer<Uint8> input,
+  int inputWidth,
+  int inputHeight,
+  int inputStride,
+  int inputLayout,
+  Pointer<Uint8> output,
+  int outputWidth,
+  int outputHeight,
+  int outputStride,
+  int outputLayout,
+  int filter,
+  int edgeMode,
+  int colorSpace,
+  int alphaMode,
+  double reducingGap,
+  double crop,
+  int cropAnchor,
+  int aspectMode,
+  double aspectW,
+  double aspectH,
+  int numThreads,
+);
+
+typedef BicubicResizeRgbaDropOpaqueAlphaNative = Int32 Function(
+  Pointer<Uint8> input,
+  Int32 inputWidth,
+  Int32 inputHeight,
+  Int32 inputStride,
+  Pointer<Uint8> output,
+  Int32 outputWidth,
+  Int32 outputHeight,
+  Int32 filter,
+  Int32 edgeMode,
+  Int32 colorSpace,
+  Int32 alphaMode,
+  Float reducingGap,
+  Float crop,
+  Int32 cropAnchor,
+  Int32 aspectMode,
+  Float aspectW,
+  Float aspectH,
+  Int32 numThreads,
+  Pointer<Int32> outputChannels,
+);
+
+typedef BicubicResizeRgbaDropOpaqueAlphaDart = int Function(
+  Pointer<Uint8> input,
+  int inputWidth,
+  int inputHeight,
+  int inputStride,
+  Pointer<Uint8> output,
+  int outputWidth,
+  int outputHeight,
+  int filter,
+  int edgeMode,
+  int colorSpace,
+  int alphaMode,
+  double reducingGap,
+  double crop,
+  int cropAnchor,
+  int aspectMode,
+  double aspectW,
+  double aspectH,
+  int numThreads,
+  Pointer<Int32> outputChannels,
+);
+
+typedef BicubicResizeRgbToTensorNative = Int32 Function(
+  Pointer<Uint8> input,
+  Int32 inputWidth,
+  Int32 inputHeight,
+  Int32 inputChannels,
+  Pointer<Float> output,
+  Int32 outputWidth,
+  Int32 outputHeight,
+  Int32 filter,
+  Int32 edgeMode,
+  Int32 colorSpace,
+  Float reducingGap,
+  Float crop,
+  Int32 cropAnchor,
+  Int32 aspectMode,
+  Float aspectW,
+  Float aspectH,
+  Int32 tensorLayout,
+  Int32 channelOrder,
+  Pointer<Float> mean,
+  Pointer<Float> std,
+  Int32 numThreads,
+);
+
+typedef BicubicResizeRgbToTensorDart = int Function(
+  Pointer<Uint8> input,
+  int inputWidth,
+  int inputHeight,
+  int inputChannels,
+  Pointer<Float> output,
+  int outputWidth,
+  int outputHeight,
+  int filter,
+  int edgeMode,
+  int colorSpace,
+  double reducingGap,
+  double crop,
+  int cropAnchor,
+  int aspectMode,
+  double aspectW,
+  double aspectH,
+  int tensorLayout,
+  int channelOrder,
+  Pointer<Float> mean,
+  Pointer<Float> std,
+  int numThreads,
+);
+
+typedef BicubicResizeYuv420Native = Int32 Function(
+  Pointer<Uint8> yPlane,
+  Int32 yRowStride,
+  Pointer<Uint8> uPlane,
+  Pointer<Uint8> vPlane,
+  Int32 uvRowStride,
+  Int32 uvPixelStride,
+  Int32 inputWidth,
+  Int32 inputHeight,
+  Pointer<Uint8> output,
+  Int32 outputWidth,
+  Int32 outputHeight,
+  Int32 outputChannels,
+  Int32 colorMatrix,
+  Int32 chromaSiting,
+  Int32 filter,
+  Int32 edgeMode,
+  Int32 colorSpace,
+  Float crop,
+  Int32 cropAnchor,
+  Int32 aspectMode,
+  Float aspectW,
+  Float aspectH,
+  Int32 numThreads,
+);
+
+typedef BicubicResizeYuv420Dart = int Function(
+  Pointer<Uint8> yPlane,
+  int yRowStride,
+  Pointer<Uint8> uPlane,
+  Pointer<Uint8> vPlane,
+  int uvRowStride,
+  int uvPixelStride,
+  int inputWidth,
+  int inputHeight,
+  Pointer<Uint8> output,
+  int outputWidth,
+  int outputHeight,
+  int outputChannels,
+  int colorMatrix,
+  int chromaSiting,
+  int filter,
+  int edgeMode,
+  int colorSpace,
+  double crop,
+  int cropAnchor,
+  int aspectMode,
+  double aspectW,
+  double aspectH,
+  int numThreads,
+);
+
+// ============================================================================
+// C function signatures - Resize plans
+// ============================================================================
+
+/// Opaque native resize plan (`BicubicPlan*` in resize.h)
+final class BicubicPlanHandle extends Opaque {}
+
+typedef BicubicPlanCreateNative = Pointer<BicubicPlanHandle> Function(
+  Int32 inputWidth,
+  Int32 inputHeight,
+  Int32 channels,
+  Int32 outputWidth,
+  Int32 outputHeight,
+  Int32 filter,
+  Int32 edgeMode,
+  Int32 colorSpace,
+  Int32 alphaMode,
+  Float reducingGap,
+  Float crop,
+  Int32 cropAnchor,
+  Int32 aspectMode,
+  Float aspectW,
+  Float aspectH,
+  Int32 numThreads,
+);
+
+typedef BicubicPlanCreateDart = Pointer<BicubicPlanHandle> Function(
+  int inputWidth,
+  int inputHeight,
+  int channels,
+  int outputWidth,
+  int outputHeight,
+  int filter,
+  int edgeMode,
+  int colorSpace,
+  int alphaMode,
+  double reducingGap,
   double crop,
   int cropAnchor,
   int aspectMode,
   double aspectW,
   double aspectH,
+  int numThreads,
 );
 
+typedef BicubicPlanExecuteNative = Int32 Function(
+  Pointer<BicubicPlanHandle> plan,
+  Pointer<Uint8> input,
+  Pointer<Uint8> output,
+);
+
+typedef BicubicPlanExecuteDart = int Function(
+  Pointer<BicubicPlanHandle> plan,
+  Pointer<Uint8> input,
+  Pointer<Uint8> output,
+);
+
+typedef BicubicPlanDestroyNative = Void Function(Pointer<BicubicPlanHandle> plan);
+typedef BicubicPlanDestroyDart = void Function(Pointer<BicubicPlanHandle> plan);
+
 // ============================================================================
 // C function signatures - JPEG/PNG resize
 // ============================================================================
@@ -79,14 +440,18 @@ typedef BicubicResizeJpegNative = Int32 Function(
   Int32 outputWidth,
   Int32 outputHeight,
   Int32 quality,
+  Int32 chromaSubsampling,
   Int32 filter,
   Int32 edgeMode,
+  Int32 colorSpace,
+  Float reducingGap,
   Float crop,
   Int32 cropAnchor,
   Int32 aspectMode,
   Float aspectW,
   Float aspectH,
   Int32 applyExif,
+  Int32 numThreads,
   Pointer<Pointer<Uint8>> outputData,
   Pointer<Int32> outputSize,
 );
@@ -97,14 +462,18 @@ typedef BicubicResizeJpegDart = int Function(
   int outputWidth,
   int outputHeight,
   int quality,
+  int chromaSubsampling,
   int filter,
   int edgeMode,
+  int colorSpace,
+  double reducingGap,
   double crop,
   int cropAnchor,
   int aspectMode,
   double aspectW,
   double aspectH,
   int applyExif,
+  int numThreads,
   Pointer<Pointer<Uint8>> outputData,
   Pointer<Int32> outputSize,
 );
@@ -116,12 +485,16 @@ typedef BicubicResizePngNative = Int32 Function(
   Int32 outputHeight,
   Int32 filter,
   Int32 edgeMode,
+  Int32 colorSpace,
+  Float reducingGap,
   Float crop,
   Int32 cropAnchor,
   Int32 aspectMode,
   Float aspectW,
   Float aspectH,
   Int32 compressionLevel,
+  Int32 pngFilter,
+  Int32 numThreads,
   Pointer<Pointer<Uint8>> outputData,
   Pointer<Int32> outputSize,
 );
@@ -133,16 +506,423 @@ typedef BicubicResizePngDart = int Function(
   int outputHeight,
   int filter,
   int edgeMode,
+  int colorSpace,
+  double reducingGap,
+  double crop,
+  int cropAnchor,
+  int aspectMode,
+  double aspectW,
+  double aspectH,
+  int compressionLevel,
+  int pngFilter,
+  int numThreads,
+  Pointer<Pointer<Uint8>> outputData,
+  Pointer<Int32> outputSize,
+);
+
+// ============================================================================
+// C function signatures - Batch resize
+// ============================================================================
+
+/// Mirror of `BicubicBatchItem` in resize.h (field order must match)
+final class BicubicBatchItem extends Struct {
+  external Pointer<Uint8> inputData;
+
+  @Int32()
+  external int inputSize;
+
+  @Int32()
+  external int outputWidth;
+
+  @Int32()
+  external int outputHeight;
+
+  @Int32()
+  external int quality;
+
+  @Int32()
+  external int compressionLevel;
+
+  @Int32()
+  external int chromaSubsampling;
+
+  @Int32()
+  external int pngFilter;
+
+  @Int32()
+  external int filter;
+
+  @Int32()
+  external int edgeMode;
+
+  @Int32()
+  external int colorSpace;
+
+  @Float()
+  external double reducingGap;
+
+  @Float()
+  external double crop;
+
+  @Int32()
+  external int cropAnchor;
+
+  @Int32()
+  external int aspectMode;
+
+  @Float()
+  external double aspectW;
+
+  @Float()
+  external double aspectH;
+
+  @Int32()
+  external int applyExif;
+
+  external Pointer<Uint8> outputData;
+
+  @Int32()
+  external int outputSize;
+
+  @Int32()
+  external int result;
+}
+
+typedef BicubicResizeBatchNative = Int32 Function(
+  Pointer<BicubicBatchItem> items,
+  Int32 count,
+  Int32 numThreads,
+);
+
+typedef BicubicResizeBatchDart = int Function(
+  Pointer<BicubicBatchItem> items,
+  int count,
+  int numThreads,
+);
+
+// ============================================================================
+// C function signatures - Multi-rendition resize
+// ============================================================================
+
+/// Mirror of `BicubicOutputSpec` in resize.h (field order must match)
+final class BicubicOutputSpec extends Struct {
+  @Int32()
+  external int outputWidth;
+
+  @Int32()
+  external int outputHeight;
+
+  @Int32()
+  external int format;
+
+  @Int32()
+  external int quality;
+
+  @Int32()
+  external int chromaSubsampling;
+
+  @Int32()
+  external int compressionLevel;
+
+  @Int32()
+  external int pngFilter;
+
+  @Int32()
+  external int filter;
+
+  @Int32()
+  external int edgeMode;
+
+  @Int32()
+  external int colorSpace;
+
+  @Float()
+  external double reducingGap;
+
+  @Float()
+  external double crop;
+
+  @Int32()
+  external int cropAnchor;
+
+  @Int32()
+  external int aspectMode;
+
+  @Float()
+  external double aspectW;
+
+  @Float()
+  external double aspectH;
+
+  external Pointer<Uint8> outputData;
+
+  @Int32()
+  external int outputSize;
+
+  @Int32()
+  external int result;
+}
+
+typedef BicubicResizeMultiNative = Int32 Function(
+  Pointer<Uint8> inputData,
+  Int32 inputSize,
+  Pointer<BicubicOutputSpec> specs,
+  Int32 count,
+  Int32 applyExif,
+  Int32 numThreads,
+);
+
+typedef BicubicResizeMultiDart = int Function(
+  Pointer<Uint8> inputData,
+  int inputSize,
+  Pointer<BicubicOutputSpec> specs,
+  int count,
+  int applyExif,
+  int numThreads,
+);
+
+// ============================================================================
+// C function signatures - Decoded image handles
+// ============================================================================
+
+/// Opaque native decoded image (`BicubicImage*` in resize.h)
+final class BicubicImageHandle extends Opaque {}
+
+typedef BicubicImageCreateNative = Pointer<BicubicImageHandle> Function(
+  Pointer<Uint8> inputData,
+  Int32 inputSize,
+  Int32 applyExif,
+);
+
+typedef BicubicImageCreateDart = Pointer<BicubicImageHandle> Function(
+  Pointer<Uint8> inputData,
+  int inputSize,
+  int applyExif,
+);
+
+typedef BicubicImageInfoNative = Int32 Function(
+  Pointer<BicubicImageHandle> image,
+  Pointer<Int32> width,
+  Pointer<Int32> height,
+  Pointer<Int32> channels,
+);
+
+typedef BicubicImageInfoDart = int Function(
+  Pointer<BicubicImageHandle> image,
+  Pointer<Int32> width,
+  Pointer<Int32> height,
+  Pointer<Int32> channels,
+);
+
+typedef BicubicImageResizeNative = Int32 Function(
+  Pointer<BicubicImageHandle> image,
+  Pointer<Uint8> output,
+  Int32 outputWidth,
+  Int32 outputHeight,
+  Int32 filter,
+  Int32 edgeMode,
+  Int32 colorSpace,
+  Float reducingGap,
+  Float crop,
+  Int32 cropAnchor,
+  Int32 aspectMode,
+  Float aspectW,
+  Float aspectH,
+  Int32 numThreads,
+);
+
+typedef BicubicImageResizeDart = int Function(
+  Pointer<BicubicImageHandle> image,
+  Pointer<Uint8> output,
+  int outputWidth,
+  int outputHeight,
+  int filter,
+  int edgeMode,
+  int colorSpace,
+  double reducingGap,
   double crop,
   int cropAnchor,
   int aspectMode,
   double aspectW,
   double aspectH,
+  int numThreads,
+);
+
+typedef BicubicImageEncodeNative = Int32 Function(
+  Pointer<BicubicImageHandle> image,
+  Int32 outputWidth,
+  Int32 outputHeight,
+  Int32 format,
+  Int32 quality,
+  Int32 chromaSubsampling,
+  Int32 compressionLevel,
+  Int32 pngFilter,
+  Int32 filter,
+  Int32 edgeMode,
+  Int32 colorSpace,
+  Float reducingGap,
+  Float crop,
+  Int32 cropAnchor,
+  Int32 aspectMode,
+  Float aspectW,
+  Float aspectH,
+  Int32 numThreads,
+  Pointer<Pointer<Uint8>> outputData,
+  Pointer<Int32> outputSize,
+);
+
+typedef BicubicImageEncodeDart = int Function(
+  Pointer<BicubicImageHandle> image,
+  int outputWidth,
+  int outputHeight,
+  int format,
+  int quality,
+  int chromaSubsampling,
   int compressionLevel,
+  int pngFilter,
+  int filter,
+  int edgeMode,
+  int colorSpace,
+  double reducingGap,
+  double crop,
+  int cropAnchor,
+  int aspectMode,
+  double aspectW,
+  double aspectH,
+  int numThreads,
   Pointer<Pointer<Uint8>> outputData,
   Pointer<Int32> outputSize,
 );
 
+typedef BicubicImageDestroyNative = Void Function(
+  Pointer<BicubicImageHandle> image,
+);
+typedef BicubicImageDestroyDart = void Function(
+  Pointer<BicubicImageHandle> image,
+);
+
+// ============================================================================
+// C function signatures - Image probing
+// ============================================================================
+
+/// Mirror of `BicubicProbeInfo` in resize.h (field order must match)
+final class BicubicProbeInfo extends Struct {
+  @Int32()
+  external int width;
+
+  @Int32()
+  external int height;
+
+  @Int32()
+  external int channels;
+
+  @Int32()
+  external int bitDepth;
+
+  @Int32()
+  external int orientation;
+
+  @Int32()
+  external int format;
+
+  @Int32()
+  external int progressive;
+
+  @Int32()
+  external int result;
+}
+
+typedef BicubicProbeNative = Int32 Function(
+  Pointer<Uint8> inputData,
+  Int32 inputSize,
+  Pointer<BicubicProbeInfo> info,
+);
+
+typedef BicubicProbeDart = int Function(
+  Pointer<Uint8> inputData,
+  int inputSize,
+  Pointer<BicubicProbeInfo> info,
+);
+
+typedef BicubicProbeBatchNative = Int32 Function(
+  Pointer<Pointer<Uint8>> inputs,
+  Pointer<Int32> inputSizes,
+  Int32 count,
+  Pointer<BicubicProbeInfo> infos,
+);
+
+typedef BicubicProbeBatchDart = int Function(
+  Pointer<Pointer<Uint8>> inputs,
+  Pointer<Int32> inputSizes,
+  int count,
+  Pointer<BicubicProbeInfo> infos,
+);
+
+// ============================================================================
+// C function signatures - Async execution
+// ============================================================================
+
+typedef BicubicAsyncInitNative = Void Function(Pointer<Void> postCObject);
+typedef BicubicAsyncInitDart = void Function(Pointer<Void> postCObject);
+
+typedef BicubicResizeRawAsyncNative = Int32 Function(
+  Pointer<Uint8> input,
+  Int32 inputWidth,
+  Int32 inputHeight,
+  Int32 inputStride,
+  Int32 channels,
+  Int32 outputWidth,
+  Int32 outputHeight,
+  Int32 filter,
+  Int32 edgeMode,
+  Int32 colorSpace,
+  Int32 alphaMode,
+  Float reducingGap,
+  Float crop,
+  Int32 cropAnchor,
+  Int32 aspectMode,
+  Float aspectW,
+  Float aspectH,
+  Int32 numThreads,
+  Int64 port,
+);
+
+typedef BicubicResizeRawAsyncDart = int Function(
+  Pointer<Uint8> input,
+  int inputWidth,
+  int inputHeight,
+  int inputStride,
+  int channels,
+  int outputWidth,
+  int outputHeight,
+  int filter,
+  int edgeMode,
+  int colorSpace,
+  int alphaMode,
+  double reducingGap,
+  double crop,
+  int cropAnchor,
+  int aspectMode,
+  double aspectW,
+  double aspectH,
+  int numThreads,
+  int port,
+);
+
+typedef BicubicResizeBatchAsyncNative = Int32 Function(
+  Pointer<BicubicBatchItem> items,
+  Int32 count,
+  Int32 numThreads,
+  Int64 port,
+);
+
+typedef BicubicResizeBatchAsyncDart = int Function(
+  Pointer<BicubicBatchItem> items,
+  int count,
+  int numThreads,
+  int port,
+);
+
 // ============================================================================
 // C function signatures - Memory management
 // ============================================================================
@@ -150,6 +930,12 @@ typedef BicubicResizePngDart = int Function(
 typedef FreeBufferNative = Void Function(Pointer<Uint8> buffer);
 typedef FreeBufferDart = void Function(Pointer<Uint8> buffer);
 
+typedef BicubicArenaSetLimitNative = Void Function(Int64 maxBytes);
+typedef BicubicArenaSetLimitDart = void Function(int maxBytes);
+
+typedef BicubicArenaTrimNative = Void Function();
+typedef BicubicArenaTrimDart = void Function();
+
 // ============================================================================
 // Native bindings class
 // ============================================================================
@@ -163,13 +949,50 @@ class NativeBindings {
   // Raw pixel resize
   late final BicubicResizeRgbDart bicubicResizeRgb;
   late final BicubicResizeRgbaDart bicubicResizeRgba;
+  late final BicubicResizeStridedDart bicubicResizeRgbStrided;
+  late final BicubicResizeRgbaStridedDart bicubicResizeRgbaStrided;
+  late final BicubicResizeStridedDart bicubicResizeGrayStrided;
+  late final BicubicResizeLayoutDart bicubicResizeLayout;
+  late final BicubicResizeRgbaDropOpaqueAlphaDart
+      bicubicResizeRgbaDropOpaqueAlpha;
+  late final BicubicResizeRgbToTensorDart bicubicResizeRgbToTensor;
+  late final BicubicResizeYuv420Dart bicubicResizeYuv420;
+
+  // Resize plans
+  late final BicubicPlanCreateDart bicubicPlanCreate;
+  late final BicubicPlanExecuteDart bicubicPlanExecute;
+  late final BicubicPlanDestroyDart bicubicPlanDestroy;
 
   // JPEG/PNG resize
   late final BicubicResizeJpegDart bicubicResizeJpeg;
   late final BicubicResizePngDart bicubicResizePng;
 
+  // Batch resize
+  late final BicubicResizeBatchDart bicubicResizeBatch;
+
+  // Multi-rendition resize
+  late final BicubicResizeMultiDart bicubicResizeMulti;
+
+  // Decoded image handles
+  late final BicubicImageCreateDart bicubicImageCreate;
+  late final BicubicImageInfoDart bicubicImageInfo;
+  late final BicubicImageResizeDart bicubicImageResize;
+  late final BicubicImageEncodeDart bicubicImageEncode;
+  late final BicubicImageDestroyDart bicubicImageDestroy;
+
+  // Image probing
+  late final BicubicProbeDart bicubicProbe;
+  late final BicubicProbeBatchDart bicubicProbeBatch;
+
+  // Async execution
+  late final BicubicResizeRawAsyncDart bicubicResizeRawAsync;
+  late final BicubicResizeBatchAsyncDart bicubicResizeBatchAsync;
+
   // Memory management
   late final FreeBufferDart freeBuffer;
+  late final Pointer<NativeFinalizerFunction> freeBufferPointer;
+  late final BicubicArenaSetLimitDart bicubicArenaSetLimit;
+  late final BicubicArenaTrimDart bicubicArenaTrim;
 
   NativeBindings._() {
     _library = _loadLibrary();
@@ -201,6 +1024,53 @@ class NativeBindings {
         .lookup<NativeFunction<BicubicResizeRgbaNative>>('bicubic_resize_rgba')
         .asFunction<BicubicResizeRgbaDart>();
 
+    bicubicResizeRgbStrided = _library
+        .lookup<NativeFunction<BicubicResizeStridedNative>>(
+            'bicubic_resize_rgb_strided')
+        .asFunction<BicubicResizeStridedDart>();
+
+    bicubicResizeRgbaStrided = _library
+        .lookup<NativeFunction<BicubicResizeRgbaStridedNative>>(
+            'bicubic_resize_rgba_strided')
+        .asFunction<BicubicResizeRgbaStridedDart>();
+
+    bicubicResizeGrayStrided = _library
+        .lookup<NativeFunction<BicubicResizeStridedNative>>(
+            'bicubic_resize_gray_strided')
+        .asFunction<BicubicResizeStridedDart>();
+
+    bicubicResizeLayout = _library
+        .lookup<NativeFunction<BicubicResizeLayoutNative>>(
+            'bicubic_resize_layout')
+        .asFunction<BicubicResizeLayoutDart>();
+
+    bicubicResizeRgbaDropOpaqueAlpha = _library
+        .lookup<NativeFunction<BicubicResizeRgbaDropOpaqueAlphaNative>>(
+            'bicubic_resize_rgba_drop_opaque_alpha')
+        .asFunction<BicubicResizeRgbaDropOpaqueAlphaDart>();
+
+    bicubicResizeRgbToTensor = _library
+        .lookup<NativeFunction<BicubicResizeRgbToTensorNative>>(
+            'bicubic_resize_rgb_to_tensor')
+        .asFunction<BicubicResizeRgbToTensorDart>();
+
+    bicubicResizeYuv420 = _library
+        .lookup<NativeFunction<BicubicResizeYuv420Native>>('bicubic_resize_yuv420')
+        .asFunction<BicubicResizeYuv420Dart>();
+
+    // Resize plans
+    bicubicPlanCreate = _library
+        .lookup<NativeFunction<BicubicPlanCreateNative>>('bicubic_plan_create')
+        .asFunction<BicubicPlanCreateDart>();
+
+    bicubicPlanExecute = _library
+        .lookup<NativeFunction<BicubicPlanExecuteNative>>('bicubic_plan_execute')
+        .asFunction<BicubicPlanExecuteDart>();
+
+    bicubicPlanDestroy = _library
+        .lookup<NativeFunction<BicubicPlanDestroyNative>>('bicubic_plan_destroy')
+        .asFunction<BicubicPlanDestroyDart>();
+
     // JPEG/PNG resize
     bicubicResizeJpeg = _library
         .lookup<NativeFunction<BicubicResizeJpegNative>>('bicubic_resize_jpeg')
@@ -210,9 +1080,74 @@ class NativeBindings {
         .lookup<NativeFunction<BicubicResizePngNative>>('bicubic_resize_png')
         .asFunction<BicubicResizePngDart>();
 
+    // Batch resize
+    bicubicResizeBatch = _library
+        .lookup<NativeFunction<BicubicResizeBatchNative>>('bicubic_resize_batch')
+        .asFunction<BicubicResizeBatchDart>();
+
+    // Multi-rendition resize
+    bicubicResizeMulti = _library
+        .lookup<NativeFunction<BicubicResizeMultiNative>>('bicubic_resize_multi')
+        .asFunction<BicubicResizeMultiDart>();
+
+    // Decoded image handles
+    bicubicImageCreate = _library
+        .lookup<NativeFunction<BicubicImageCreateNative>>('bicubic_image_create')
+        .asFunction<BicubicImageCreateDart>();
+
+    bicubicImageInfo = _library
+        .lookup<NativeFunction<BicubicImageInfoNative>>('bicubic_image_info')
+        .asFunction<BicubicImageInfoDart>();
+
+    bicubicImageResize = _library
+        .lookup<NativeFunction<BicubicImageResizeNative>>('bicubic_image_resize')
+        .asFunction<BicubicImageResizeDart>();
+
+    bicubicImageEncode = _library
+        .lookup<NativeFunction<BicubicImageEncodeNative>>('bicubic_image_encode')
+        .asFunction<BicubicImageEncodeDart>();
+
+    bicubicImageDestroy = _library
+        .lookup<NativeFunction<BicubicImageDestroyNative>>(
+          'bicubic_image_destroy',
+        )
+        .asFunction<BicubicImageDestroyDart>();
+
+    // Image probing
+    bicubicProbe = _library
+        .lookup<NativeFunction<BicubicProbeNative>>('bicubic_probe')
+        .asFunction<BicubicProbeDart>();
+
+    bicubicProbeBatch = _library
+        .lookup<NativeFunction<BicubicProbeBatchNative>>('bicubic_probe_batch')
+        .asFunction<BicubicProbeBatchDart>();
+
+    // Async execution: completions are posted with Dart_PostCObject
+    _library
+        .lookup<NativeFunction<BicubicAsyncInitNative>>('bicubic_async_init')
+        .asFunction<BicubicAsyncInitDart>()(NativeApi.postCObject.cast());
+
+    bicubicResizeRawAsync = _library
+        .lookup<NativeFunction<BicubicResizeRawAsyncNative>>('bicubic_resize_raw_async')
+        .asFunction<BicubicResizeRawAsyncDart>();
+
+    bicubicResizeBatchAsync = _library
+        .lookup<NativeFunction<BicubicResizeBatchAsyncNative>>('bicubic_resize_batch_async')
+        .asFunction<BicubicResizeBatchAsyncDart>();
+
     // Memory management
-    freeBuffer = _library
-        .lookup<NativeFunction<FreeBufferNative>>('free_buffer')
-        .asFunction<FreeBufferDart>();
+    final freeBufferSymbol =
+        _library.lookup<NativeFunction<FreeBufferNative>>('free_buffer');
+    freeBuffer = freeBufferSymbol.asFunction<FreeBufferDart>();
+    // Finalizer for native results handed to Dart as external typed data
+    freeBufferPointer = freeBufferSymbol.cast<NativeFinalizerFunction>();
+
+    bicubicArenaSetLimit = _library
+        .lookup<NativeFunction<BicubicArenaSetLimitNative>>('bicubic_arena_set_limit')
+        .asFunction<BicubicArenaSetLimitDart>();
+
+    bicubicArenaTrim = _library
+        .lookup<NativeFunction<BicubicArenaTrimNative>>('bicubic_arena_trim')
+        .asFunction<BicubicArenaTrimDart>();
   }
 }
@@ -10,13 +10,41 @@
 #define STBI_NO_PIC
 #define STBI_NO_PNM
 
+// Clamp float output to 0-1 so tensors match the uint8 pipeline's value range
+// (Catmull-Rom's negative lobes overshoot slightly)
+#define STBIR_FLOAT_LOW_CLAMP  0.0f
+#define STBIR_FLOAT_HIGH_CLAMP 1.0f
+
+// Route every stb allocation through the per-job arenas (see "Job arenas")
+#include <stddef.h>
+static void* arena_malloc(size_t size);
+static void* arena_realloc(void* ptr, size_t size);
+static void arena_free(void* ptr);
+
+#define STBI_MALLOC(sz)                arena_malloc(sz)
+#define STBI_REALLOC(p, newsz)         arena_realloc(p, newsz)
+#define STBI_FREE(p)                   arena_free(p)
+#define STBIW_MALLOC(sz)               arena_malloc(sz)
+#define STBIW_REALLOC(p, newsz)        arena_realloc(p, newsz)
+#define STBIW_FREE(p)                  arena_free(p)
+#define STBIR_MALLOC(size, user_data)  ((void)(user_data), arena_malloc(size))
+#define STBIR_FREE(ptr, user_data)     ((void)(user_data), arena_free(ptr))
+
+// Reentrancy: stb_image keeps its failure reason in thread-local storage and
+// its flip/unpremultiply flags are never set here; encoder settings go through
+// the per-call stbi_write_*_to_func_ex variants instead of the
+// stbi_write_png_compression_level / stbi_write_force_png_filter globals.
+// No stb global is written after load, so concurrent calls need no locking.
 #include "stb_image.h"
 #include "stb_image_write.h"
 #include "stb_image_resize2.h"
 #include "resize.h"
 
+#include <math.h>
 #include <stdlib.h>
 #include <string.h>
+#include <pthread.h>
+#include <unistd.h>
 
 // ============================================================================
 // EXIF Orientation parsing
@@ -145,7 +173,7 @@ static uint8_t* apply_orientation(uint8_t* pixels, int* width, int* height, int
         new_h = w;
     }
 
-    result = (uint8_t*)malloc(new_w * new_h * channels);
+    result = (uint8_t*)arena_malloc(new_w * new_h * channels);
     if (!result) return pixels;
 
     for (int y = 0; y < h; y++) {
@@ -195,7 +223,7 @@ static uint8_t* apply_orientation(uint8_t* pixels, int* width, int* height, int
         }
     }
 
-    free(pixels);
+    arena_free(pixels);
     *width = new_w;
     *height = new_h;
     return result;
@@ -229,6 +257,16 @@ static stbir_edge get_stbir_edge(int edge_mode) {
     }
 }
 
+// ============================================================================
+// Helper: convert color space to the stbir 8-bit pixel datatype
+// ============================================================================
+
+// The sRGB datatype decodes to linear light through stb_image_resize2's
+// lookup table and re-encodes with its SIMD converter; alpha stays linear
+static stbir_datatype get_stbir_datatype(int color_space) {
+    return (color_space == COLOR_SPACE_LINEAR) ? STBIR_TYPE_UINT8_SRGB : STBIR_TYPE_UINT8;
+}
+
 // ============================================================================
 // Helper: calculate crop parameters with anchor and aspect ratio support
 // ============================================================================
@@ -332,385 +370,3644 @@ static void calc_crop(
 // Helper: convert filter enum to stbir filter
 // ============================================================================
 
-static stbir_filter get_stbir_filter(int filter) {
+// Axes scaled by less than this factor count as near-1:1 for FILTER_AUTO
+#define AUTO_NEAR_SCALE 1.25
+
+// scale: output/input size along the axis
+// aligned: the axis starts on a whole input pixel (no sub-pixel shift)
+static stbir_filter get_stbir_filter(int filter, double scale, int aligned) {
     switch (filter) {
         case FILTER_CUBIC_BSPLINE:
             return STBIR_FILTER_CUBICBSPLINE;
         case FILTER_MITCHELL:
             return STBIR_FILTER_MITCHELL;
+        case FILTER_AUTO:
+            // 1:1 is a copy; a near-1:1 axis barely changes, so a 2-tap
+            // triangle replaces the 4-tap (or wider) Catmull-Rom kernel
+            if (scale == 1.0 && aligned) {
+                return STBIR_FILTER_POINT_SAMPLE;
+            }
+            if (scale >= 1.0 / AUTO_NEAR_SCALE && scale <= AUTO_NEAR_SCALE) {
+                return STBIR_FILTER_TRIANGLE;
+            }
+            return STBIR_FILTER_CATMULLROM;
         case FILTER_CATMULL_ROM:
         default:
             return STBIR_FILTER_CATMULLROM;
     }
 }
 
-// ============================================================================
-// Raw pixel data resize functions
-// ============================================================================
-
-FFI_EXPORT int bicubic_resize_rgb(
-    const uint8_t* input,
-    int input_width,
-    int input_height,
-    uint8_t* output,
-    int output_width,
-    int output_height,
-    int filter,
-    int edge_mode,
-    float crop,
-    int crop_anchor,
-    int aspect_mode,
-    float aspect_w,
-    float aspect_h
-) {
-    if (input == NULL || output == NULL) {
-        return -1;
+// Horizontal (vertical = 0) or vertical value of a FILTER_AXES / EDGE_AXES
+// argument; plain values apply to both axes
+static int axis_value(int value, int vertical) {
+    if ((value & AXES_PACKED) == 0) {
+        return value;
     }
-    if (input_width <= 0 || input_height <= 0 || output_width <= 0 || output_height <= 0) {
-        return -1;
+    return vertical ? (value >> 4) & 0xF : value & 0xF;
+}
+
+// Swap the horizontal and vertical parts of a FILTER_AXES / EDGE_AXES
+// argument, for pixels resized before an EXIF transpose (orientations 5-8)
+static int swap_axes(int value) {
+    if ((value & AXES_PACKED) == 0) {
+        return value;
     }
+    return FILTER_AXES(axis_value(value, 1), axis_value(value, 0));
+}
 
-    // Calculate crop region
-    int crop_x, crop_y, crop_width, crop_height;
-    calc_crop(input_width, input_height, crop, crop_anchor, aspect_mode, aspect_w, aspect_h,
-              &crop_x, &crop_y, &crop_width, &crop_height);
+// Set per-axis filters and edge modes on an initialized resize. Must run after
+// any stbir_set_input_subrect call, since FILTER_AUTO depends on the scale.
+static void set_filters_and_edges(STBIR_RESIZE* resize, int filter, int edge_mode) {
+    double span_x = (resize->input_s1 - resize->input_s0) * resize->input_w;
+    double span_y = (resize->input_t1 - resize->input_t0) * resize->input_h;
+    double start_x = resize->input_s0 * resize->input_w;
+    double start_y = resize->input_t0 * resize->input_h;
+
+    stbir_set_edgemodes(resize,
+                        get_stbir_edge(axis_value(edge_mode, 0)),
+                        get_stbir_edge(axis_value(edge_mode, 1)));
+    stbir_set_filters(resize,
+                      get_stbir_filter(axis_value(filter, 0), resize->output_w / span_x,
+                                       start_x == (int)start_x),
+                      get_stbir_filter(axis_value(filter, 1), resize->output_h / span_y,
+                                       start_y == (int)start_y));
+}
 
-    // Get pointer to start of cropped region
-    const uint8_t* crop_start = input + (crop_y * input_width + crop_x) * 3;
+// ============================================================================
+// Worker thread pool
+// ============================================================================
 
-    stbir_resize(
-        crop_start,
-        crop_width,
-        crop_height,
-        input_width * 3,  // Original stride (not cropped width)
-        output,
-        output_width,
-        output_height,
-        output_width * 3,
-        STBIR_RGB,
-        STBIR_TYPE_UINT8,
-        get_stbir_edge(edge_mode),
-        get_stbir_filter(filter)
-    );
+// Upper bound on worker threads (including the calling thread)
+#define MAX_THREADS 16
+
+// A parallel job: `count` independent tasks, each run as fn(ctx, index).
+// Jobs live on the caller's stack; the caller also executes tasks itself, so
+// nested jobs (a task that starts another job) never deadlock the pool.
+typedef struct ParallelJob {
+    void (*fn)(void* ctx, int index);
+    void* ctx;
+    int count;
+    int next;         // next unclaimed task index
+    int finished;     // number of completed tasks
+    int helpers;      // pool workers currently attached to this job
+    int max_helpers;  // pool workers allowed to attach
+    struct ParallelJob* next_job;
+} ParallelJob;
+
+static pthread_once_t pool_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t pool_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t pool_work_cond = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t pool_done_cond = PTHREAD_COND_INITIALIZER;
+static ParallelJob* pool_jobs = NULL;
+static int pool_workers = 0;
+
+static int cpu_count(void) {
+    long n = sysconf(_SC_NPROCESSORS_ONLN);
+    if (n < 1) return 1;
+    if (n > MAX_THREADS) return MAX_THREADS;
+    return (int)n;
+}
 
-    return 0;
+// Resolve a caller-supplied thread count: 0 (or negative) = one per CPU core
+static int resolve_threads(int num_threads) {
+    if (num_threads <= 0) return cpu_count();
+    if (num_threads > MAX_THREADS) return MAX_THREADS;
+    return num_threads;
 }
 
-FFI_EXPORT int bicubic_resize_rgba(
-    const uint8_t* input,
-    int input_width,
-    int input_height,
-    uint8_t* output,
-    int output_width,
-    int output_height,
-    int filter,
-    int edge_mode,
-    float crop,
-    int crop_anchor,
-    int aspect_mode,
-    float aspect_w,
-    float aspect_h
-) {
-    if (input == NULL || output == NULL) {
-        return -1;
+// Remove a job whose tasks have all been claimed (pool_mutex held)
+static void pool_unlink_job(ParallelJob* job) {
+    ParallelJob** link = &pool_jobs;
+    while (*link != NULL) {
+        if (*link == job) {
+            *link = job->next_job;
+            return;
+        }
+        link = &(*link)->next_job;
     }
-    if (input_width <= 0 || input_height <= 0 || output_width <= 0 || output_height <= 0) {
-        return -1;
+}
+
+// Claim the next task index of a job, or -1 if none are left (pool_mutex held)
+static int pool_claim_task(ParallelJob* job) {
+    if (job->next >= job->count) return -1;
+    int index = job->next++;
+    if (job->next >= job->count) pool_unlink_job(job);
+    return index;
+}
+
+static void pool_finish_task(ParallelJob* job) {
+    job->finished++;
+    if (job->finished == job->count) {
+        pthread_cond_broadcast(&pool_done_cond);
     }
+}
 
-    // Calculate crop region
-    int crop_x, crop_y, crop_width, crop_height;
-    calc_crop(input_width, input_height, crop, crop_anchor, aspect_mode, aspect_w, aspect_h,
-              &crop_x, &crop_y, &crop_width, &crop_height);
+static void* pool_worker_main(void* arg) {
+    (void)arg;
+    pthread_mutex_lock(&pool_mutex);
+    for (;;) {
+        // Find a job that still has work and room for another helper
+        ParallelJob* job = pool_jobs;
+        while (job != NULL && job->helpers >= job->max_helpers) {
+            job = job->next_job;
+        }
+        if (job == NULL) {
+            pthread_cond_wait(&pool_work_cond, &pool_mutex);
+            continue;
+        }
 
-    // Get pointer to start of cropped region
-    const uint8_t* crop_start = input + (crop_y * input_width + crop_x) * 4;
+        job->helpers++;
+        int index;
+        while ((index = pool_claim_task(job)) >= 0) {
+            pthread_mutex_unlock(&pool_mutex);
+            job->fn(job->ctx, index);
+            pthread_mutex_lock(&pool_mutex);
+            pool_finish_task(job);
+        }
+        job->helpers--;
+    }
+    return NULL;
+}
 
-    stbir_resize(
-        crop_start,
-        crop_width,
-        crop_height,
-        input_width * 4,  // Original stride (not cropped width)
-        output,
-        output_width,
-        output_height,
-        output_width * 4,
-        STBIR_RGBA,
-        STBIR_TYPE_UINT8,
-        get_stbir_edge(edge_mode),
-        get_stbir_filter(filter)
-    );
+static void pool_start(void) {
+    int workers = cpu_count() - 1;  // The calling thread is the remaining one
 
-    return 0;
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    for (int i = 0; i < workers; i++) {
+        pthread_t thread;
+        if (pthread_create(&thread, &attr, pool_worker_main, NULL) != 0) break;
+        pool_workers++;
+    }
+    pthread_attr_destroy(&attr);
 }
 
-// ============================================================================
-// Helper for stbi_write to memory
-// ============================================================================
+// Run fn(ctx, 0..count-1) on up to max_threads threads (0 = auto) and wait
+static void parallel_for(int count, int max_threads, void (*fn)(void* ctx, int index), void* ctx) {
+    if (count <= 0) return;
 
-typedef struct {
-    uint8_t* data;
-    int size;
-    int capacity;
-} WriteContext;
+    max_threads = resolve_threads(max_threads);
+    if (max_threads > count) max_threads = count;
 
-static void write_func(void* context, void* data, int size) {
-    WriteContext* ctx = (WriteContext*)context;
+    if (max_threads > 1) {
+        pthread_once(&pool_once, pool_start);
+    }
+    if (max_threads <= 1 || pool_workers == 0) {
+        for (int i = 0; i < count; i++) {
+            fn(ctx, i);
+        }
+        return;
+    }
 
-    // Grow buffer if needed
-    while (ctx->size + size > ctx->capacity) {
-        ctx->capacity = ctx->capacity * 2;
-        ctx->data = (uint8_t*)realloc(ctx->data, ctx->capacity);
+    ParallelJob job;
+    job.fn = fn;
+    job.ctx = ctx;
+    job.count = count;
+    job.next = 0;
+    job.finished = 0;
+    job.helpers = 0;
+    job.max_helpers = max_threads - 1;
+
+    pthread_mutex_lock(&pool_mutex);
+    job.next_job = pool_jobs;
+    pool_jobs = &job;
+    pthread_cond_broadcast(&pool_work_cond);
+
+    // The calling thread works on its own job too
+    int index;
+    while ((index = pool_claim_task(&job)) >= 0) {
+        pthread_mutex_unlock(&pool_mutex);
+        fn(ctx, index);
+        pthread_mutex_lock(&pool_mutex);
+        pool_finish_task(&job);
     }
 
-    memcpy(ctx->data + ctx->size, data, size);
-    ctx->size += size;
+    while (job.finished < job.count) {
+        pthread_cond_wait(&pool_done_cond, &pool_mutex);
+    }
+    pthread_mutex_unlock(&pool_mutex);
 }
 
 // ============================================================================
-// JPEG resize
+// Job arenas: pooled bump allocators for the scratch memory of one resize
 // ============================================================================
 
-FFI_EXPORT int bicubic_resize_jpeg(
-    const uint8_t* input_data,
-    int input_size,
-    int output_width,
-    int output_height,
-    int quality,
-    int filter,
-    int edge_mode,
-    float crop,
-    int crop_anchor,
-    int aspect_mode,
-    float aspect_w,
-    float aspect_h,
-    int apply_exif,
-    uint8_t** output_data,
-    int* output_size
-) {
-    if (input_data == NULL || output_data == NULL || output_size == NULL) {
-        return -1;
+// A resize job (decode, resample, encode) binds an arena to its thread and
+// every scratch allocation made on that thread - including stb_image,
+// stb_image_resize2 and stb_image_write internals - is carved from it. Frees
+// are no-ops (except for the most recent block), and the whole arena is
+// recycled when the job ends. Arenas go back to a pool whose retained size is
+// bounded by bicubic_arena_set_limit(), so steady-state jobs reuse the same
+// region instead of making fresh large heap allocations every call.
+// Buffers handed back to the caller are always plain malloc().
+
+#define ARENA_ALIGN 16
+#define ARENA_MIN_CHUNK (1024 * 1024)
+#define ARENA_DEFAULT_LIMIT (64LL * 1024 * 1024)
+
+// Each block is preceded by a header holding its size
+#define ARENA_HEADER ARENA_ALIGN
+#define ARENA_ROUND(n) (((n) + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1))
+
+typedef struct ArenaChunk {
+    struct ArenaChunk* next;
+    size_t size;   // usable bytes
+    size_t used;
+    size_t last;   // offset of the most recent block's header
+} ArenaChunk;
+
+#define ARENA_CHUNK_HEADER ARENA_ROUND(sizeof(ArenaChunk))
+
+typedef struct JobArena {
+    struct JobArena* next;  // pool link
+    ArenaChunk* chunks;     // head is the chunk being filled
+    size_t capacity;        // sum of chunk sizes
+} JobArena;
+
+static pthread_mutex_t arena_mutex = PTHREAD_MUTEX_INITIALIZER;
+static JobArena* arena_pool = NULL;
+static int64_t arena_pool_bytes = 0;
+static int64_t arena_limit = ARENA_DEFAULT_LIMIT;
+
+// Arena bound to the current thread by arena_begin(), NULL = plain malloc
+static __thread JobArena* current_arena = NULL;
+
+static uint8_t* chunk_data(ArenaChunk* chunk) {
+    return (uint8_t*)chunk + ARENA_CHUNK_HEADER;
+}
+
+static ArenaChunk* arena_new_chunk(JobArena* arena, size_t size) {
+    ArenaChunk* chunk = (ArenaChunk*)malloc(ARENA_CHUNK_HEADER + size);
+    if (chunk == NULL) return NULL;
+    chunk->size = size;
+    chunk->used = 0;
+    chunk->last = 0;
+    chunk->next = arena->chunks;
+    arena->chunks = chunk;
+    arena->capacity += size;
+    return chunk;
+}
+
+static void arena_free_chunks(JobArena* arena) {
+    ArenaChunk* chunk = arena->chunks;
+    while (chunk != NULL) {
+        ArenaChunk* next = chunk->next;
+        free(chunk);
+        chunk = next;
     }
-    if (input_size <= 0 || output_width <= 0 || output_height <= 0) {
-        return -1;
+    arena->chunks = NULL;
+    arena->capacity = 0;
+}
+
+// Chunk of the current arena containing ptr, or NULL
+static ArenaChunk* arena_owner(JobArena* arena, const void* ptr) {
+    for (ArenaChunk* chunk = arena->chunks; chunk != NULL; chunk = chunk->next) {
+        const uint8_t* data = chunk_data(chunk);
+        if ((const uint8_t*)ptr >= data && (const uint8_t*)ptr < data + chunk->used) {
+            return chunk;
+        }
     }
-    if (quality < 1) quality = 1;
-    if (quality > 100) quality = 100;
+    return NULL;
+}
 
-    // Parse EXIF orientation before decoding (if enabled)
-    int orientation = 1;  // Default: no transformation
-    if (apply_exif) {
-        orientation = parse_exif_orientation(input_data, input_size);
+static void* arena_alloc_from(JobArena* arena, size_t size) {
+    size_t need = ARENA_HEADER + ARENA_ROUND(size);
+    ArenaChunk* chunk = arena->chunks;
+
+    if (chunk == NULL || chunk->size - chunk->used < need) {
+        // Grow geometrically so a job settles into a few chunks
+        size_t chunk_size = arena->capacity > ARENA_MIN_CHUNK ? arena->capacity : ARENA_MIN_CHUNK;
+        if (chunk_size < need) chunk_size = need;
+        chunk = arena_new_chunk(arena, chunk_size);
+        if (chunk == NULL) return NULL;
     }
 
-    // Decode JPEG
-    int src_width, src_height, src_channels;
-    uint8_t* src_pixels = stbi_load_from_memory(
-        input_data, input_size,
-        &src_width, &src_height, &src_channels,
-        3  // Force RGB output
-    );
+    uint8_t* block = chunk_data(chunk) + chunk->used;
+    *(size_t*)block = size;
+    chunk->last = chunk->used;
+    chunk->used += need;
+    return block + ARENA_HEADER;
+}
 
-    if (src_pixels == NULL) {
-        return -1;
+static void* arena_malloc(size_t size) {
+    if (current_arena == NULL) return malloc(size);
+    return arena_alloc_from(current_arena, size);
+}
+
+static void arena_free(void* ptr) {
+    if (ptr == NULL) return;
+
+    JobArena* arena = current_arena;
+    ArenaChunk* chunk = arena ? arena_owner(arena, ptr) : NULL;
+    if (chunk == NULL) {
+        free(ptr);
+        return;
     }
 
-    // Apply EXIF orientation (may swap width/height for 90/270 degree rotations)
-    if (apply_exif) {
-        src_pixels = apply_orientation(src_pixels, &src_width, &src_height, 3, orientation);
+    // Only the most recent block can be handed back; the rest waits for reset
+    uint8_t* block = (uint8_t*)ptr - ARENA_HEADER;
+    if (chunk == arena->chunks && block == chunk_data(chunk) + chunk->last) {
+        chunk->used = chunk->last;
     }
+}
 
-    // Calculate crop region
-    int crop_x, crop_y, crop_width, crop_height;
-    calc_crop(src_width, src_height, crop, crop_anchor, aspect_mode, aspect_w, aspect_h,
-              &crop_x, &crop_y, &crop_width, &crop_height);
+static void* arena_realloc(void* ptr, size_t size) {
+    if (ptr == NULL) return arena_malloc(size);
 
-    // Get pointer to start of cropped region
-    const uint8_t* crop_start = src_pixels + (crop_y * src_width + crop_x) * 3;
+    JobArena* arena = current_arena;
+    ArenaChunk* chunk = arena ? arena_owner(arena, ptr) : NULL;
+    if (chunk == NULL) return realloc(ptr, size);
 
-    // Allocate output pixel buffer
-    uint8_t* dst_pixels = (uint8_t*)malloc(output_width * output_height * 3);
-    if (dst_pixels == NULL) {
-        free(src_pixels);
-        return -1;
+    uint8_t* block = (uint8_t*)ptr - ARENA_HEADER;
+    size_t old_size = *(size_t*)block;
+
+    // The most recent block grows in place while the chunk has room
+    if (chunk == arena->chunks && block == chunk_data(chunk) + chunk->last) {
+        size_t need = ARENA_HEADER + ARENA_ROUND(size);
+        if (chunk->last + need <= chunk->size) {
+            *(size_t*)block = size;
+            chunk->used = chunk->last + need;
+            return ptr;
+        }
     }
 
-    // Resize using selected filter (from cropped region)
-    stbir_resize(
-        crop_start,
-        crop_width,
-        crop_height,
-        src_width * 3,  // Original stride
-        dst_pixels,
-        output_width,
-        output_height,
-        output_width * 3,
-        STBIR_RGB,
-        STBIR_TYPE_UINT8,
-        get_stbir_edge(edge_mode),
-        get_stbir_filter(filter)
-    );
+    void* result = arena_alloc_from(arena, size);
+    if (result != NULL) {
+        memcpy(result, ptr, old_size < size ? old_size : size);
+    }
+    return result;
+}
 
-    free(src_pixels);
+static JobArena* arena_acquire(void) {
+    JobArena* arena = NULL;
 
-    // Encode to JPEG
-    WriteContext ctx;
-    ctx.capacity = output_width * output_height * 3;  // Initial estimate
-    ctx.size = 0;
-    ctx.data = (uint8_t*)malloc(ctx.capacity);
+    pthread_mutex_lock(&arena_mutex);
+    if (arena_limit <= 0) {
+        pthread_mutex_unlock(&arena_mutex);
+        return NULL;
+    }
+    if (arena_pool != NULL) {
+        arena = arena_pool;
+        arena_pool = arena->next;
+        arena_pool_bytes -= (int64_t)arena->capacity;
+    }
+    pthread_mutex_unlock(&arena_mutex);
 
-    if (ctx.data == NULL) {
-        free(dst_pixels);
-        return -1;
+    if (arena == NULL) {
+        arena = (JobArena*)calloc(1, sizeof(JobArena));
     }
+    return arena;
+}
 
-    int result = stbi_write_jpg_to_func(
-        write_func, &ctx,
-        output_width, output_height, 3,
-        dst_pixels, quality
-    );
+static void arena_release(JobArena* arena) {
+    // Merge a job's chunks into one region sized for the whole job, so the
+    // next job on this arena needs no further allocation
+    size_t capacity = arena->capacity;
+    if (arena->chunks != NULL && arena->chunks->next != NULL) {
+        arena_free_chunks(arena);
+        arena_new_chunk(arena, capacity);
+    }
+    if (arena->chunks != NULL) {
+        arena->chunks->used = 0;
+        arena->chunks->last = 0;
+    }
 
-    free(dst_pixels);
+    pthread_mutex_lock(&arena_mutex);
+    if (arena_pool_bytes + (int64_t)arena->capacity <= arena_limit) {
+        arena->next = arena_pool;
+        arena_pool = arena;
+        arena_pool_bytes += (int64_t)arena->capacity;
+        arena = NULL;
+    }
+    pthread_mutex_unlock(&arena_mutex);
 
-    if (result == 0) {
-        free(ctx.data);
-        return -1;
+    if (arena != NULL) {
+        arena_free_chunks(arena);
+        free(arena);
     }
+}
 
-    // Shrink buffer to actual size
-    *output_data = (uint8_t*)realloc(ctx.data, ctx.size);
-    *output_size = ctx.size;
+// Bind a pooled arena to this thread for the duration of a job. Nested jobs
+// share the outer arena. Returns the arena to pass to arena_end (NULL if
+// this call does not own one).
+static JobArena* arena_begin(void) {
+    if (current_arena != NULL) return NULL;
+    current_arena = arena_acquire();
+    return current_arena;
+}
 
-    return 0;
+static void arena_end(JobArena* owned) {
+    if (owned == NULL) return;
+    current_arena = NULL;
+    arena_release(owned);
 }
 
-// ============================================================================
-// PNG resize
-// ============================================================================
+FFI_EXPORT void bicubic_arena_set_limit(int64_t max_bytes) {
+    pthread_mutex_lock(&arena_mutex);
+    arena_limit = max_bytes;
+    pthread_mutex_unlock(&arena_mutex);
 
-// External variable from stb_image_write for PNG compression level
-extern int stbi_write_png_compression_level;
+    bicubic_arena_trim();
+}
 
-FFI_EXPORT int bicubic_resize_png(
-    const uint8_t* input_data,
-    int input_size,
-    int output_width,
-    int output_height,
-    int filter,
-    int edge_mode,
-    float crop,
-    int crop_anchor,
-    int aspect_mode,
-    float aspect_w,
-    float aspect_h,
-    int compression_level,
-    uint8_t** output_data,
-    int* output_size
-) {
-    if (input_data == NULL || output_data == NULL || output_size == NULL) {
-        return -1;
-    }
-    if (input_size <= 0 || output_width <= 0 || output_height <= 0) {
-        return -1;
+FFI_EXPORT void bicubic_arena_trim(void) {
+    pthread_mutex_lock(&arena_mutex);
+    JobArena* arena = arena_pool;
+    arena_pool = NULL;
+    arena_pool_bytes = 0;
+    pthread_mutex_unlock(&arena_mutex);
+
+    while (arena != NULL) {
+        JobArena* next = arena->next;
+        arena_free_chunks(arena);
+        free(arena);
+        arena = next;
     }
+}
 
-    // Clamp compression level to valid range (0-9)
-    if (compression_level < 0) compression_level = 0;
-    if (compression_level > 9) compression_level = 9;
-
-    // Decode PNG (preserve alpha if present)
-    int src_width, src_height, src_channels;
-    uint8_t* src_pixels = stbi_load_from_memory(
-        input_data, input_size,
-        &src_width, &src_height, &src_channels,
-        0  // Keep original channels
-    );
+// ============================================================================
+// Helper: box pre-shrink for extreme downscale ratios (reducing gap)
+// ============================================================================
 
-    if (src_pixels == NULL) {
-        return -1;
-    }
+// With a reducing gap, the input is first averaged over whole blocks of
+// factor_x * factor_y pixels, down to about reducing_gap times the output
+// size, and the bicubic filter resamples only the rest (like Pillow's
+// reducing_gap). Otherwise a 125x downscale runs a ~500-tap kernel per output
+// pixel; the box pass is a plain running sum over each source byte.
 
-    // Use 4 channels (RGBA) for PNG to preserve transparency
-    int channels = (src_channels >= 4) ? 4 : 3;
+// Keeps the 16-bit column sums of 8-bit samples from overflowing
+#define MAX_REDUCE_FACTOR 256
 
-    // If we need to convert to RGBA
-    if (src_channels != channels) {
-        // Reload with desired channel count
-        stbi_image_free(src_pixels);
-        src_pixels = stbi_load_from_memory(
-            input_data, input_size,
-            &src_width, &src_height, &src_channels,
-            channels
-        );
-        if (src_pixels == NULL) {
+typedef struct {
+    int factor_x;
+    int factor_y;
+    int source_width;   // region being reduced
+    int source_height;
+    int width;          // reduced size (a partial last block averages fewer pixels)
+    int height;
+    int channels;
+    int alpha;          // alpha channel index, -1 = none
+    int weighted;       // straight alpha: average color weighted by alpha
+    int linear;         // average sRGB color in linear light
+    float decode[256];  // byte -> averaged color value (float path)
+} BoxReduce;
+
+// Alpha channel index of a stbir pixel layout, -1 if it has none
+static int layout_alpha_index(stbir_pixel_layout layout) {
+    switch (layout) {
+        case STBIR_RGBA: case STBIR_BGRA: case STBIR_RGBA_PM: case STBIR_BGRA_PM:
+            return 3;
+        case STBIR_RA: case STBIR_RA_PM:
+            return 1;
+        case STBIR_ARGB: case STBIR_ABGR: case STBIR_AR:
+        case STBIR_ARGB_PM: case STBIR_ABGR_PM: case STBIR_AR_PM:
+            return 0;
+        default:
             return -1;
-        }
     }
+}
 
-    // Calculate crop region
+// Integer box factor for one axis: the largest that keeps the reduced size at
+// or above output_size * reducing_gap (1 = leave the axis alone)
+static int reduce_factor(int input_size, int output_size, float reducing_gap) {
+    double factor = input_size / ((double)output_size * reducing_gap);
+    if (factor < 2.0) return 1;
+    if (factor > MAX_REDUCE_FACTOR) return MAX_REDUCE_FACTOR;
+    return (int)factor;
+}
+
+// Plan the box pass for resizing an input_width x input_height region of
+// 8-bit pixels to output_width x output_height. reducing_gap < 1 disables it.
+// Returns 1 if at least one axis is reduced, 0 otherwise
+static int box_reduce_init(
+    BoxReduce* box, int input_width, int input_height,
+    int output_width, int output_height,
+    stbir_pixel_layout layout, stbir_datatype type, float reducing_gap
+) {
+    if (reducing_gap < 1.0f || (type != STBIR_TYPE_UINT8 && type != STBIR_TYPE_UINT8_SRGB)) {
+        return 0;
+    }
+
+    box->factor_x = reduce_factor(input_width, output_width, reducing_gap);
+    box->factor_y = reduce_factor(input_height, output_height, reducing_gap);
+    if (box->factor_x == 1 && box->factor_y == 1) {
+        return 0;
+    }
+
+    box->source_width = input_width;
+    box->source_height = input_height;
+    box->width = (input_width + box->factor_x - 1) / box->factor_x;
+    box->height = (input_height + box->factor_y - 1) / box->factor_y;
+    box->channels = stbir__pixel_channels[stbir__pixel_layout_convert_public_to_internal[layout]];
+    box->alpha = layout_alpha_index(layout);
+    // Only straight alpha is weighted; 4CHANNEL and 2CHANNEL have no alpha
+    // and premultiplied layouts already carry the weighting in their color
+    box->weighted = box->alpha >= 0 && layout < STBIR_RGBA_PM;
+    box->linear = type == STBIR_TYPE_UINT8_SRGB;
+    for (int i = 0; i < 256; i++) {
+        box->decode[i] = box->linear ? stbir__srgb_uchar_to_linear_float[i] : i * (1.0f / 255.0f);
+    }
+    return 1;
+}
+
+// Column sums of 8-bit rows. restrict lets the compiler vectorize these
+// without runtime overlap checks.
+static void box_sum_rows(uint16_t* restrict sum, const uint8_t* restrict row, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        sum[i] += row[i];
+    }
+}
+
+static void box_sum_decoded_rows(float* restrict sum, const uint8_t* restrict row,
+                                 const float* restrict decode, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        sum[i] += decode[row[i]];
+    }
+}
+
+// Average fx-column blocks of the 16-bit column sums into output pixels,
+// dividing by the block size as a 32.32 fixed-point multiply. Called with a
+// constant ch so the inlined per-pixel channel loop unrolls.
+static inline void box_average_columns(
+    const BoxReduce* box, const uint16_t* sum, int row_count, int ch, uint8_t* output
+) {
+    int fx = box->factor_x;
+    int full = box->source_width / fx;
+    uint64_t scale = ((1ULL << 32) + (uint64_t)(fx * row_count) / 2) / (uint64_t)(fx * row_count);
+
+    for (int x = 0; x < full; x++, sum += fx * ch, output += ch) {
+        uint32_t totals[4] = { 0, 0, 0, 0 };
+        for (int k = 0; k < fx; k++) {
+            for (int c = 0; c < ch; c++) {
+                totals[c] += sum[k * ch + c];
+            }
+        }
+        for (int c = 0; c < ch; c++) {
+            output[c] = (uint8_t)((totals[c] * scale + (1ULL << 31)) >> 32);
+        }
+    }
+
+    // Partial last block
+    int cols = box->source_width - full * fx;
+    if (cols > 0) {
+        scale = ((1ULL << 32) + (uint64_t)(cols * row_count) / 2) / (uint64_t)(cols * row_count);
+        for (int c = 0; c < ch; c++) {
+            uint32_t total = 0;
+            for (int k = 0; k < cols; k++) {
+                total += sum[k * ch + c];
+            }
+            output[c] = (uint8_t)((total * scale + (1ULL << 31)) >> 32);
+        }
+    }
+}
+
+// Straight-alpha block average in integers: color * alpha and alpha summed
+// per column down the rows, then color = sum(color * alpha) / sum(alpha) over
+// each block (black where the block is fully transparent). With blocks of at
+// most 256 x 256 pixels the 32-bit sums cannot overflow. Called with constant
+// ch and alpha so the inlined channel loops unroll.
+static inline void box_reduce_weighted_row(
+    const BoxReduce* box, const uint8_t* const* rows, int row_count,
+    uint32_t* restrict sum, int ch, int alpha, uint8_t* output
+) {
+    int fx = box->factor_x;
+    memset(sum, 0, (size_t)box->source_width * ch * sizeof(uint32_t));
+    for (int r = 0; r < row_count; r++) {
+        const uint8_t* restrict p = rows[r];
+        uint32_t* restrict s = sum;
+        for (int x = 0; x < box->source_width; x++, p += ch, s += ch) {
+            uint32_t a = p[alpha];
+            for (int c = 0; c < ch; c++) {
+                s[c] += (c == alpha) ? a : p[c] * a;
+            }
+        }
+    }
+
+    for (int x0 = 0; x0 < box->source_width; x0 += fx, sum += fx * ch, output += ch) {
+        int cols = box->source_width - x0 < fx ? box->source_width - x0 : fx;
+        uint32_t count = (uint32_t)(cols * row_count);
+        uint32_t totals[4] = { 0, 0, 0, 0 };
+        for (int k = 0; k < cols; k++) {
+            for (int c = 0; c < ch; c++) {
+                totals[c] += sum[k * ch + c];
+            }
+        }
+
+        uint32_t weight = totals[alpha];
+        for (int c = 0; c < ch; c++) {
+            if (c == alpha) {
+                output[c] = (uint8_t)((weight + count / 2) / count);
+            } else {
+                output[c] = (uint8_t)(weight > 0 ? (totals[c] + weight / 2) / weight : 0);
+            }
+        }
+    }
+}
+
+// Average row_count source rows (each pointing at the region's first pixel)
+// into one reduced row. acc has room for source_width * channels 32-bit sums.
+static void box_reduce_row(
+    const BoxReduce* box, const uint8_t* const* rows, int row_count,
+    void* acc, uint8_t* output
+) {
+    int ch = box->channels;
+    int fx = box->factor_x;
+    size_t samples = (size_t)box->source_width * ch;
+
+    // Gamma-space color without alpha weighting: 16-bit integer sums
+    if (!box->weighted && !box->linear) {
+        uint16_t* sum = (uint16_t*)acc;
+        memset(sum, 0, samples * sizeof(uint16_t));
+        for (int r = 0; r < row_count; r++) {
+            box_sum_rows(sum, rows[r], samples);
+        }
+
+        switch (ch) {
+            case 1: box_average_columns(box, sum, row_count, 1, output); break;
+            case 2: box_average_columns(box, sum, row_count, 2, output); break;
+            case 3: box_average_columns(box, sum, row_count, 3, output); break;
+            default: box_average_columns(box, sum, row_count, 4, output); break;
+        }
+        return;
+    }
+
+    // Gamma-space color weighted by straight alpha: 32-bit integer sums
+    if (!box->linear) {
+        uint32_t* sum = (uint32_t*)acc;
+        if (ch == 4) {
+            if (box->alpha == 3) box_reduce_weighted_row(box, rows, row_count, sum, 4, 3, output);
+            else box_reduce_weighted_row(box, rows, row_count, sum, 4, 0, output);
+        } else {
+            if (box->alpha == 1) box_reduce_weighted_row(box, rows, row_count, sum, 2, 1, output);
+            else box_reduce_weighted_row(box, rows, row_count, sum, 2, 0, output);
+        }
+        return;
+    }
+
+    // Linear light (optionally alpha weighted): float sums of decoded
+    // samples, matching what the resampler itself averages
+    float* sum = (float*)acc;
+    int alpha = box->alpha;
+    memset(sum, 0, samples * sizeof(float));
+    for (int r = 0; r < row_count; r++) {
+        const uint8_t* p = rows[r];
+        if (!box->weighted) {
+            box_sum_decoded_rows(sum, p, box->decode, samples);
+            continue;
+        }
+
+        float* s = sum;
+        for (int x = 0; x < box->source_width; x++, p += ch, s += ch) {
+            float weight = p[alpha] * (1.0f / 255.0f);
+            for (int c = 0; c < ch; c++) {
+                s[c] += (c == alpha) ? weight : box->decode[p[c]] * weight;
+            }
+        }
+    }
+
+    for (int x = 0; x < box->width; x++) {
+        int x0 = x * fx;
+        int cols = box->source_width - x0 < fx ? box->source_width - x0 : fx;
+        float count = (float)(cols * row_count);
+        const float* block = sum + (size_t)x0 * ch;
+
+        float totals[4];
+        for (int c = 0; c < ch; c++) {
+            totals[c] = 0.0f;
+            for (int k = 0; k < cols; k++) {
+                totals[c] += block[k * ch + c];
+            }
+        }
+
+        for (int c = 0; c < ch; c++) {
+            float v;
+            if (c != alpha && box->weighted) {
+                // Fully transparent blocks have no color; keep them black
+                v = totals[alpha] > 0.0f ? totals[c] / totals[alpha] : 0.0f;
+            } else {
+                v = totals[c] / count;
+            }
+
+            if (c != alpha && box->linear) {
+                output[x * ch + c] = stbir__linear_to_srgb_uchar(v);
+            } else {
+                v = v * 255.0f + 0.5f;
+                output[x * ch + c] = (uint8_t)(v < 0.0f ? 0.0f : (v > 255.0f ? 255.0f : v));
+            }
+        }
+    }
+}
+
+typedef struct {
+    const BoxReduce* box;
+    const uint8_t* input;
+    int input_stride;
+    uint8_t* output;
+    uint8_t* acc;       // one accumulator row per band
+    size_t acc_bytes;
+    int bands;
+} BoxReduceJob;
+
+static void box_reduce_band(void* ctx, int index) {
+    BoxReduceJob* job = (BoxReduceJob*)ctx;
+    const BoxReduce* box = job->box;
+    const uint8_t* rows[MAX_REDUCE_FACTOR];
+    void* acc = job->acc + job->acc_bytes * index;
+    size_t output_stride = (size_t)box->width * box->channels;
+
+    int y_end = (int)((long long)box->height * (index + 1) / job->bands);
+    for (int y = (int)((long long)box->height * index / job->bands); y < y_end; y++) {
+        int y0 = y * box->factor_y;
+        int row_count = box->source_height - y0 < box->factor_y ? box->source_height - y0 : box->factor_y;
+        for (int r = 0; r < row_count; r++) {
+            rows[r] = job->input + (size_t)(y0 + r) * job->input_stride;
+        }
+        box_reduce_row(box, rows, row_count, acc, job->output + y * output_stride);
+    }
+}
+
+// Box-reduce a whole region into box->width x box->height tightly packed
+// pixels, in bands of reduced rows on up to num_threads threads (0 = auto)
+// Returns 0 on success, -1 on error
+static int box_reduce_image(
+    const BoxReduce* box, const uint8_t* input, int input_stride,
+    uint8_t* output, int num_threads
+) {
+    BoxReduceJob job;
+    job.box = box;
+    job.input = input;
+    job.input_stride = input_stride;
+    job.output = output;
+    job.acc_bytes = ARENA_ROUND((size_t)box->source_width * box->channels * sizeof(uint32_t));
+    job.bands = resolve_threads(num_threads);
+    if (job.bands > box->height) job.bands = box->height;
+
+    job.acc = (uint8_t*)arena_malloc(job.acc_bytes * job.bands);
+    if (job.acc == NULL) {
+        return -1;
+    }
+    parallel_for(job.bands, job.bands, box_reduce_band, &job);
+    arena_free(job.acc);
+    return 0;
+}
+
+// Map the resampled region onto the reduced image: the part that maps back
+// onto the source (a partial last block only covers a fraction of a pixel),
+// or the same fraction of an input subrect set before the reduction
+static void box_reduce_subrect(STBIR_RESIZE* resize, const BoxReduce* box) {
+    double scale_x = (double)box->source_width / box->factor_x / box->width;
+    double scale_y = (double)box->source_height / box->factor_y / box->height;
+    stbir_set_input_subrect(resize,
+                            resize->input_s0 * scale_x, resize->input_t0 * scale_y,
+                            resize->input_s1 * scale_x, resize->input_t1 * scale_y);
+}
+
+// Swap the input of an initialized resize for its box reduction when the
+// reducing gap allows one. Must run before set_filters_and_edges, since
+// FILTER_AUTO depends on the remaining scale. *reduced receives the arena
+// buffer to free after the resize (NULL if the input is used as is).
+// Returns 0 on success, -1 on error
+static int pre_shrink(STBIR_RESIZE* resize, float reducing_gap, int num_threads, uint8_t** reduced) {
+    BoxReduce box;
+    *reduced = NULL;
+    if (!box_reduce_init(&box, resize->input_w, resize->input_h,
+                         resize->output_w, resize->output_h,
+                         resize->input_pixel_layout_public, resize->input_data_type,
+                         reducing_gap)) {
+        return 0;
+    }
+
+    int stride = resize->input_stride_in_bytes;
+    if (stride == 0) stride = resize->input_w * box.channels;
+
+    uint8_t* pixels = (uint8_t*)arena_malloc((size_t)box.width * box.height * box.channels);
+    if (pixels == NULL ||
+        box_reduce_image(&box, (const uint8_t*)resize->input_pixels, stride,
+                         pixels, num_threads) != 0) {
+        arena_free(pixels);
+        return -1;
+    }
+
+    // Samplers are built later from these fields, so they can still change
+    resize->input_pixels = pixels;
+    resize->input_w = box.width;
+    resize->input_h = box.height;
+    resize->input_stride_in_bytes = box.width * box.channels;
+    box_reduce_subrect(resize, &box);
+
+    *reduced = pixels;
+    return 0;
+}
+
+// ============================================================================
+// Helper: run a resize, splitting output scanlines across threads
+// ============================================================================
+
+// Below this many output pixels a resize is not worth splitting
+#define MIN_PIXELS_PER_SPLIT (64 * 1024)
+
+typedef struct {
+    STBIR_RESIZE* resize;
+    int failed;
+} SplitContext;
+
+static void resize_split_task(void* ctx, int index) {
+    SplitContext* split = (SplitContext*)ctx;
+    if (!stbir_resize_extended_split(split->resize, index, 1)) {
+        split->failed = 1;
+    }
+}
+
+// Number of threads worth using for a resize (output pixels bound the splits)
+static int resize_thread_count(const STBIR_RESIZE* resize, int num_threads) {
+    int threads = resolve_threads(num_threads);
+
+    long long output_pixels = (long long)resize->output_w * resize->output_h;
+    long long max_splits = output_pixels / MIN_PIXELS_PER_SPLIT;
+    if (max_splits < 1) max_splits = 1;
+    if (threads > max_splits) threads = (int)max_splits;
+
+    return threads;
+}
+
+// Run a resize whose samplers were built with `splits` splits
+// Returns 0 on success, -1 on error
+static int run_splits(STBIR_RESIZE* resize, int splits) {
+    if (splits <= 1) {
+        return stbir_resize_extended(resize) ? 0 : -1;
+    }
+
+    SplitContext split;
+    split.resize = resize;
+    split.failed = 0;
+    parallel_for(splits, splits, resize_split_task, &split);
+
+    return split.failed ? -1 : 0;
+}
+
+// Execute a configured resize on up to num_threads threads (0 = auto).
+// Results are identical to a single-threaded resize: each split produces a
+// disjoint band of output scanlines from the same samplers.
+// Returns 0 on success, -1 on error
+static int run_resize(STBIR_RESIZE* resize, int num_threads) {
+    int threads = resize_thread_count(resize, num_threads);
+    int result = -1;
+
+    // Sampler memory comes from the job arena (shared with an outer job)
+    JobArena* arena = arena_begin();
+
+    if (threads <= 1) {
+        result = stbir_resize_extended(resize) ? 0 : -1;
+    } else {
+        int splits = stbir_build_samplers_with_splits(resize, threads);
+        if (splits > 0) {
+            result = run_splits(resize, splits);
+            stbir_free_samplers(resize);
+        }
+    }
+
+    arena_end(arena);
+    return result;
+}
+
+// stb_image_resize2 layout for 1-4 interleaved 8-bit channels
+// (gray+alpha and RGBA are resampled alpha-weighted)
+static stbir_pixel_layout pixel_layout(int channels) {
+    switch (channels) {
+        case 1: return STBIR_1CHANNEL;
+        case 2: return STBIR_RA;
+        case 4: return STBIR_RGBA;
+        default: return STBIR_RGB;
+    }
+}
+
+// Apply an ALPHA_* mode to an alpha-weighted layout. The _PM layouts skip
+// stbir's alpha weighting entirely, which is what both premultiplied input and
+// ignored alpha need (unlike STBIR_4CHANNEL they keep alpha out of sRGB decoding)
+static stbir_pixel_layout alpha_layout(stbir_pixel_layout layout, int alpha_mode) {
+    stbir_pixel_layout unweighted;
+    switch (layout) {
+        case STBIR_RGBA: unweighted = STBIR_RGBA_PM; break;
+        case STBIR_BGRA: unweighted = STBIR_BGRA_PM; break;
+        case STBIR_ARGB: unweighted = STBIR_ARGB_PM; break;
+        case STBIR_ABGR: unweighted = STBIR_ABGR_PM; break;
+        case STBIR_RA: unweighted = STBIR_RA_PM; break;
+        case STBIR_AR: unweighted = STBIR_AR_PM; break;
+        default: return layout;
+    }
+    if (alpha_mode == ALPHA_PREMULTIPLIED || alpha_mode == ALPHA_IGNORE) {
+        return unweighted;
+    }
+    return layout;
+}
+
+// 1 if every alpha sample (last channel of gray+alpha / RGBA pixels) is 255
+static int alpha_is_opaque(const uint8_t* pixels, int width, int height, int stride, int channels) {
+    for (int y = 0; y < height; y++) {
+        const uint8_t* alpha = pixels + (size_t)y * stride + channels - 1;
+        for (int x = 0; x < width; x++, alpha += channels) {
+            if (*alpha != 255) return 0;
+        }
+    }
+    return 1;
+}
+
+// Drop the alpha channel of tightly packed gray+alpha / RGBA pixels in place
+static void drop_alpha(uint8_t* pixels, size_t count, int channels) {
+    const uint8_t* src = pixels;
+    uint8_t* dst = pixels;
+    if (channels == 4) {
+        for (size_t i = 0; i < count; i++, src += 4, dst += 3) {
+            dst[0] = src[0];
+            dst[1] = src[1];
+            dst[2] = src[2];
+        }
+    } else {
+        for (size_t i = 0; i < count; i++, src += 2, dst += 1) {
+            dst[0] = src[0];
+        }
+    }
+}
+
+// Resize the s0,t0 - s1,t1 subrect (0-1 of the input size) of 8-bit pixels,
+// so a crop may start and end between input pixels; see resize_pixels
+// Returns 0 on success, -1 on error
+static int resize_pixels_subrect(
+    const uint8_t* input, int input_width, int input_height, int input_stride,
+    double s0, double t0, double s1, double t1,
+    uint8_t* output, int output_width, int output_height, int output_stride,
+    stbir_pixel_layout layout, int alpha_mode, int filter, int edge_mode, int color_space,
+    float reducing_gap, int num_threads
+) {
+    STBIR_RESIZE resize;
+    stbir_resize_init(
+        &resize,
+        input, input_width, input_height, input_stride,
+        output, output_width, output_height, output_stride,
+        alpha_layout(layout, alpha_mode), get_stbir_datatype(color_space)
+    );
+    stbir_set_input_subrect(&resize, s0, t0, s1, t1);
+
+    uint8_t* reduced;
+    if (pre_shrink(&resize, reducing_gap, num_threads, &reduced) != 0) {
+        return -1;
+    }
+    set_filters_and_edges(&resize, filter, edge_mode);
+    if (alpha_mode == ALPHA_STRAIGHT_FAST) {
+        stbir_set_non_pm_alpha_speed_over_quality(&resize, 1);
+    }
+
+    int result = run_resize(&resize, num_threads);
+    arena_free(reduced);
+    return result;
+}
+
+// Resize 8-bit pixels between two buffers with the selected filter/edge mode
+// alpha_mode: ALPHA_* applied to alpha-weighted layouts
+// reducing_gap: box pre-shrink (see pre_shrink), 0 = off
+// Returns 0 on success, -1 on error
+static int resize_pixels(
+    const uint8_t* input, int input_width, int input_height, int input_stride,
+    uint8_t* output, int output_width, int output_height, int output_stride,
+    stbir_pixel_layout layout, int alpha_mode, int filter, int edge_mode, int color_space,
+    float reducing_gap, int num_threads
+) {
+    return resize_pixels_subrect(
+        input, input_width, input_height, input_stride, 0.0, 0.0, 1.0, 1.0,
+        output, output_width, output_height, output_stride,
+        layout, alpha_mode, filter, edge_mode, color_space, reducing_gap, num_threads
+    );
+}
+
+// ============================================================================
+// Raw pixel data resize functions
+// ============================================================================
+
+// Shared implementation of the raw entry points
+// input_stride/output_stride: row stride in bytes, 0 = tightly packed
+static int resize_raw(
+    const uint8_t* input,
+    int input_width,
+    int input_height,
+    int input_stride,
+    uint8_t* output,
+    int output_width,
+    int output_height,
+    int output_stride,
+    int channels,
+    int filter,
+    int edge_mode,
+    int color_space,
+    int alpha_mode,
+    float reducing_gap,
+    float crop,
+    int crop_anchor,
+    int aspect_mode,
+    float aspect_w,
+    float aspect_h,
+    int num_threads
+) {
+    if (input == NULL || output == NULL || channels < 1 || channels > 4) {
+        return -1;
+    }
+    if (input_width <= 0 || input_height <= 0 || output_width <= 0 || output_height <= 0) {
+        return -1;
+    }
+
+    // Zero stride means tightly packed rows; padded rows must still fit a full row
+    if (input_stride == 0) input_stride = input_width * channels;
+    if (output_stride == 0) output_stride = output_width * channels;
+    if (input_stride < input_width * channels || output_stride < output_width * channels) {
+        return -1;
+    }
+
+    // Calculate crop region
+    int crop_x, crop_y, crop_width, crop_height;
+    calc_crop(input_width, input_height, crop, crop_anchor, aspect_mode, aspect_w, aspect_h,
+              &crop_x, &crop_y, &crop_width, &crop_height);
+
+    // Get pointer to start of cropped region
+    const uint8_t* crop_start = input + (size_t)crop_y * input_stride + (size_t)crop_x * channels;
+
+    return resize_pixels(
+        crop_start,
+        crop_width,
+        crop_height,
+        input_stride,  // Original stride (not cropped width)
+        output,
+        output_width,
+        output_height,
+        output_stride,
+        pixel_layout(channels),
+        alpha_mode,
+        filter,
+        edge_mode,
+        color_space,
+        reducing_gap,
+        num_threads
+    );
+}
+
+FFI_EXPORT int bicubic_resize_rgb(
+    const uint8_t* input,
+    int input_width,
+    int input_height,
+    uint8_t* output,
+    int output_width,
+    int output_height,
+    int filter,
+    int edge_mode,
+    int color_space,
+    float reducing_gap,
+    float crop,
+    int crop_anchor,
+    int aspect_mode,
+    float aspect_w,
+    float aspect_h,
+    int num_threads
+) {
+    return resize_raw(input, input_width, input_height, 0,
+                      output, output_width, output_height, 0, 3,
+                      filter, edge_mode, color_space, ALPHA_STRAIGHT, reducing_gap,
+                      crop, crop_anchor, aspect_mode, aspect_w, aspect_h, num_threads);
+}
+
+FFI_EXPORT int bicubic_resize_rgba(
+    const uint8_t* input,
+    int input_width,
+    int input_height,
+    uint8_t* output,
+    int output_width,
+    int output_height,
+    int filter,
+    int edge_mode,
+    int color_space,
+    int alpha_mode,
+    float reducing_gap,
+    float crop,
+    int crop_anchor,
+    int aspect_mode,
+    float aspect_w,
+    float aspect_h,
+    int num_threads
+) {
+    return resize_raw(input, input_width, input_height, 0,
+                      output, output_width, output_height, 0, 4,
+                      filter, edge_mode, color_space, alpha_mode, reducing_gap,
+                      crop, crop_anchor, aspect_mode, aspect_w, aspect_h, num_threads);
+}
+
+FFI_EXPORT int bicubic_resize_rgb_strided(
+    const uint8_t* input,
+    int input_width,
+    int input_height,
+    int input_stride,
+    uint8_t* output,
+    int output_width,
+    int output_height,
+    int output_stride,
+    int filter,
+    int edge_mode,
+    int color_space,
+    float reducing_gap,
+    float crop,
+    int crop_anchor,
+    int aspect_mode,
+    float aspect_w,
+    float aspect_h,
+    int num_threads
+) {
+    return resize_raw(input, input_width, input_height, input_stride,
+                      output, output_width, output_height, output_stride, 3,
+                      filter, edge_mode, color_space, ALPHA_STRAIGHT, reducing_gap,
+                      crop, crop_anchor, aspect_mode, aspect_w, aspect_h, num_threads);
+}
+
+FFI_EXPORT int bicubic_resize_rgba_strided(
+    const uint8_t* input,
+    int input_width,
+    int input_height,
+    int input_stride,
+    uint8_t* output,
+    int output_width,
+    int output_height,
+    int output_stride,
+    int filter,
+    int edge_mode,
+    int color_space,
+    int alpha_mode,
+    float reducing_gap,
+    float crop,
+    int crop_anchor,
+    int aspect_mode,
+    float aspect_w,
+    float aspect_h,
+    int num_threads
+) {
+    return resize_raw(input, input_width, input_height, input_stride,
+                      output, output_width, output_height, output_stride, 4,
+                      filter, edge_mode, color_space, alpha_mode, reducing_gap,
+                      crop, crop_anchor, aspect_mode, aspect_w, aspect_h, num_threads);
+}
+
+FFI_EXPORT int bicubic_resize_gray(
+    const uint8_t* input,
+    int input_width,
+    int input_height,
+    uint8_t* output,
+    int output_width,
+    int output_height,
+    int filter,
+    int edge_mode,
+    int color_space,
+    float reducing_gap,
+    float crop,
+    int crop_anchor,
+    int aspect_mode,
+    float aspect_w,
+    float aspect_h,
+    int num_threads
+) {
+    return resize_raw(input, input_width, input_height, 0,
+                      output, output_width, output_height, 0, 1,
+                      filter, edge_mode, color_space, ALPHA_STRAIGHT, reducing_gap,
+                      crop, crop_anchor, aspect_mode, aspect_w, aspect_h, num_threads);
+}
+
+FFI_EXPORT int bicubic_resize_gray_strided(
+    const uint8_t* input,
+    int input_width,
+    int input_height,
+    int input_stride,
+    uint8_t* output,
+    int output_width,
+    int output_height,
+    int output_stride,
+    int filter,
+    int edge_mode,
+    int color_space,
+    float reducing_gap,
+    float crop,
+    int crop_anchor,
+    int aspect_mode,
+    float aspect_w,
+    float aspect_h,
+    int num_threads
+) {
+    return resize_raw(input, input_width, input_height, input_stride,
+                      output, output_width, output_height, output_stride, 1,
+                      filter, edge_mode, color_space, ALPHA_STRAIGHT, reducing_gap,
+                      crop, crop_anchor, aspect_mode, aspect_w, aspect_h, num_threads);
+}
+
+FFI_EXPORT int bicubic_resize_rgba_drop_opaque_alpha(
+    const uint8_t* input,
+    int input_width,
+    int input_height,
+    int input_stride,
+    uint8_t* output,
+    int output_width,
+    int output_height,
+    int filter,
+    int edge_mode,
+    int color_space,
+    int alpha_mode,
+    float reducing_gap,
+    float crop,
+    int crop_anchor,
+    int aspect_mode,
+    float aspect_w,
+    float aspect_h,
+    int num_threads,
+    int* output_channels
+) {
+    if (input == NULL || output == NULL || output_channels == NULL) {
+        return -1;
+    }
+    if (input_width <= 0 || input_height <= 0 || output_width <= 0 || output_height <= 0) {
+        return -1;
+    }
+    if (input_stride == 0) input_stride = input_width * 4;
+    if (input_stride < input_width * 4) {
+        return -1;
+    }
+
+    // Only the cropped region is resampled, so only it has to be opaque
+    int crop_x, crop_y, crop_width, crop_height;
+    calc_crop(input_width, input_height, crop, crop_anchor, aspect_mode, aspect_w, aspect_h,
+              &crop_x, &crop_y, &crop_width, &crop_height);
+    const uint8_t* crop_start = input + (size_t)crop_y * input_stride + (size_t)crop_x * 4;
+
+    if (!alpha_is_opaque(crop_start, crop_width, crop_height, input_stride, 4)) {
+        *output_channels = 4;
+        return resize_raw(input, input_width, input_height, input_stride,
+                          output, output_width, output_height, 0, 4,
+                          filter, edge_mode, color_space, alpha_mode, reducing_gap,
+                          crop, crop_anchor, aspect_mode, aspect_w, aspect_h, num_threads);
+    }
+
+    // Opaque: plain 4-channel resampling skips the alpha weighting passes;
+    // the constant alpha is then dropped from the output
+    int result = resize_pixels(
+        crop_start, crop_width, crop_height, input_stride,
+        output, output_width, output_height, output_width * 4,
+        STBIR_4CHANNEL, ALPHA_STRAIGHT, filter, edge_mode, color_space,
+        reducing_gap, num_threads
+    );
+    if (result != 0) {
+        return -1;
+    }
+
+    drop_alpha(output, (size_t)output_width * output_height, 4);
+    *output_channels = 3;
+    return 0;
+}
+
+// ============================================================================
+// Channel-order conversion and planar output
+// ============================================================================
+
+// stb_image_resize2 layout and channel count for each PIXEL_LAYOUT_*
+static const stbir_pixel_layout layout_stbir[] = {
+    STBIR_1CHANNEL, STBIR_RA, STBIR_AR, STBIR_RGB, STBIR_BGR,
+    STBIR_RGBA, STBIR_BGRA, STBIR_ARGB, STBIR_ABGR,
+};
+static const int layout_channels[] = { 1, 2, 2, 3, 3, 4, 4, 4, 4 };
+
+#define PIXEL_LAYOUT_COUNT ((int)(sizeof(layout_channels) / sizeof(layout_channels[0])))
+
+// Splits each resized (already reordered) scanline into one plane per channel
+typedef struct {
+    uint8_t* output;
+    size_t plane_size;   // Bytes per plane
+    int stride;          // Bytes between rows of a plane
+    int channels;
+} PlanarWriter;
+
+static void planar_output_cb(const void* output_ptr, int num_pixels, int y, void* context) {
+    const PlanarWriter* writer = (const PlanarWriter*)context;
+    const uint8_t* src = (const uint8_t*)output_ptr;
+    int channels = writer->channels;
+
+    for (int c = 0; c < channels; c++) {
+        uint8_t* dst = writer->output + c * writer->plane_size + (size_t)y * writer->stride;
+        const uint8_t* s = src + c;
+        for (int x = 0; x < num_pixels; x++) {
+            dst[x] = s[x * channels];
+        }
+    }
+}
+
+FFI_EXPORT int bicubic_resize_layout(
+    const uint8_t* input,
+    int input_width,
+    int input_height,
+    int input_stride,
+    int input_layout,
+    uint8_t* output,
+    int output_width,
+    int output_height,
+    int output_stride,
+    int output_layout,
+    int filter,
+    int edge_mode,
+    int color_space,
+    int alpha_mode,
+    float reducing_gap,
+    float crop,
+    int crop_anchor,
+    int aspect_mode,
+    float aspect_w,
+    float aspect_h,
+    int num_threads
+) {
+    int planar = (output_layout & PIXEL_LAYOUT_PLANAR) != 0;
+    output_layout &= ~PIXEL_LAYOUT_PLANAR;
+
+    if (input == NULL || output == NULL) {
+        return -1;
+    }
+    if (input_layout < 0 || input_layout >= PIXEL_LAYOUT_COUNT ||
+        output_layout < 0 || output_layout >= PIXEL_LAYOUT_COUNT) {
+        return -1;
+    }
+    int channels = layout_channels[input_layout];
+    if (layout_channels[output_layout] != channels) {
+        return -1;
+    }
+    if (input_width <= 0 || input_height <= 0 || output_width <= 0 || output_height <= 0) {
+        return -1;
+    }
+
+    // Planar rows hold one byte per pixel
+    int output_pixel_bytes = planar ? 1 : channels;
+    if (input_stride == 0) input_stride = input_width * channels;
+    if (output_stride == 0) output_stride = output_width * output_pixel_bytes;
+    if (input_stride < input_width * channels || output_stride < output_width * output_pixel_bytes) {
+        return -1;
+    }
+
+    // Calculate crop region
+    int crop_x, crop_y, crop_width, crop_height;
+    calc_crop(input_width, input_height, crop, crop_anchor, aspect_mode, aspect_w, aspect_h,
+              &crop_x, &crop_y, &crop_width, &crop_height);
+    const uint8_t* crop_start = input + (size_t)crop_y * input_stride + (size_t)crop_x * channels;
+
+    // Channels are reordered by stbir's decode/encode loops; planar output is
+    // split from the encoded scanline while it is still in cache
+    STBIR_RESIZE resize;
+    stbir_resize_init(
+        &resize,
+        crop_start, crop_width, crop_height, input_stride,
+        output, output_width, output_height, planar ? output_width * channels : output_stride,
+        STBIR_RGB, get_stbir_datatype(color_space)
+    );
+    stbir_set_pixel_layouts(&resize,
+                            alpha_layout(layout_stbir[input_layout], alpha_mode),
+                            alpha_layout(layout_stbir[output_layout], alpha_mode));
+
+    // The box pass averages in the input layout; stbir reorders afterwards
+    uint8_t* reduced;
+    if (pre_shrink(&resize, reducing_gap, num_threads, &reduced) != 0) {
+        return -1;
+    }
+    set_filters_and_edges(&resize, filter, edge_mode);
+    if (alpha_mode == ALPHA_STRAIGHT_FAST) {
+        stbir_set_non_pm_alpha_speed_over_quality(&resize, 1);
+    }
+
+    PlanarWriter writer;
+    if (planar) {
+        writer.output = output;
+        writer.plane_size = (size_t)output_stride * output_height;
+        writer.stride = output_stride;
+        writer.channels = channels;
+        stbir_set_pixel_callbacks(&resize, NULL, planar_output_cb);
+        stbir_set_user_data(&resize, &writer);
+    }
+
+    int result = run_resize(&resize, num_threads);
+    arena_free(reduced);
+    return result;
+}
+
+// ============================================================================
+// Float tensor output (resize + normalize + layout in the output stage)
+// ============================================================================
+
+typedef struct {
+    float* output;
+    int width;
+    int height;
+    int src_channels;     // Floats per pixel in the resized scanline
+    int layout;           // TENSOR_NHWC or TENSOR_NCHW
+    int srgb;             // Scanline holds linear light to re-encode
+    int src_index[3];     // Source channel for each output channel
+    float scale[3];       // 1 / std
+    float bias[3];        // -mean / std
+} TensorWriter;
+
+// Linear-light samples are re-encoded with the exact sRGB curve in float, so
+// the tensor holds the same value range as in gamma space without the 8-bit
+// rounding of stbir's table-based encoder
+static inline float tensor_sample(const TensorWriter* writer, float v) {
+    if (!writer->srgb) return v;
+    if (v <= 0.0f) return 0.0f;
+    if (v >= 1.0f) return 1.0f;
+    if (v <= 0.0031308f) return v * 12.92f;
+    return 1.055f * powf(v, 1.0f / 2.4f) - 0.055f;
+}
+
+// stbir output callback: receives one resized scanline as floats in 0.0-1.0
+// and writes it normalized into its row of the tensor
+static void tensor_output_cb(const void* output_ptr, int num_pixels, int y, void* context) {
+    const TensorWriter* writer = (const TensorWriter*)context;
+    const float* src = (const float*)output_ptr;
+    int sc = writer->src_channels;
+
+    if (writer->layout == TENSOR_NCHW) {
+        size_t plane_size = (size_t)writer->width * writer->height;
+        for (int c = 0; c < 3; c++) {
+            float* dst = writer->output + c * plane_size + (size_t)y * writer->width;
+            const float* s = src + writer->src_index[c];
+            float scale = writer->scale[c];
+            float bias = writer->bias[c];
+            for (int x = 0; x < num_pixels; x++) {
+                dst[x] = tensor_sample(writer, s[x * sc]) * scale + bias;
+            }
+        }
+    } else {
+        float* dst = writer->output + (size_t)y * writer->width * 3;
+        for (int x = 0; x < num_pixels; x++) {
+            const float* s = src + x * sc;
+            dst[0] = tensor_sample(writer, s[writer->src_index[0]]) * writer->scale[0] + writer->bias[0];
+            dst[1] = tensor_sample(writer, s[writer->src_index[1]]) * writer->scale[1] + writer->bias[1];
+            dst[2] = tensor_sample(writer, s[writer->src_index[2]]) * writer->scale[2] + writer->bias[2];
+            dst += 3;
+        }
+    }
+}
+
+FFI_EXPORT int bicubic_resize_rgb_to_tensor(
+    const uint8_t* input,
+    int input_width,
+    int input_height,
+    int input_channels,
+    float* output,
+    int output_width,
+    int output_height,
+    int filter,
+    int edge_mode,
+    int color_space,
+    float reducing_gap,
+    float crop,
+    int crop_anchor,
+    int aspect_mode,
+    float aspect_w,
+    float aspect_h,
+    int tensor_layout,
+    int channel_order,
+    const float* mean,
+    const float* std,
+    int num_threads
+) {
+    if (input == NULL || output == NULL) {
+        return -1;
+    }
+    if (input_channels != 3 && input_channels != 4) {
+        return -1;
+    }
+    if (input_width <= 0 || input_height <= 0 || output_width <= 0 || output_height <= 0) {
+        return -1;
+    }
+
+    TensorWriter writer;
+    writer.output = output;
+    writer.width = output_width;
+    writer.height = output_height;
+    writer.src_channels = input_channels;
+    writer.layout = (tensor_layout == TENSOR_NCHW) ? TENSOR_NCHW : TENSOR_NHWC;
+    writer.srgb = (color_space == COLOR_SPACE_LINEAR);
+    for (int c = 0; c < 3; c++) {
+        float m = (mean != NULL) ? mean[c] : 0.0f;
+        float sd = (std != NULL) ? std[c] : 1.0f;
+        if (sd == 0.0f) {
+            return -1;
+        }
+        writer.src_index[c] = (channel_order == CHANNEL_ORDER_BGR) ? 2 - c : c;
+        writer.scale[c] = 1.0f / sd;
+        writer.bias[c] = -m / sd;
+    }
+
+    // Calculate crop region
+    int crop_x, crop_y, crop_width, crop_height;
+    calc_crop(input_width, input_height, crop, crop_anchor, aspect_mode, aspect_w, aspect_h,
+              &crop_x, &crop_y, &crop_width, &crop_height);
+
+    // Get pointer to start of cropped region
+    const uint8_t* crop_start = input + ((size_t)crop_y * input_width + crop_x) * input_channels;
+
+    // Alpha is dropped, so RGBA is resampled as 4 plain channels (no alpha weighting)
+    STBIR_RESIZE resize;
+    stbir_resize_init(
+        &resize,
+        crop_start, crop_width, crop_height, input_width * input_channels,
+        output, output_width, output_height, output_width * input_channels * (int)sizeof(float),
+        (input_channels == 4) ? STBIR_4CHANNEL : STBIR_RGB, STBIR_TYPE_UINT8
+    );
+    stbir_set_datatypes(&resize, get_stbir_datatype(color_space), STBIR_TYPE_FLOAT);
+    stbir_set_pixel_callbacks(&resize, NULL, tensor_output_cb);
+    stbir_set_user_data(&resize, &writer);
+
+    uint8_t* reduced;
+    if (pre_shrink(&resize, reducing_gap, num_threads, &reduced) != 0) {
+        return -1;
+    }
+    set_filters_and_edges(&resize, filter, edge_mode);
+
+    int result = run_resize(&resize, num_threads);
+    arena_free(reduced);
+    return result;
+}
+
+// ============================================================================
+// YUV 4:2:0 camera input (resample planes, convert at output resolution)
+// ============================================================================
+
+// Fixed-point (16.16) YUV -> RGB coefficients
+typedef struct {
+    int y_offset;  // Subtracted from Y (16 for limited range)
+    int y_scale;
+    int v_to_r;
+    int u_to_g;
+    int v_to_g;
+    int u_to_b;
+} YuvMatrix;
+
+static const YuvMatrix yuv_matrices[] = {
+    // YUV_BT601_FULL (JFIF, most Android cameras)
+    { 0, 65536, 91881, 22553, 46802, 116130 },
+    // YUV_BT601_LIMITED
+    { 16, 76309, 104597, 25675, 53279, 132201 },
+    // YUV_BT709_LIMITED
+    { 16, 76309, 117489, 13975, 34925, 138438 },
+};
+
+static inline uint8_t clamp_u8(int v) {
+    if (v < 0) return 0;
+    if (v > 255) return 255;
+    return (uint8_t)v;
+}
+
+// Gathers one chroma plane with an arbitrary pixel stride into a packed row
+typedef struct {
+    const uint8_t* plane;
+    int row_stride;
+    int pixel_stride;
+} PlaneGather;
+
+static const void* plane_gather_cb(void* optional_output, const void* input_ptr,
+                                   int num_pixels, int x, int y, void* context) {
+    (void)input_ptr;
+    const PlaneGather* gather = (const PlaneGather*)context;
+    const uint8_t* src = gather->plane + (size_t)y * gather->row_stride + (size_t)x * gather->pixel_stride;
+    uint8_t* dst = (uint8_t*)optional_output;
+    for (int i = 0; i < num_pixels; i++) {
+        dst[i] = src[(size_t)i * gather->pixel_stride];
+    }
+    return dst;
+}
+
+// Converts each resized luma row together with the already resized chroma
+typedef struct {
+    const uint8_t* uv;   // Resized chroma, interleaved U,V per output pixel
+    uint8_t* output;
+    int output_width;
+    int output_stride;
+    int output_channels;
+    const YuvMatrix* matrix;
+} YuvWriter;
+
+static void yuv_output_cb(const void* output_ptr, int num_pixels, int y, void* context) {
+    const YuvWriter* writer = (const YuvWriter*)context;
+    const YuvMatrix* m = writer->matrix;
+    const uint8_t* luma = (const uint8_t*)output_ptr;
+    const uint8_t* uv = writer->uv + (size_t)y * writer->output_width * 2;
+    uint8_t* dst = writer->output + (size_t)y * writer->output_stride;
+    int channels = writer->output_channels;
+
+    for (int x = 0; x < num_pixels; x++) {
+        int yy = (luma[x] - m->y_offset) * m->y_scale + 32768;
+        int u = uv[x * 2] - 128;
+        int v = uv[x * 2 + 1] - 128;
+
+        dst[0] = clamp_u8((yy + m->v_to_r * v) >> 16);
+        dst[1] = clamp_u8((yy - m->u_to_g * u - m->v_to_g * v) >> 16);
+        dst[2] = clamp_u8((yy + m->u_to_b * u) >> 16);
+        if (channels == 4) dst[3] = 255;
+        dst += channels;
+    }
+}
+
+// Configure a resize of the crop window [x0, x1) x [y0, y1) (in plane pixels,
+// may be fractional) of a plane to the full output size
+static void init_plane_resize(
+    STBIR_RESIZE* resize,
+    const uint8_t* plane, int plane_width, int plane_height, int row_stride,
+    uint8_t* output, int output_width, int output_height, int output_stride,
+    stbir_pixel_layout layout,
+    double x0, double y0, double x1, double y1,
+    int filter, int edge_mode
+) {
+    stbir_resize_init(
+        resize,
+        plane, plane_width, plane_height, row_stride,
+        output, output_width, output_height, output_stride,
+        layout, STBIR_TYPE_UINT8
+    );
+    stbir_set_input_subrect(resize, x0 / plane_width, y0 / plane_height,
+                            x1 / plane_width, y1 / plane_height);
+    set_filters_and_edges(resize, filter, edge_mode);
+}
+
+FFI_EXPORT int bicubic_resize_yuv420(
+    const uint8_t* y_plane,
+    int y_row_stride,
+    const uint8_t* u_plane,
+    const uint8_t* v_plane,
+    int uv_row_stride,
+    int uv_pixel_stride,
+    int input_width,
+    int input_height,
+    uint8_t* output,
+    int output_width,
+    int output_height,
+    int output_channels,
+    int color_matrix,
+    int chroma_siting,
+    int filter,
+    int edge_mode,
+    int color_space,
+    float crop,
+    int crop_anchor,
+    int aspect_mode,
+    float aspect_w,
+    float aspect_h,
+    int num_threads
+) {
+    if (y_plane == NULL || u_plane == NULL || v_plane == NULL || output == NULL) {
+        return -1;
+    }
+    if (input_width <= 0 || input_height <= 0 || output_width <= 0 || output_height <= 0) {
+        return -1;
+    }
+    if (output_channels != 3 && output_channels != 4) {
+        return -1;
+    }
+    if (uv_pixel_stride < 1 || y_row_stride < input_width) {
+        return -1;
+    }
+    if (color_matrix < YUV_BT601_FULL || color_matrix > YUV_BT709_LIMITED) {
+        color_matrix = YUV_BT601_FULL;
+    }
+
+    // Calculate crop region (in luma pixels)
+    int crop_x, crop_y, crop_width, crop_height;
+    calc_crop(input_width, input_height, crop, crop_anchor, aspect_mode, aspect_w, aspect_h,
+              &crop_x, &crop_y, &crop_width, &crop_height);
+
+    // Chroma is sampled at half resolution, so the crop window in chroma
+    // pixels is half the luma window. Co-sited chroma sample i lies on luma
+    // column 2i rather than between columns 2i and 2i+1, which shifts the
+    // window a quarter chroma pixel to the right; rows are always centered
+    int chroma_width = (input_width + 1) / 2;
+    int chroma_height = (input_height + 1) / 2;
+    double siting_x = (chroma_siting == YUV_SITING_CENTER) ? 0.0 : 0.25;
+    double cx0 = crop_x * 0.5 + siting_x;
+    double cy0 = crop_y * 0.5;
+    double cx1 = (crop_x + crop_width) * 0.5 + siting_x;
+    double cy1 = (crop_y + crop_height) * 0.5;
+
+    // Resampled chroma at output resolution, interleaved U,V. Scratch comes
+    // from the job arena, so per-frame calls reuse the same memory
+    JobArena* arena = arena_begin();
+    uint8_t* uv = (uint8_t*)arena_malloc((size_t)output_width * output_height * 2);
+    if (uv == NULL) {
+        arena_end(arena);
+        return -1;
+    }
+
+    int result = 0;
+    STBIR_RESIZE resize;
+
+    if (uv_pixel_stride == 2 && (v_plane == u_plane + 1 || u_plane == v_plane + 1)) {
+        // NV12 / NV21: chroma is one interleaved 2-channel plane
+        const uint8_t* first = (u_plane < v_plane) ? u_plane : v_plane;
+        init_plane_resize(&resize, first, chroma_width, chroma_height, uv_row_stride,
+                          uv, output_width, output_height, output_width * 2,
+                          STBIR_2CHANNEL, cx0, cy0, cx1, cy1, filter, edge_mode);
+        result = run_resize(&resize, num_threads);
+
+        // NV21 stores V first: swap to U,V order
+        if (result == 0 && v_plane < u_plane) {
+            size_t count = (size_t)output_width * output_height;
+            for (size_t i = 0; i < count; i++) {
+                uint8_t t = uv[i * 2];
+                uv[i * 2] = uv[i * 2 + 1];
+                uv[i * 2 + 1] = t;
+            }
+        }
+    } else {
+        // I420 / YV12 or unrelated planes: resample U and V one at a time,
+        // gathering samples through a callback when they are not packed
+        const uint8_t* planes[2] = { u_plane, v_plane };
+        uint8_t* plane_out = (uint8_t*)arena_malloc((size_t)output_width * output_height);
+        if (plane_out == NULL) {
+            arena_free(uv);
+            arena_end(arena);
+            return -1;
+        }
+
+        for (int p = 0; p < 2 && result == 0; p++) {
+            PlaneGather gather;
+            gather.plane = planes[p];
+            gather.row_stride = uv_row_stride;
+            gather.pixel_stride = uv_pixel_stride;
+
+            init_plane_resize(&resize, planes[p], chroma_width, chroma_height, uv_row_stride,
+                              plane_out, output_width, output_height, output_width,
+                              STBIR_1CHANNEL, cx0, cy0, cx1, cy1, filter, edge_mode);
+            if (uv_pixel_stride != 1) {
+                stbir_set_pixel_callbacks(&resize, plane_gather_cb, NULL);
+                stbir_set_user_data(&resize, &gather);
+            }
+            result = run_resize(&resize, num_threads);
+
+            size_t count = (size_t)output_width * output_height;
+            for (size_t i = 0; i < count; i++) {
+                uv[i * 2 + p] = plane_out[i];
+            }
+        }
+        arena_free(plane_out);
+    }
+
+    if (result == 0) {
+        // Resample luma; each finished row is converted to RGB in place
+        YuvWriter writer;
+        writer.uv = uv;
+        writer.output = output;
+        writer.output_width = output_width;
+        writer.output_stride = output_width * output_channels;
+        writer.output_channels = output_channels;
+        writer.matrix = &yuv_matrices[color_matrix];
+
+        init_plane_resize(&resize, y_plane, input_width, input_height, y_row_stride,
+                          output, output_width, output_height, writer.output_stride,
+                          STBIR_1CHANNEL, crop_x, crop_y, crop_x + crop_width, crop_y + crop_height,
+                          filter, edge_mode);
+        // Luma is gamma-encoded much like sRGB, so it is the plane resampled
+        // in linear light; chroma differences are resampled as stored
+        stbir_set_datatypes(&resize, get_stbir_datatype(color_space),
+                            get_stbir_datatype(color_space));
+        stbir_set_pixel_callbacks(&resize, NULL, yuv_output_cb);
+        stbir_set_user_data(&resize, &writer);
+        result = run_resize(&resize, num_threads);
+    }
+
+    arena_free(uv);
+    arena_end(arena);
+    return result;
+}
+
+// ============================================================================
+// Resize plans (prebuilt samplers for repeated same-geometry resizes)
+// ============================================================================
+
+struct BicubicPlan {
+    STBIR_RESIZE resize;
+    int splits;
+    int channels;
+    int input_stride;
+    int output_stride;
+    size_t crop_offset;  // Byte offset of the crop origin in the input
+    BoxReduce box;       // Box pre-shrink of each frame (reducing gap)
+    uint8_t* reduced;    // Pre-shrunk frame, NULL if the gap is off or unused
+    int num_threads;
+};
+
+FFI_EXPORT BicubicPlan* bicubic_plan_create(
+    int input_width,
+    int input_height,
+    int channels,
+    int output_width,
+    int output_height,
+    int filter,
+    int edge_mode,
+    int color_space,
+    int alpha_mode,
+    float reducing_gap,
+    float crop,
+    int crop_anchor,
+    int aspect_mode,
+    float aspect_w,
+    float aspect_h,
+    int num_threads
+) {
+    if (channels != 3 && channels != 4) {
+        return NULL;
+    }
+    if (input_width <= 0 || input_height <= 0 || output_width <= 0 || output_height <= 0) {
+        return NULL;
+    }
+
+    BicubicPlan* plan = (BicubicPlan*)malloc(sizeof(BicubicPlan));
+    if (plan == NULL) {
+        return NULL;
+    }
+
+    // Calculate crop region
+    int crop_x, crop_y, crop_width, crop_height;
+    calc_crop(input_width, input_height, crop, crop_anchor, aspect_mode, aspect_w, aspect_h,
+              &crop_x, &crop_y, &crop_width, &crop_height);
+
+    plan->channels = channels;
+    plan->input_stride = input_width * channels;  // Original stride (not cropped width)
+    plan->output_stride = output_width * channels;
+    plan->crop_offset = (size_t)crop_y * plan->input_stride + (size_t)crop_x * channels;
+    plan->num_threads = num_threads;
+    plan->reduced = NULL;
+
+    // With a reducing gap, frames are box-reduced into a buffer owned by the
+    // plan and the samplers are built for the reduced size
+    stbir_pixel_layout layout = alpha_layout(pixel_layout(channels), alpha_mode);
+    int resize_width = crop_width;
+    int resize_height = crop_height;
+    int resize_stride = plan->input_stride;
+    if (box_reduce_init(&plan->box, crop_width, crop_height, output_width, output_height,
+                        layout, get_stbir_datatype(color_space), reducing_gap)) {
+        plan->reduced = (uint8_t*)malloc((size_t)plan->box.width * plan->box.height * channels);
+        if (plan->reduced == NULL) {
+            free(plan);
+            return NULL;
+        }
+        resize_width = plan->box.width;
+        resize_height = plan->box.height;
+        resize_stride = plan->box.width * channels;
+    }
+
+    // Buffer pointers are bound per frame in bicubic_plan_execute
+    stbir_resize_init(
+        &plan->resize,
+        NULL, resize_width, resize_height, resize_stride,
+        NULL, output_width, output_height, plan->output_stride,
+        layout, get_stbir_datatype(color_space)
+    );
+    if (plan->reduced != NULL) {
+        box_reduce_subrect(&plan->resize, &plan->box);
+    }
+    set_filters_and_edges(&plan->resize, filter, edge_mode);
+    if (alpha_mode == ALPHA_STRAIGHT_FAST) {
+        stbir_set_non_pm_alpha_speed_over_quality(&plan->resize, 1);
+    }
+
+    plan->splits = stbir_build_samplers_with_splits(
+        &plan->resize, resize_thread_count(&plan->resize, num_threads));
+    if (plan->splits <= 0) {
+        free(plan->reduced);
+        free(plan);
+        return NULL;
+    }
+
+    return plan;
+}
+
+FFI_EXPORT int bicubic_plan_execute(
+    BicubicPlan* plan,
+    const uint8_t* input,
+    uint8_t* output
+) {
+    if (plan == NULL || input == NULL || output == NULL) {
+        return -1;
+    }
+
+    const uint8_t* source = input + plan->crop_offset;
+    int source_stride = plan->input_stride;
+    if (plan->reduced != NULL) {
+        if (box_reduce_image(&plan->box, source, source_stride, plan->reduced,
+                             plan->num_threads) != 0) {
+            return -1;
+        }
+        source = plan->reduced;
+        source_stride = plan->box.width * plan->channels;
+    }
+
+    stbir_set_buffer_ptrs(
+        &plan->resize,
+        source, source_stride,
+        output, plan->output_stride
+    );
+
+    return run_splits(&plan->resize, plan->splits);
+}
+
+FFI_EXPORT void bicubic_plan_destroy(BicubicPlan* plan) {
+    if (plan != NULL) {
+        stbir_free_samplers(&plan->resize);
+        free(plan->reduced);
+        free(plan);
+    }
+}
+
+// ============================================================================
+// Helper for stbi_write to memory
+// ============================================================================
+
+typedef struct {
+    uint8_t* data;
+    int size;
+    int capacity;
+} WriteContext;
+
+static void write_func(void* context, void* data, int size) {
+    WriteContext* ctx = (WriteContext*)context;
+
+    // Grow buffer if needed
+    while (ctx->size + size > ctx->capacity) {
+        ctx->capacity = ctx->capacity * 2;
+        ctx->data = (uint8_t*)realloc(ctx->data, ctx->capacity);
+    }
+
+    memcpy(ctx->data + ctx->size, data, size);
+    ctx->size += size;
+}
+
+// Encode 1-4 channel pixels as JPEG into a malloc'd buffer (alpha is ignored;
+// gray and gray+alpha are written as a grayscale JPEG)
+// Returns 0 on success, -1 on error
+static int encode_jpeg(
+    const uint8_t* pixels, int width, int height, int channels,
+    int quality, int chroma_subsampling,
+    uint8_t** output_data, int* output_size
+) {
+    if (quality < 1) quality = 1;
+    if (quality > 100) quality = 100;
+    if (chroma_subsampling < JPEG_SUBSAMPLING_AUTO || chroma_subsampling > JPEG_SUBSAMPLING_420) {
+        chroma_subsampling = JPEG_SUBSAMPLING_AUTO;
+    }
+
+    WriteContext ctx;
+    ctx.capacity = width * height * 3;  // Initial estimate
+    ctx.size = 0;
+    ctx.data = (uint8_t*)malloc(ctx.capacity);
+
+    if (ctx.data == NULL) {
+        return -1;
+    }
+
+    int result = stbi_write_jpg_to_func_ex(
+        write_func, &ctx,
+        width, height, channels,
+        pixels, quality, chroma_subsampling
+    );
+
+    if (result == 0) {
+        free(ctx.data);
+        return -1;
+    }
+
+    // Shrink buffer to actual size
+    *output_data = (uint8_t*)realloc(ctx.data, ctx.size);
+    *output_size = ctx.size;
+    return 0;
+}
+
+// Encode 1-4 channel pixels as PNG into a malloc'd buffer
+// Returns 0 on success, -1 on error
+static int encode_png(
+    const uint8_t* pixels, int width, int height, int channels,
+    int compression_level, int png_filter,
+    uint8_t** output_data, int* output_size
+) {
+    // Clamp compression level to valid range (0-9)
+    if (compression_level < 0) compression_level = 0;
+    if (compression_level > 9) compression_level = 9;
+    if (png_filter < PNG_FILTER_ADAPTIVE || png_filter > PNG_FILTER_PAETH) {
+        png_filter = PNG_FILTER_ADAPTIVE;
+    }
+
+    WriteContext ctx;
+    ctx.capacity = width * height * channels * 2;  // Initial estimate (PNG is compressed)
+    ctx.size = 0;
+    ctx.data = (uint8_t*)malloc(ctx.capacity);
+
+    if (ctx.data == NULL) {
+        return -1;
+    }
+
+    // Encoder settings are passed per call (no shared stb_image_write globals)
+    int result = stbi_write_png_to_func_ex(
+        write_func, &ctx,
+        width, height, channels,
+        pixels, width * channels,
+        compression_level, png_filter
+    );
+
+    if (result == 0) {
+        free(ctx.data);
+        return -1;
+    }
+
+    // Shrink buffer to actual size
+    *output_data = (uint8_t*)realloc(ctx.data, ctx.size);
+    *output_size = ctx.size;
+    return 0;
+}
+
+// ============================================================================
+// JPEG resize
+// ============================================================================
+
+// Pick the largest reduced-size JPEG decode (shift 0..3 = 1/1..1/8) whose
+// crop region is still at least as large as the requested output, so the
+// decoder skips most of the IDCT and color conversion work and the bicubic
+// pass only has to cover the remaining factor. crop_width/crop_height are
+// the crop size on the full-size image.
+static int jpeg_scale_shift(int crop_width, int crop_height, int output_width, int output_height) {
+    for (int shift = 3; shift > 0; shift--) {
+        if ((crop_width >> shift) >= output_width && (crop_height >> shift) >= output_height) {
+            return shift;
+        }
+    }
+    return 0;
+}
+
+// Map one axis of a full-size crop (start, size) onto an image decoded at
+// 1/2^shift. The reduced image is full_size / 2^shift pixels rounded up, its
+// last pixel a partial DCT block that includes the encoder's padding; on a
+// flipped axis (EXIF flips and rotations of a decoded image) that partial
+// pixel comes first. *first/*count receive the whole reduced pixels covering
+// the crop, *s0/*s1 the exact crop within them (0-1, for the input subrect),
+// which never extends past the real image extent.
+static void scale_crop_axis(
+    int start, int size, int full_size, int shift, int flipped,
+    int* first, int* count, double* s0, double* s1
+) {
+    double scale = 1.0 / (1 << shift);
+    int reduced_size = (full_size + (1 << shift) - 1) >> shift;
+    double offset = flipped ? reduced_size - full_size * scale : 0.0;
+
+    double begin = start * scale + offset;
+    double end = (start + size) * scale + offset;
+    int last = (int)ceil(end);
+    if (last > reduced_size) last = reduced_size;
+
+    *first = (int)floor(begin);
+    *count = last - *first;
+    *s0 = (begin - *first) / *count;
+    *s1 = (end - *first) / *count;
+}
+
+// Map a rectangle of the EXIF-oriented image back onto the stored image
+// (width/height are the stored dimensions); the inverse of apply_orientation.
+static void unorient_rect(
+    int orientation, int width, int height,
+    int* x, int* y, int* w, int* h
+) {
+    int dx = *x, dy = *y, dw = *w, dh = *h;
+
+    switch (orientation) {
+        case 2:  // Flip horizontal
+            *x = width - dx - dw;
+            break;
+        case 3:  // Rotate 180
+            *x = width - dx - dw;
+            *y = height - dy - dh;
+            break;
+        case 4:  // Flip vertical
+            *y = height - dy - dh;
+            break;
+        case 5:  // Transpose
+            *x = dy;
+            *y = dx;
+            *w = dh;
+            *h = dw;
+            break;
+        case 6:  // Rotate 90 CW
+            *x = dy;
+            *y = height - dx - dw;
+            *w = dh;
+            *h = dw;
+            break;
+        case 7:  // Transverse
+            *x = width - dy - dh;
+            *y = height - dx - dw;
+            *w = dh;
+            *h = dw;
+            break;
+        case 8:  // Rotate 90 CCW
+            *x = width - dy - dh;
+            *y = dx;
+            *w = dh;
+            *h = dw;
+            break;
+        default:
+            break;
+    }
+}
+
+static int resize_jpeg_job(
+    const uint8_t* input_data,
+    int input_size,
+    int output_width,
+    int output_height,
+    int quality,
+    int chroma_subsampling,
+    int filter,
+    int edge_mode,
+    int color_space,
+    float reducing_gap,
+    float crop,
+    int crop_anchor,
+    int aspect_mode,
+    float aspect_w,
+    float aspect_h,
+    int apply_exif,
+    int num_threads,
+    uint8_t** output_data,
+    int* output_size
+) {
+    if (input_data == NULL || output_data == NULL || output_size == NULL) {
+        return -1;
+    }
+    if (input_size <= 0 || output_width <= 0 || output_height <= 0) {
+        return -1;
+    }
+
+    // Parse EXIF orientation before decoding (if enabled)
+    int orientation = 1;  // Default: no transformation
+    if (apply_exif) {
+        orientation = parse_exif_orientation(input_data, input_size);
+    }
+
+    // Read dimensions from the header (orientations 5-8 swap width and height)
+    int src_width, src_height, src_channels;
+    if (!stbi_info_from_memory(input_data, input_size, &src_width, &src_height, &src_channels)) {
+        return -1;
+    }
+    int oriented_width = (orientation >= 5) ? src_height : src_width;
+    int oriented_height = (orientation >= 5) ? src_width : src_height;
+
+    // Grayscale JPEGs stay single-channel through resize and encode
+    int channels = (src_channels == 1) ? 1 : 3;
+
+    // Calculate crop region on the full-size oriented image
+    int crop_x, crop_y, crop_width, crop_height;
+    calc_crop(oriented_width, oriented_height, crop, crop_anchor, aspect_mode, aspect_w, aspect_h,
+              &crop_x, &crop_y, &crop_width, &crop_height);
+
+    // Reduce in the DCT domain when the output is much smaller
+    int scale_shift = jpeg_scale_shift(crop_width, crop_height, output_width, output_height);
+
+    // Decode only the reduced stored-image pixels under the crop; the exact
+    // crop within them is resampled through the input subrect
+    unorient_rect(orientation, src_width, src_height,
+                  &crop_x, &crop_y, &crop_width, &crop_height);
+    int region_x, region_y, region_width, region_height;
+    double s0, t0, s1, t1;
+    scale_crop_axis(crop_x, crop_width, src_width, scale_shift, 0,
+                    &region_x, &region_width, &s0, &s1);
+    scale_crop_axis(crop_y, crop_height, src_height, scale_shift, 0,
+                    &region_y, &region_height, &t0, &t1);
+
+    uint8_t* src_pixels = stbi_load_jpeg_from_memory_region(
+        input_data, input_size,
+        &src_width, &src_height, &src_channels,
+        channels,
+        scale_shift, region_x, region_y, region_width, region_height
+    );
+
+    if (src_pixels == NULL) {
+        return -1;
+    }
+
+    // Resize in stored orientation; EXIF orientation is applied to the much
+    // smaller output afterwards (orientations 5-8 swap width and height)
+    int resize_width = (orientation >= 5) ? output_height : output_width;
+    int resize_height = (orientation >= 5) ? output_width : output_height;
+    if (orientation >= 5) {
+        // Per-axis settings refer to the output axes, which are transposed
+        filter = swap_axes(filter);
+        edge_mode = swap_axes(edge_mode);
+    }
+
+    // Allocate output pixel buffer
+    uint8_t* dst_pixels = (uint8_t*)arena_malloc(output_width * output_height * channels);
+    if (dst_pixels == NULL) {
+        stbi_image_free(src_pixels);
+        return -1;
+    }
+
+    // Resize using selected filter (from cropped region)
+    int resize_result = resize_pixels_subrect(
+        src_pixels,
+        src_width,
+        src_height,
+        src_width * channels,
+        s0, t0, s1, t1,
+        dst_pixels,
+        resize_width,
+        resize_height,
+        resize_width * channels,
+        pixel_layout(channels),
+        ALPHA_STRAIGHT,
+        filter,
+        edge_mode,
+        color_space,
+        reducing_gap,
+        num_threads
+    );
+
+    stbi_image_free(src_pixels);
+
+    if (resize_result != 0) {
+        arena_free(dst_pixels);
+        return -1;
+    }
+
+    // Apply EXIF orientation to the resized pixels
+    uint8_t* oriented = apply_orientation(dst_pixels, &resize_width, &resize_height, channels, orientation);
+    if (orientation != 1 && oriented == dst_pixels) {
+        arena_free(dst_pixels);  // orientation buffer allocation failed
+        return -1;
+    }
+    dst_pixels = oriented;
+
+    // Encode to JPEG
+    int result = encode_jpeg(dst_pixels, output_width, output_height, channels,
+                             quality, chroma_subsampling, output_data, output_size);
+
+    arena_free(dst_pixels);
+    return result;
+}
+
+FFI_EXPORT int bicubic_resize_jpeg(
+    const uint8_t* input_data,
+    int input_size,
+    int output_width,
+    int output_height,
+    int quality,
+    int chroma_subsampling,
+    int filter,
+    int edge_mode,
+    int color_space,
+    float reducing_gap,
+    float crop,
+    int crop_anchor,
+    int aspect_mode,
+    float aspect_w,
+    float aspect_h,
+    int apply_exif,
+    int num_threads,
+    uint8_t** output_data,
+    int* output_size
+) {
+    JobArena* arena = arena_begin();
+    int result = resize_jpeg_job(
+        input_data, input_size, output_width, output_height, quality, chroma_subsampling,
+        filter, edge_mode, color_space, reducing_gap, crop, crop_anchor, aspect_mode,
+        aspect_w, aspect_h, apply_exif, num_threads, output_data, output_size
+    );
+    arena_end(arena);
+    return result;
+}
+
+// ============================================================================
+// PNG resize
+// ============================================================================
+
+// Decode a PNG in its own channel count: gray, gray+alpha, RGB or RGBA
+// (palette images expand to the narrowest of these that holds the palette).
+// An alpha channel that is 255 everywhere is dropped. Free with
+// stbi_image_free.
+static uint8_t* load_png_pixels(
+    const uint8_t* input_data, int input_size,
+    int* width, int* height, int* channels
+) {
+    uint8_t* pixels = stbi_load_from_memory(
+        input_data, input_size,
+        width, height, channels,
+        0  // Keep original channels
+    );
+    if (pixels == NULL) {
+        return NULL;
+    }
+
+    // Screenshots often carry a fully opaque alpha channel; resampling,
+    // filtering and deflating them as gray/RGB saves a quarter of the work
+    if ((*channels == 2 || *channels == 4) &&
+        alpha_is_opaque(pixels, *width, *height, *width * *channels, *channels)) {
+        drop_alpha(pixels, (size_t)*width * *height, *channels);
+        (*channels)--;
+    }
+    return pixels;
+}
+
+// Decoded PNGs at least this large are resampled row by row from the inflate
+// stream instead of being decoded in full first
+#define PNG_STREAM_MIN_BYTES (32LL * 1024 * 1024)
+
+// Recently decoded rows of a streamed PNG. stb_image_resize2 pulls each input
+// row once and in order, apart from re-reads near the top and bottom edges
+// (clamp/reflect), so a ring spanning the vertical filter support suffices.
+typedef struct {
+    stbi_png_stream* stream;
+    uint8_t* rows;
+    int ring_rows;
+    size_t row_bytes;
+    int decoded;      // rows read from the stream so far
+    int crop_x;
+    int crop_y;
+    int channels;
+    int failed;
+    int reduce;            // rows are box-averaged first (reducing gap)
+    BoxReduce box;
+    void* acc;
+    uint8_t* reduced_row;
+    int reduced_y;         // row held in reduced_row, -1 = none
+} PngRowSource;
+
+// Row y of the crop region, starting at its first pixel; NULL for corrupt
+// data or a row that already left the ring
+static const uint8_t* png_stream_source_row(PngRowSource* src, int y) {
+    int row = src->crop_y + y;
+
+    while (src->decoded <= row && !src->failed) {
+        uint8_t* slot = src->rows + (size_t)(src->decoded % src->ring_rows) * src->row_bytes;
+        if (stbi_png_stream_read_row(src->stream, slot)) {
+            src->decoded++;
+        } else {
+            src->failed = 1;
+        }
+    }
+
+    if (src->failed || row < src->decoded - src->ring_rows) {
+        src->failed = 1;
+        return NULL;
+    }
+
+    return src->rows + (size_t)(row % src->ring_rows) * src->row_bytes
+                     + (size_t)src->crop_x * src->channels;
+}
+
+// Row y of the box-reduced crop region, averaged from its block of source rows
+static const uint8_t* png_stream_reduced_row(PngRowSource* src, int y) {
+    if (y == src->reduced_y) {
+        return src->reduced_row;
+    }
+
+    const uint8_t* rows[MAX_REDUCE_FACTOR];
+    int y0 = y * src->box.factor_y;
+    int row_count = src->box.source_height - y0 < src->box.factor_y
+                        ? src->box.source_height - y0 : src->box.factor_y;
+    for (int r = 0; r < row_count; r++) {
+        rows[r] = png_stream_source_row(src, y0 + r);
+        if (rows[r] == NULL) {
+            return NULL;
+        }
+    }
+
+    box_reduce_row(&src->box, rows, row_count, src->acc, src->reduced_row);
+    src->reduced_y = y;
+    return src->reduced_row;
+}
+
+// stb_image_resize2 input callback: row y of the (reduced) crop region
+static const void* png_stream_row(
+    void* optional_output, const void* input_ptr,
+    int num_pixels, int x, int y, void* context
+) {
+    PngRowSource* src = (PngRowSource*)context;
+    (void)input_ptr;
+
+    const uint8_t* row = src->reduce ? png_stream_reduced_row(src, y)
+                                     : png_stream_source_row(src, y);
+
+    // Corrupt data or a row that already left the ring: fail the resize
+    if (row == NULL) {
+        memset(optional_output, 0, (size_t)num_pixels * src->channels);
+        return optional_output;
+    }
+
+    return row + (size_t)x * src->channels;
+}
+
+// Resize a large PNG without materializing its decoded pixels: peak memory
+// is the ring of source rows plus the output instead of the whole image.
+// Returns 1 with *dst_pixels (arena memory) and *channels set, 0 if the PNG
+// is small or cannot be streamed (decode it in full instead), -1 on error
+static int resize_png_streamed(
+    const uint8_t* input_data,
+    int input_size,
+    int output_width,
+    int output_height,
+    int filter,
+    int edge_mode,
+    int color_space,
+    float reducing_gap,
+    float crop,
+    int crop_anchor,
+    int aspect_mode,
+    float aspect_w,
+    float aspect_h,
+    uint8_t** dst_pixels,
+    int* channels
+) {
+    // Vertically wrapped edges read the opposite border rows, which the stream
+    // has already passed or not yet reached
+    if (axis_value(edge_mode, 1) == EDGE_WRAP) {
+        return 0;
+    }
+
+    int width, height, comp;
+    if (!stbi_info_from_memory(input_data, input_size, &width, &height, &comp) ||
+        (long long)width * height * comp < PNG_STREAM_MIN_BYTES) {
+        return 0;
+    }
+
+    // Zero edges fade an opaque image to black once its alpha is dropped,
+    // but to transparent if alpha is kept; only a full decode knows which
+    if ((axis_value(edge_mode, 0) == EDGE_ZERO || axis_value(edge_mode, 1) == EDGE_ZERO) &&
+        (comp == 2 || comp == 4)) {
+        return 0;
+    }
+
+    PngRowSource src;
+    memset(&src, 0, sizeof(src));
+    src.stream = stbi_png_stream_open(input_data, input_size, &width, &height, &src.channels);
+    if (src.stream == NULL) {
+        return 0;  // Interlaced, sub-byte depth or color-keyed
+    }
+
+    int crop_x, crop_y, crop_width, crop_height;
+    calc_crop(width, height, crop, crop_anchor, aspect_mode, aspect_w, aspect_h,
+              &crop_x, &crop_y, &crop_width, &crop_height);
+
+    int ch = src.channels;
+
+    // With a reducing gap the resampler reads rows box-averaged from blocks
+    // of factor_y source rows
+    int resize_width = crop_width;
+    int resize_height = crop_height;
+    int block_rows = 1;
+    src.reduced_y = -1;
+    src.reduce = box_reduce_init(&src.box, crop_width, crop_height, output_width, output_height,
+                                 pixel_layout(ch), get_stbir_datatype(color_space), reducing_gap);
+    if (src.reduce) {
+        resize_width = src.box.width;
+        resize_height = src.box.height;
+        block_rows = src.box.factor_y;
+    }
+
+    // The cubic kernels reach 2 source pixels each way, scaled up when
+    // downsampling; the margin covers reflected rows at the edges
+    src.crop_x = crop_x;
+    src.crop_y = crop_y;
+    src.row_bytes = (size_t)width * ch;
+    src.ring_rows = (4 * ((resize_height + output_height - 1) / output_height) + 4) * block_rows;
+    if (src.ring_rows > height) src.ring_rows = height;
+
+    src.rows = (uint8_t*)arena_malloc((size_t)src.ring_rows * src.row_bytes);
+    if (src.reduce) {
+        src.acc = arena_malloc((size_t)crop_width * ch * sizeof(uint32_t));
+        src.reduced_row = (uint8_t*)arena_malloc((size_t)resize_width * ch);
+    }
+    uint8_t* pixels = (uint8_t*)arena_malloc((size_t)output_width * output_height * ch);
+    if (src.rows == NULL || pixels == NULL ||
+        (src.reduce && (src.acc == NULL || src.reduced_row == NULL))) {
+        arena_free(pixels);
+        arena_free(src.reduced_row);
+        arena_free(src.acc);
+        arena_free(src.rows);
+        stbi_png_stream_close(src.stream);
+        return -1;
+    }
+
+    STBIR_RESIZE resize;
+    stbir_resize_init(
+        &resize,
+        NULL, resize_width, resize_height, 0,
+        pixels, output_width, output_height, output_width * ch,
+        pixel_layout(ch), get_stbir_datatype(color_space)
+    );
+    if (src.reduce) {
+        box_reduce_subrect(&resize, &src.box);
+    }
+    set_filters_and_edges(&resize, filter, edge_mode);
+    stbir_set_pixel_callbacks(&resize, png_stream_row, NULL);
+    stbir_set_user_data(&resize, &src);
+
+    // Rows come off the stream in order, so the resample runs on one thread
+    int result = run_resize(&resize, 1);
+
+    stbi_png_stream_close(src.stream);
+    arena_free(src.reduced_row);
+    arena_free(src.acc);
+    arena_free(src.rows);
+
+    if (result != 0 || src.failed) {
+        arena_free(pixels);
+        return -1;
+    }
+
+    // As in load_png_pixels, an alpha channel that is 255 everywhere is
+    // dropped (here after the resample, since the source is never whole)
+    if ((ch == 2 || ch == 4) &&
+        alpha_is_opaque(pixels, output_width, output_height, output_width * ch, ch)) {
+        drop_alpha(pixels, (size_t)output_width * output_height, ch);
+        ch--;
+    }
+
+    *dst_pixels = pixels;
+    *channels = ch;
+    return 1;
+}
+
+static int resize_png_job(
+    const uint8_t* input_data,
+    int input_size,
+    int output_width,
+    int output_height,
+    int filter,
+    int edge_mode,
+    int color_space,
+    float reducing_gap,
+    float crop,
+    int crop_anchor,
+    int aspect_mode,
+    float aspect_w,
+    float aspect_h,
+    int compression_level,
+    int png_filter,
+    int num_threads,
+    uint8_t** output_data,
+    int* output_size
+) {
+    if (input_data == NULL || output_data == NULL || output_size == NULL) {
+        return -1;
+    }
+    if (input_size <= 0 || output_width <= 0 || output_height <= 0) {
+        return -1;
+    }
+
+    // Very large PNGs are resampled straight from the inflate stream
+    int channels;
+    uint8_t* dst_pixels = NULL;
+    int streamed = resize_png_streamed(
+        input_data, input_size, output_width, output_height, filter, edge_mode,
+        color_space, reducing_gap, crop, crop_anchor, aspect_mode, aspect_w, aspect_h,
+        &dst_pixels, &channels
+    );
+    if (streamed < 0) {
+        return -1;
+    }
+    if (streamed) {
+        int result = encode_png(dst_pixels, output_width, output_height, channels,
+                                compression_level, png_filter, output_data, output_size);
+        arena_free(dst_pixels);
+        return result;
+    }
+
+    // Decode PNG (preserve alpha if present)
+    int src_width, src_height;
+    uint8_t* src_pixels = load_png_pixels(input_data, input_size,
+                                          &src_width, &src_height, &channels);
+    if (src_pixels == NULL) {
+        return -1;
+    }
+
+    // Calculate crop region
     int crop_x, crop_y, crop_width, crop_height;
     calc_crop(src_width, src_height, crop, crop_anchor, aspect_mode, aspect_w, aspect_h,
               &crop_x, &crop_y, &crop_width, &crop_height);
 
-    // Get pointer to start of cropped region
-    const uint8_t* crop_start = src_pixels + (crop_y * src_width + crop_x) * channels;
+    // Get pointer to start of cropped region
+    const uint8_t* crop_start = src_pixels + (crop_y * src_width + crop_x) * channels;
+
+    // Allocate output pixel buffer
+    dst_pixels = (uint8_t*)arena_malloc(output_width * output_height * channels);
+    if (dst_pixels == NULL) {
+        stbi_image_free(src_pixels);
+        return -1;
+    }
+
+    // Resize using selected filter (from cropped region)
+    int resize_result = resize_pixels(
+        crop_start,
+        crop_width,
+        crop_height,
+        src_width * channels,  // Original stride
+        dst_pixels,
+        output_width,
+        output_height,
+        output_width * channels,
+        pixel_layout(channels),
+        ALPHA_STRAIGHT,
+        filter,
+        edge_mode,
+        color_space,
+        reducing_gap,
+        num_threads
+    );
+
+    stbi_image_free(src_pixels);
+
+    if (resize_result != 0) {
+        arena_free(dst_pixels);
+        return -1;
+    }
+
+    // Encode to PNG
+    int result = encode_png(dst_pixels, output_width, output_height, channels,
+                            compression_level, png_filter, output_data, output_size);
+
+    arena_free(dst_pixels);
+    return result;
+}
+
+FFI_EXPORT int bicubic_resize_png(
+    const uint8_t* input_data,
+    int input_size,
+    int output_width,
+    int output_height,
+    int filter,
+    int edge_mode,
+    int color_space,
+    float reducing_gap,
+    float crop,
+    int crop_anchor,
+    int aspect_mode,
+    float aspect_w,
+    float aspect_h,
+    int compression_level,
+    int png_filter,
+    int num_threads,
+    uint8_t** output_data,
+    int* output_size
+) {
+    JobArena* arena = arena_begin();
+    int result = resize_png_job(
+        input_data, input_size, output_width, output_height,
+        filter, edge_mode, color_space, reducing_gap, crop, crop_anchor, aspect_mode,
+        aspect_w, aspect_h, compression_level, png_filter, num_threads, output_data, output_size
+    );
+    arena_end(arena);
+    return result;
+}
+
+// ============================================================================
+// Batch resize
+// ============================================================================
+
+static int is_jpeg(const uint8_t* data, int size) {
+    return size >= 3 && data[0] == 0xFF && data[1] == 0xD8 && data[2] == 0xFF;
+}
+
+static int is_png(const uint8_t* data, int size) {
+    return size >= 4 && data[0] == 0x89 && data[1] == 0x50 && data[2] == 0x4E && data[3] == 0x47;
+}
+
+static void batch_item_task(void* ctx, int index) {
+    BicubicBatchItem* item = (BicubicBatchItem*)ctx + index;
+
+    item->output_data = NULL;
+    item->output_size = 0;
+    item->result = -1;
+
+    if (item->input_data == NULL) {
+        return;
+    }
+
+    // Items already run in parallel, so each resize stays on its own thread
+    if (is_jpeg(item->input_data, item->input_size)) {
+        item->result = bicubic_resize_jpeg(
+            item->input_data, item->input_size,
+            item->output_width, item->output_height, item->quality, item->chroma_subsampling,
+            item->filter, item->edge_mode, item->color_space, item->reducing_gap,
+            item->crop, item->crop_anchor, item->aspect_mode, item->aspect_w, item->aspect_h,
+            item->apply_exif,
+            1, &item->output_data, &item->output_size
+        );
+    } else if (is_png(item->input_data, item->input_size)) {
+        item->result = bicubic_resize_png(
+            item->input_data, item->input_size,
+            item->output_width, item->output_height,
+            item->filter, item->edge_mode, item->color_space, item->reducing_gap,
+            item->crop, item->crop_anchor, item->aspect_mode, item->aspect_w, item->aspect_h,
+            item->compression_level, item->png_filter,
+            1, &item->output_data, &item->output_size
+        );
+    }
+}
+
+FFI_EXPORT int bicubic_resize_batch(
+    BicubicBatchItem* items,
+    int count,
+    int num_threads
+) {
+    if (items == NULL || count < 0) {
+        return -1;
+    }
+
+    parallel_for(count, num_threads, batch_item_task, items);
+
+    for (int i = 0; i < count; i++) {
+        if (items[i].result != 0) return -1;
+    }
+    return 0;
+}
+
+// ============================================================================
+// Multi-rendition resize (decode once, many output sizes)
+// ============================================================================
+
+// A rendition is resampled from a larger, already produced rendition of the
+// same crop window and resampling settings instead of the source when that
+// one is at least this many times larger on both axes, so the extra
+// resampling pass stays visually negligible while touching far fewer pixels.
+#define MULTI_CASCADE_FACTOR 2
+
+typedef struct {
+    BicubicOutputSpec* specs;
+    uint8_t** pixels;  // resized pixels of each spec
+    int channels;
+} MultiEncodeContext;
+
+static void multi_encode_task(void* ctx, int index) {
+    MultiEncodeContext* multi = (MultiEncodeContext*)ctx;
+    BicubicOutputSpec* spec = &multi->specs[index];
+
+    if (multi->pixels[index] == NULL) {
+        return;
+    }
+
+    if (spec->format == OUTPUT_FORMAT_PNG) {
+        spec->result = encode_png(multi->pixels[index], spec->output_width, spec->output_height,
+                                  multi->channels, spec->compression_level, spec->png_filter,
+                                  &spec->output_data, &spec->output_size);
+    } else {
+        spec->result = encode_jpeg(multi->pixels[index], spec->output_width, spec->output_height,
+                                   multi->channels, spec->quality, spec->chroma_subsampling,
+                                   &spec->output_data, &spec->output_size);
+    }
+}
+
+// Decode a whole JPEG/PNG with EXIF orientation applied (JPEG, apply_exif=1);
+// JPEGs are reduced by scale_shift in the DCT domain. JPEGs decode to RGB
+// (gray when grayscale), PNGs in their own channel count. Returns the pixels
+// (free with stbi_image_free), or NULL on error.
+static uint8_t* decode_oriented(
+    const uint8_t* input_data, int input_size, int apply_exif, int scale_shift,
+    int* width, int* height, int* channels
+) {
+    if (is_png(input_data, input_size)) {
+        return load_png_pixels(input_data, input_size, width, height, channels);
+    }
+    if (!is_jpeg(input_data, input_size)) {
+        return NULL;
+    }
+
+    // Grayscale JPEGs stay single-channel
+    int src_width, src_height, src_channels;
+    if (!stbi_info_from_memory(input_data, input_size, &src_width, &src_height, &src_channels)) {
+        return NULL;
+    }
+    *channels = (src_channels == 1) ? 1 : 3;
+
+    uint8_t* pixels = stbi_load_jpeg_from_memory_scaled(
+        input_data, input_size, width, height, &src_channels, *channels, scale_shift
+    );
+    if (pixels == NULL) {
+        return NULL;
+    }
+
+    int orientation = apply_exif ? parse_exif_orientation(input_data, input_size) : 1;
+    uint8_t* oriented = apply_orientation(pixels, width, height, *channels, orientation);
+    if (orientation != 1 && oriented == pixels) {
+        stbi_image_free(pixels);  // orientation buffer allocation failed
+        return NULL;
+    }
+    return oriented;
+}
+
+// Decode the source once (EXIF orientation applied) for all specs
+// *full_width/*full_height receive the oriented size before any DCT-domain
+// reduction, *scale_shift and *orientation how the pixels were decoded.
+// Returns the pixels (free with stbi_image_free), or NULL on error
+static uint8_t* multi_decode(
+    const uint8_t* input_data, int input_size,
+    const BicubicOutputSpec* specs, int count, int apply_exif,
+    int* width, int* height, int* channels,
+    int* full_width, int* full_height, int* scale_shift, int* orientation
+) {
+    *scale_shift = 0;
+    *orientation = 1;
+
+    if (is_jpeg(input_data, input_size)) {
+        *orientation = apply_exif ? parse_exif_orientation(input_data, input_size) : 1;
+
+        int src_width, src_height, src_channels;
+        if (!stbi_info_from_memory(input_data, input_size, &src_width, &src_height, &src_channels)) {
+            return NULL;
+        }
+        *full_width = (*orientation >= 5) ? src_height : src_width;
+        *full_height = (*orientation >= 5) ? src_width : src_height;
+
+        // The largest rendition decides how far the DCT-domain reduction can go
+        *scale_shift = 3;
+        for (int i = 0; i < count; i++) {
+            int crop_x, crop_y, crop_width, crop_height;
+            calc_crop(*full_width, *full_height, specs[i].crop, specs[i].crop_anchor,
+                      specs[i].aspect_mode, specs[i].aspect_w, specs[i].aspect_h,
+                      &crop_x, &crop_y, &crop_width, &crop_height);
+            int shift = jpeg_scale_shift(crop_width, crop_height,
+                                         specs[i].output_width, specs[i].output_height);
+            if (shift < *scale_shift) *scale_shift = shift;
+        }
+    }
+
+    uint8_t* pixels = decode_oriented(input_data, input_size, apply_exif, *scale_shift,
+                                      width, height, channels);
+    if (pixels != NULL && *scale_shift == 0) {
+        *full_width = *width;
+        *full_height = *height;
+    }
+    return pixels;
+}
+
+static int resize_multi_job(
+    const uint8_t* input_data,
+    int input_size,
+    BicubicOutputSpec* specs,
+    int count,
+    int apply_exif,
+    int num_threads
+) {
+    for (int i = 0; i < count; i++) {
+        specs[i].output_data = NULL;
+        specs[i].output_size = 0;
+        specs[i].result = -1;
+    }
+
+    int src_width, src_height, channels, full_width, full_height, scale_shift, orientation;
+    uint8_t* src_pixels = multi_decode(input_data, input_size, specs, count, apply_exif,
+                                       &src_width, &src_height, &channels,
+                                       &full_width, &full_height, &scale_shift, &orientation);
+    if (src_pixels == NULL) {
+        return -1;
+    }
+
+    // Axes of the oriented pixels that run opposite to the stored image's
+    // (see unorient_rect); their partial DCT block comes first
+    int flip_x = orientation == 2 || orientation == 3 || orientation == 6 || orientation == 7;
+    int flip_y = orientation == 3 || orientation == 4 || orientation == 7 || orientation == 8;
+
+    uint8_t** pixels = (uint8_t**)arena_malloc(sizeof(uint8_t*) * count);
+    int* order = (int*)arena_malloc(sizeof(int) * count);
+    int* crops = (int*)arena_malloc(sizeof(int) * 4 * count);
+    if (pixels == NULL || order == NULL || crops == NULL) {
+        arena_free(crops);
+        arena_free(order);
+        arena_free(pixels);
+        stbi_image_free(src_pixels);
+        return -1;
+    }
+
+    // Largest renditions first, so smaller ones can be cascaded from them
+    for (int i = 0; i < count; i++) {
+        int j = i;
+        int64_t area = (int64_t)specs[i].output_width * specs[i].output_height;
+        while (j > 0 && (int64_t)specs[order[j - 1]].output_width * specs[order[j - 1]].output_height < area) {
+            order[j] = order[j - 1];
+            j--;
+        }
+        order[j] = i;
+        pixels[i] = NULL;
+    }
+
+    for (int k = 0; k < count; k++) {
+        int i = order[k];
+        BicubicOutputSpec* spec = &specs[i];
+        int* crop = &crops[i * 4];
+        if (spec->output_width <= 0 || spec->output_height <= 0) {
+            continue;
+        }
+
+        // Crop on the full-size image, then map it onto the reduced decode
+        calc_crop(full_width, full_height, spec->crop, spec->crop_anchor,
+                  spec->aspect_mode, spec->aspect_w, spec->aspect_h,
+                  &crop[0], &crop[1], &crop[2], &crop[3]);
+
+        // Nearest larger rendition of the same crop window and resampling
+        // settings (filter, edges, color space, reducing gap), if any
+        int parent = -1;
+        for (int m = 0; m < k; m++) {
+            int j = order[m];
+            const int* other = &crops[j * 4];
+            if (pixels[j] == NULL || memcmp(other, crop, sizeof(int) * 4) != 0) continue;
+            if (specs[j].filter != spec->filter || specs[j].edge_mode != spec->edge_mode ||
+                specs[j].color_space != spec->color_space ||
+                specs[j].reducing_gap != spec->reducing_gap) continue;
+            if (specs[j].output_width < spec->output_width * MULTI_CASCADE_FACTOR ||
+                specs[j].output_height < spec->output_height * MULTI_CASCADE_FACTOR) continue;
+            parent = j;
+        }
+
+        const uint8_t* from;
+        int from_width, from_height, from_stride;
+        double s0 = 0.0, t0 = 0.0, s1 = 1.0, t1 = 1.0;
+        if (parent >= 0) {
+            from = pixels[parent];
+            from_width = specs[parent].output_width;
+            from_height = specs[parent].output_height;
+            from_stride = from_width * channels;
+        } else {
+            int from_x, from_y;
+            scale_crop_axis(crop[0], crop[2], full_width, scale_shift, flip_x,
+                            &from_x, &from_width, &s0, &s1);
+            scale_crop_axis(crop[1], crop[3], full_height, scale_shift, flip_y,
+                            &from_y, &from_height, &t0, &t1);
+            from = src_pixels + ((size_t)from_y * src_width + from_x) * channels;
+            from_stride = src_width * channels;
+        }
 
-    // Allocate output pixel buffer
-    uint8_t* dst_pixels = (uint8_t*)malloc(output_width * output_height * channels);
+        pixels[i] = (uint8_t*)arena_malloc((size_t)spec->output_width * spec->output_height * channels);
+        if (pixels[i] == NULL) continue;
+
+        if (resize_pixels_subrect(from, from_width, from_height, from_stride, s0, t0, s1, t1,
+                                  pixels[i], spec->output_width, spec->output_height,
+                                  spec->output_width * channels,
+                                  pixel_layout(channels), ALPHA_STRAIGHT,
+                                  spec->filter, spec->edge_mode, spec->color_space,
+                                  spec->reducing_gap, num_threads) != 0) {
+            arena_free(pixels[i]);
+            pixels[i] = NULL;
+        }
+    }
+
+    // Encoders are single-threaded, so run the renditions side by side
+    MultiEncodeContext ctx;
+    ctx.specs = specs;
+    ctx.pixels = pixels;
+    ctx.channels = channels;
+    parallel_for(count, num_threads, multi_encode_task, &ctx);
+
+    for (int i = count - 1; i >= 0; i--) {
+        arena_free(pixels[i]);
+    }
+    arena_free(crops);
+    arena_free(order);
+    arena_free(pixels);
+    stbi_image_free(src_pixels);
+
+    for (int i = 0; i < count; i++) {
+        if (specs[i].result != 0) return -1;
+    }
+    return 0;
+}
+
+FFI_EXPORT int bicubic_resize_multi(
+    const uint8_t* input_data,
+    int input_size,
+    BicubicOutputSpec* specs,
+    int count,
+    int apply_exif,
+    int num_threads
+) {
+    if (input_data == NULL || input_size <= 0 || specs == NULL || count <= 0) {
+        return -1;
+    }
+
+    JobArena* arena = arena_begin();
+    int result = resize_multi_job(input_data, input_size, specs, count, apply_exif, num_threads);
+    arena_end(arena);
+    return result;
+}
+
+// ============================================================================
+// Decoded image handles (decode once, crop/resize/encode many times)
+// ============================================================================
+
+struct BicubicImage {
+    uint8_t* pixels;  // EXIF-oriented, tightly packed; plain malloc
+    int width;
+    int height;
+    int channels;
+};
+
+FFI_EXPORT BicubicImage* bicubic_image_create(
+    const uint8_t* input_data,
+    int input_size,
+    int apply_exif
+) {
+    if (input_data == NULL || input_size <= 0) {
+        return NULL;
+    }
+
+    BicubicImage* image = (BicubicImage*)malloc(sizeof(BicubicImage));
+    if (image == NULL) {
+        return NULL;
+    }
+
+    // The pixels outlive any job, so they must never be carved from an arena
+    // (even when called from a thread that has one bound)
+    JobArena* bound = current_arena;
+    current_arena = NULL;
+    image->pixels = decode_oriented(input_data, input_size, apply_exif, 0,
+                                    &image->width, &image->height, &image->channels);
+    current_arena = bound;
+
+    if (image->pixels == NULL) {
+        free(image);
+        return NULL;
+    }
+    return image;
+}
+
+FFI_EXPORT int bicubic_image_info(
+    const BicubicImage* image,
+    int* width,
+    int* height,
+    int* channels
+) {
+    if (image == NULL || width == NULL || height == NULL || channels == NULL) {
+        return -1;
+    }
+    *width = image->width;
+    *height = image->height;
+    *channels = image->channels;
+    return 0;
+}
+
+FFI_EXPORT int bicubic_image_resize(
+    const BicubicImage* image,
+    uint8_t* output,
+    int output_width,
+    int output_height,
+    int filter,
+    int edge_mode,
+    int color_space,
+    float reducing_gap,
+    float crop,
+    int crop_anchor,
+    int aspect_mode,
+    float aspect_w,
+    float aspect_h,
+    int num_threads
+) {
+    if (image == NULL) {
+        return -1;
+    }
+
+    return resize_raw(image->pixels, image->width, image->height, 0,
+                      output, output_width, output_height, 0, image->channels,
+                      filter, edge_mode, color_space, ALPHA_STRAIGHT, reducing_gap,
+                      crop, crop_anchor, aspect_mode, aspect_w, aspect_h, num_threads);
+}
+
+static int image_encode_job(
+    const BicubicImage* image,
+    int output_width,
+    int output_height,
+    int format,
+    int quality,
+    int chroma_subsampling,
+    int compression_level,
+    int png_filter,
+    int filter,
+    int edge_mode,
+    int color_space,
+    float reducing_gap,
+    float crop,
+    int crop_anchor,
+    int aspect_mode,
+    float aspect_w,
+    float aspect_h,
+    int num_threads,
+    uint8_t** output_data,
+    int* output_size
+) {
+    uint8_t* dst_pixels = (uint8_t*)arena_malloc((size_t)output_width * output_height * image->channels);
     if (dst_pixels == NULL) {
-        stbi_image_free(src_pixels);
         return -1;
     }
 
-    // Resize using selected filter (from cropped region)
-    stbir_resize(
-        crop_start,
-        crop_width,
-        crop_height,
-        src_width * channels,  // Original stride
-        dst_pixels,
-        output_width,
-        output_height,
-        output_width * channels,
-        (channels == 4) ? STBIR_RGBA : STBIR_RGB,
-        STBIR_TYPE_UINT8,
-        get_stbir_edge(edge_mode),
-        get_stbir_filter(filter)
+    int result = bicubic_image_resize(image, dst_pixels, output_width, output_height,
+                                      filter, edge_mode, color_space, reducing_gap,
+                                      crop, crop_anchor, aspect_mode, aspect_w, aspect_h,
+                                      num_threads);
+    if (result == 0) {
+        if (format == OUTPUT_FORMAT_PNG) {
+            result = encode_png(dst_pixels, output_width, output_height, image->channels,
+                                compression_level, png_filter, output_data, output_size);
+        } else {
+            result = encode_jpeg(dst_pixels, output_width, output_height, image->channels,
+                                 quality, chroma_subsampling, output_data, output_size);
+        }
+    }
+
+    arena_free(dst_pixels);
+    return result;
+}
+
+FFI_EXPORT int bicubic_image_encode(
+    const BicubicImage* image,
+    int output_width,
+    int output_height,
+    int format,
+    int quality,
+    int chroma_subsampling,
+    int compression_level,
+    int png_filter,
+    int filter,
+    int edge_mode,
+    int color_space,
+    float reducing_gap,
+    float crop,
+    int crop_anchor,
+    int aspect_mode,
+    float aspect_w,
+    float aspect_h,
+    int num_threads,
+    uint8_t** output_data,
+    int* output_size
+) {
+    if (image == NULL || output_data == NULL || output_size == NULL) {
+        return -1;
+    }
+    if (output_width <= 0 || output_height <= 0) {
+        return -1;
+    }
+
+    JobArena* arena = arena_begin();
+    int result = image_encode_job(
+        image, output_width, output_height, format,
+        quality, chroma_subsampling, compression_level, png_filter,
+        filter, edge_mode, color_space, reducing_gap, crop, crop_anchor, aspect_mode,
+        aspect_w, aspect_h, num_threads, output_data, output_size
     );
+    arena_end(arena);
+    return result;
+}
 
-    stbi_image_free(src_pixels);
+FFI_EXPORT void bicubic_image_destroy(BicubicImage* image) {
+    if (image != NULL) {
+        free(image->pixels);
+        free(image);
+    }
+}
 
-    // Set PNG compression level
-    stbi_write_png_compression_level = compression_level;
+// ============================================================================
+// Image probing (header only, no pixel decode)
+// ============================================================================
 
-    // Encode to PNG
-    WriteContext ctx;
-    ctx.capacity = output_width * output_height * channels * 2;  // Initial estimate (PNG is compressed)
-    ctx.size = 0;
-    ctx.data = (uint8_t*)malloc(ctx.capacity);
+// Scan JPEG markers up to the frame header (SOFn)
+// Returns 0 and fills bit depth / progressive flag, -1 if no frame header was found
+static int jpeg_frame_info(const uint8_t* data, int size, int* bit_depth, int* progressive) {
+    int offset = 2;
+    while (offset + 4 < size) {
+        if (data[offset] != 0xFF) return -1;
 
-    if (ctx.data == NULL) {
-        free(dst_pixels);
+        uint8_t marker = data[offset + 1];
+
+        // Skip padding bytes
+        if (marker == 0xFF) {
+            offset++;
+            continue;
+        }
+
+        // Standalone markers have no length field
+        if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD7)) {
+            offset += 2;
+            continue;
+        }
+
+        // SOF0-SOF15, except DHT (0xC4), JPG (0xC8) and DAC (0xCC)
+        if (marker >= 0xC0 && marker <= 0xCF && marker != 0xC4 && marker != 0xC8 && marker != 0xCC) {
+            *bit_depth = data[offset + 4];
+            *progressive = (marker & 0x03) == 0x02;  // SOF2, SOF6, SOF10, SOF14
+            return 0;
+        }
+
+        // Start of scan / end of image before any frame header
+        if (marker == 0xDA || marker == 0xD9) return -1;
+
+        int segment_length = (data[offset + 2] << 8) | data[offset + 3];
+        offset += 2 + segment_length;
+    }
+    return -1;
+}
+
+FFI_EXPORT int bicubic_probe(
+    const uint8_t* input_data,
+    int input_size,
+    BicubicProbeInfo* info
+) {
+    if (info == NULL) {
         return -1;
     }
+    memset(info, 0, sizeof(*info));
+    info->result = -1;
 
-    int result = stbi_write_png_to_func(
-        write_func, &ctx,
-        output_width, output_height, channels,
-        dst_pixels, output_width * channels
-    );
+    if (input_data == NULL || input_size <= 0) {
+        return -1;
+    }
+
+    int bit_depth, progressive, orientation;
+    if (is_jpeg(input_data, input_size)) {
+        if (jpeg_frame_info(input_data, input_size, &bit_depth, &progressive) != 0) {
+            return -1;
+        }
+        orientation = parse_exif_orientation(input_data, input_size);
+        info->format = OUTPUT_FORMAT_JPEG;
+    } else if (is_png(input_data, input_size)) {
+        // IHDR is always the first chunk: width, height, bit depth, color type,
+        // compression, filter, interlace
+        if (input_size < 29 || memcmp(input_data + 12, "IHDR", 4) != 0) {
+            return -1;
+        }
+        bit_depth = input_data[24];
+        progressive = input_data[28] == 1;  // Adam7
+        orientation = 1;
+        info->format = OUTPUT_FORMAT_PNG;
+    } else {
+        return -1;
+    }
 
-    free(dst_pixels);
+    int width, height, channels;
+    if (!stbi_info_from_memory(input_data, input_size, &width, &height, &channels)) {
+        return -1;
+    }
 
-    if (result == 0) {
-        free(ctx.data);
+    info->width = (orientation >= 5) ? height : width;
+    info->height = (orientation >= 5) ? width : height;
+    info->channels = channels;
+    info->bit_depth = bit_depth;
+    info->orientation = orientation;
+    info->progressive = progressive;
+    info->result = 0;
+    return 0;
+}
+
+FFI_EXPORT int bicubic_probe_batch(
+    const uint8_t* const* inputs,
+    const int* input_sizes,
+    int count,
+    BicubicProbeInfo* infos
+) {
+    if (inputs == NULL || input_sizes == NULL || infos == NULL || count <= 0) {
         return -1;
     }
 
-    // Shrink buffer to actual size
-    *output_data = (uint8_t*)realloc(ctx.data, ctx.size);
-    *output_size = ctx.size;
+    // Header parsing is cheap; not worth spreading over the pool
+    int result = 0;
+    for (int i = 0; i < count; i++) {
+        if (bicubic_probe(inputs[i], input_sizes[i], &infos[i]) != 0) {
+            result = -1;
+        }
+    }
+    return result;
+}
+
+// ============================================================================
+// Async jobs (run on native threads, completion posted to a Dart port)
+// ============================================================================
+
+// Minimal mirror of Dart_CObject from dart_api.h - only the variants posted
+// here. Enum values and layout follow the Dart embedding API.
+typedef enum {
+    DART_COBJECT_NULL = 0,
+    DART_COBJECT_INT64 = 3,
+    DART_COBJECT_ARRAY = 6,
+    DART_COBJECT_EXTERNAL_TYPED_DATA = 8
+} DartCObjectType;
+
+#define DART_TYPED_DATA_UINT8 2
+
+typedef void (*DartHandleFinalizer)(void* isolate_callback_data, void* peer);
+
+typedef struct DartCObject {
+    DartCObjectType type;
+    union {
+        int64_t as_int64;
+        struct {
+            intptr_t length;
+            struct DartCObject** values;
+        } as_array;
+        struct {
+            int type;
+            intptr_t length;
+            uint8_t* data;
+            void* peer;
+            DartHandleFinalizer callback;
+        } as_external_typed_data;
+    } value;
+} DartCObject;
+
+typedef int8_t (*DartPostCObjectFn)(int64_t port, DartCObject* message);
+
+// Upper bound on threads running async jobs; each job still splits its own
+// resize across the worker pool
+#define MAX_ASYNC_THREADS 4
+
+// A queued job; specific jobs embed this as their first member
+typedef struct AsyncTask {
+    void (*run)(struct AsyncTask* task);
+    struct AsyncTask* next;
+} AsyncTask;
+
+static DartPostCObjectFn post_cobject = NULL;
+static pthread_once_t async_once = PTHREAD_ONCE_INIT;
+static pthread_mutex_t async_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t async_cond = PTHREAD_COND_INITIALIZER;
+static AsyncTask* async_head = NULL;
+static AsyncTask* async_tail = NULL;
+static int async_threads = 0;
+
+static void* async_worker_main(void* arg) {
+    (void)arg;
+    for (;;) {
+        pthread_mutex_lock(&async_mutex);
+        while (async_head == NULL) {
+            pthread_cond_wait(&async_cond, &async_mutex);
+        }
+        AsyncTask* task = async_head;
+        async_head = task->next;
+        if (async_head == NULL) async_tail = NULL;
+        pthread_mutex_unlock(&async_mutex);
+
+        task->run(task);
+    }
+    return NULL;
+}
+
+static void async_start(void) {
+    int threads = cpu_count();
+    if (threads > MAX_ASYNC_THREADS) threads = MAX_ASYNC_THREADS;
+
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    for (int i = 0; i < threads; i++) {
+        pthread_t thread;
+        if (pthread_create(&thread, &attr, async_worker_main, NULL) != 0) break;
+        async_threads++;
+    }
+    pthread_attr_destroy(&attr);
+}
+
+// Queue a task; returns 0 on success, -1 if no thread can run it
+static int async_submit(AsyncTask* task) {
+    pthread_once(&async_once, async_start);
+    if (async_threads == 0) return -1;
+
+    task->next = NULL;
+    pthread_mutex_lock(&async_mutex);
+    if (async_tail != NULL) {
+        async_tail->next = task;
+    } else {
+        async_head = task;
+    }
+    async_tail = task;
+    pthread_cond_signal(&async_cond);
+    pthread_mutex_unlock(&async_mutex);
+    return 0;
+}
+
+static void free_external(void* isolate_callback_data, void* peer) {
+    (void)isolate_callback_data;
+    free(peer);
+}
+
+// Fill a message value with a malloc'd buffer (ownership moves to Dart) or null
+static void set_output_object(DartCObject* object, uint8_t* data, int size) {
+    if (data == NULL) {
+        object->type = DART_COBJECT_NULL;
+        return;
+    }
+    object->type = DART_COBJECT_EXTERNAL_TYPED_DATA;
+    object->value.as_external_typed_data.type = DART_TYPED_DATA_UINT8;
+    object->value.as_external_typed_data.length = size;
+    object->value.as_external_typed_data.data = data;
+    object->value.as_external_typed_data.peer = data;
+    object->value.as_external_typed_data.callback = free_external;
+}
+
+// Post [result, outputs...] to a port. Each output arrives in Dart as a
+// Uint8List backed by the native buffer (freed by its finalizer); if the port
+// is already closed the buffers are freed here.
+static void post_result(int64_t port, int result, uint8_t** outputs, const int* sizes, int count) {
+    DartCObject* objects = (DartCObject*)malloc(sizeof(DartCObject) * (count + 2));
+    DartCObject** values = (DartCObject**)malloc(sizeof(DartCObject*) * (count + 1));
+    int posted = 0;
+
+    if (objects != NULL && values != NULL) {
+        DartCObject* message = &objects[count + 1];
+        objects[0].type = DART_COBJECT_INT64;
+        objects[0].value.as_int64 = result;
+        values[0] = &objects[0];
+        for (int i = 0; i < count; i++) {
+            set_output_object(&objects[i + 1], outputs[i], sizes[i]);
+            values[i + 1] = &objects[i + 1];
+        }
+        message->type = DART_COBJECT_ARRAY;
+        message->value.as_array.length = count + 1;
+        message->value.as_array.values = values;
+        posted = post_cobject(port, message) != 0;
+    }
+
+    if (!posted) {
+        for (int i = 0; i < count; i++) {
+            free(outputs[i]);
+        }
+    }
+    free(objects);
+    free(values);
+}
+
+FFI_EXPORT void bicubic_async_init(void* post_cobject_fn) {
+    if (post_cobject_fn != NULL) {
+        post_cobject = (DartPostCObjectFn)post_cobject_fn;
+    }
+}
+
+typedef struct {
+    AsyncTask task;
+    int64_t port;
+    const uint8_t* input;
+    int input_width;
+    int input_height;
+    int input_stride;
+    int output_width;
+    int output_height;
+    int channels;
+    int filter;
+    int edge_mode;
+    int color_space;
+    int alpha_mode;
+    float reducing_gap;
+    float crop;
+    int crop_anchor;
+    int aspect_mode;
+    float aspect_w;
+    float aspect_h;
+    int num_threads;
+} RawAsyncJob;
+
+static void raw_async_run(AsyncTask* task) {
+    RawAsyncJob* job = (RawAsyncJob*)task;
+    int size = job->output_width * job->output_height * job->channels;
+    uint8_t* output = (uint8_t*)malloc(size);
+    int result = -1;
+
+    if (output != NULL) {
+        result = resize_raw(job->input, job->input_width, job->input_height, job->input_stride,
+                            output, job->output_width, job->output_height, 0, job->channels,
+                            job->filter, job->edge_mode, job->color_space, job->alpha_mode,
+                            job->reducing_gap, job->crop, job->crop_anchor, job->aspect_mode,
+                            job->aspect_w, job->aspect_h, job->num_threads);
+    }
+    if (result != 0) {
+        free(output);
+        output = NULL;
+    }
+
+    post_result(job->port, result, &output, &size, 1);
+    free(job);
+}
+
+FFI_EXPORT int bicubic_resize_raw_async(
+    const uint8_t* input,
+    int input_width,
+    int input_height,
+    int input_stride,
+    int channels,
+    int output_width,
+    int output_height,
+    int filter,
+    int edge_mode,
+    int color_space,
+    int alpha_mode,
+    float reducing_gap,
+    float crop,
+    int crop_anchor,
+    int aspect_mode,
+    float aspect_w,
+    float aspect_h,
+    int num_threads,
+    int64_t port
+) {
+    if (post_cobject == NULL || input == NULL) {
+        return -1;
+    }
+    if (channels < 1 || channels > 4 || output_width <= 0 || output_height <= 0) {
+        return -1;
+    }
+
+    RawAsyncJob* job = (RawAsyncJob*)malloc(sizeof(RawAsyncJob));
+    if (job == NULL) {
+        return -1;
+    }
+    job->task.run = raw_async_run;
+    job->port = port;
+    job->input = input;
+    job->input_width = input_width;
+    job->input_height = input_height;
+    job->input_stride = input_stride;
+    job->output_width = output_width;
+    job->output_height = output_height;
+    job->channels = channels;
+    job->filter = filter;
+    job->edge_mode = edge_mode;
+    job->color_space = color_space;
+    job->alpha_mode = alpha_mode;
+    job->reducing_gap = reducing_gap;
+    job->crop = crop;
+    job->crop_anchor = crop_anchor;
+    job->aspect_mode = aspect_mode;
+    job->aspect_w = aspect_w;
+    job->aspect_h = aspect_h;
+    job->num_threads = num_threads;
+
+    if (async_submit(&job->task) != 0) {
+        free(job);
+        return -1;
+    }
+    return 0;
+}
 
+typedef struct {
+    AsyncTask task;
+    int64_t port;
+    BicubicBatchItem* items;
+    int count;
+    int num_threads;
+} BatchAsyncJob;
+
+static void batch_async_run(AsyncTask* task) {
+    BatchAsyncJob* job = (BatchAsyncJob*)task;
+    int count = job->count;
+    int result = bicubic_resize_batch(job->items, count, job->num_threads);
+
+    uint8_t** outputs = (uint8_t**)malloc(sizeof(uint8_t*) * (count > 0 ? count : 1));
+    int* sizes = (int*)malloc(sizeof(int) * (count > 0 ? count : 1));
+    if (outputs == NULL || sizes == NULL) {
+        for (int i = 0; i < count; i++) {
+            free(job->items[i].output_data);
+        }
+        count = 0;
+        result = -1;
+    } else {
+        // Ownership of every output moves into the message
+        for (int i = 0; i < count; i++) {
+            BicubicBatchItem* item = &job->items[i];
+            outputs[i] = item->output_data;
+            sizes[i] = item->output_size;
+            item->output_data = NULL;
+            item->output_size = 0;
+        }
+    }
+
+    post_result(job->port, result, outputs, sizes, count);
+    free(outputs);
+    free(sizes);
+    free(job);
+}
+
+FFI_EXPORT int bicubic_resize_batch_async(
+    BicubicBatchItem* items,
+    int count,
+    int num_threads,
+    int64_t port
+) {
+    if (post_cobject == NULL || items == NULL || count < 0) {
+        return -1;
+    }
+
+    BatchAsyncJob* job = (BatchAsyncJob*)malloc(sizeof(BatchAsyncJob));
+    if (job == NULL) {
+        return -1;
+    }
+    job->task.run = batch_async_run;
+    job->port = port;
+    job->items = items;
+    job->count = count;
+    job->num_threads = num_threads;
+
+    if (async_submit(&job->task) != 0) {
+        free(job);
+        return -1;
+    }
     return 0;
 }
 
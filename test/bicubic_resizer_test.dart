@@ -1,5 +1,10 @@
+import 'dart:ffi';
+import 'dart:io';
+import 'dart:math';
 import 'dart:typed_data';
 
+import 'package:ffi/ffi.dart';
+import 'package:flutter_bicubic_resize/flutter_bicubic_resize.dart';
 import 'package:flutter_test/flutter_test.dart';
 
 void main() {
@@ -140,4 +145,1203 @@ void main() {
       expect(cropY, equals(25));
     });
   });
+
+  // The tests below call into the native library. On a desktop host, build
+  // it and put it on the library path first:
+  //
+  //   cmake -S android -B build/native && cmake --build build/native
+  //   LD_LIBRARY_PATH=build/native flutter test
+  //
+  // They are skipped only when the library cannot be loaded at all.
+  group('Native resize', () {
+    test('output is identical for every thread count', () {
+      final pixels = _pattern(300, 200, 4);
+      final png = _encodePng(pixels, 300, 200, 4);
+
+      final rgba = [1, 2, 3, 7].map((threads) => BicubicResizer.resizeRgba(
+            input: pixels,
+            inputWidth: 300,
+            inputHeight: 200,
+            outputWidth: 97,
+            outputHeight: 61,
+            numThreads: threads,
+          )).toList();
+      final encoded = [1, 2, 3, 7].map((threads) => BicubicResizer.resizePng(
+            pngBytes: png,
+            outputWidth: 97,
+            outputHeight: 61,
+            numThreads: threads,
+          )).toList();
+      for (final output in rgba.skip(1)) {
+        expect(output, equals(rgba.first));
+      }
+      for (final output in encoded.skip(1)) {
+        expect(output, equals(encoded.first));
+      }
+    });
+
+    test('plan matches a one-shot resize', () {
+      final input = _pattern(40, 30, 3);
+      final plan = BicubicResizePlan.rgb(
+        inputWidth: 40,
+        inputHeight: 30,
+        outputWidth: 17,
+        outputHeight: 13,
+        cropAspectRatio: CropAspectRatio.original,
+      );
+      addTearDown(plan.dispose);
+
+      final expected = BicubicResizer.resizeRgb(
+        input: input,
+        inputWidth: 40,
+        inputHeight: 30,
+        outputWidth: 17,
+        outputHeight: 13,
+        cropAspectRatio: CropAspectRatio.original,
+      );
+
+      expect(plan.execute(input), equals(expected));
+      expect(plan.execute(input), equals(expected));
+    });
+
+    test('tensor output is normalized per channel', () {
+      final input = _pattern(8, 6, 3);
+      const mean = [0.5, 0.25, 0.1];
+      const std = [0.5, 0.25, 2.0];
+
+      // Auto filter at 1:1 copies the pixels, so only normalization applies
+      final tensor = BicubicResizer.resizeRgbToTensor(
+        input: input,
+        inputWidth: 8,
+        inputHeight: 6,
+        outputWidth: 8,
+        outputHeight: 6,
+        mean: mean,
+        std: std,
+        filter: BicubicFilter.auto,
+        cropAspectRatio: CropAspectRatio.original,
+      );
+
+      for (var i = 0; i < input.length; i++) {
+        final c = i % 3;
+        expect(tensor[i], closeTo((input[i] / 255 - mean[c]) / std[c], 1e-5));
+      }
+    });
+
+    test('NCHW BGR tensor transposes NHWC RGB', () {
+      final input = _pattern(8, 6, 3);
+
+      Float32List resize(TensorLayout layout, ChannelOrder channelOrder) =>
+          BicubicResizer.resizeRgbToTensor(
+            input: input,
+            inputWidth: 8,
+            inputHeight: 6,
+            outputWidth: 5,
+            outputHeight: 4,
+            layout: layout,
+            channelOrder: channelOrder,
+            cropAspectRatio: CropAspectRatio.original,
+          );
+
+      final nhwc = resize(TensorLayout.nhwc, ChannelOrder.rgb);
+      final nchw = resize(TensorLayout.nchw, ChannelOrder.bgr);
+      final bytes = BicubicResizer.resizeRgb(
+        input: input,
+        inputWidth: 8,
+        inputHeight: 6,
+        outputWidth: 5,
+        outputHeight: 4,
+        cropAspectRatio: CropAspectRatio.original,
+      );
+
+      const pixels = 5 * 4;
+      for (var i = 0; i < pixels; i++) {
+        for (var c = 0; c < 3; c++) {
+          expect(nchw[(2 - c) * pixels + i], equals(nhwc[i * 3 + c]));
+          expect(nhwc[i * 3 + c], closeTo(bytes[i * 3 + c] / 255, 1 / 255));
+        }
+      }
+    });
+
+    test('batch resizes valid items and nulls failed ones', () {
+      final png = _encodePng(_pattern(64, 48, 3), 64, 48, 3);
+
+      final batch = BicubicResizer.resizeBatch([
+        BatchResizeRequest(bytes: png, outputWidth: 16, outputHeight: 16),
+        BatchResizeRequest(
+          bytes: Uint8List.fromList([0x89, 0x50, 0x4E, 0x47]),
+          outputWidth: 16,
+          outputHeight: 16,
+        ),
+      ]);
+      expect(BicubicResizer.probe(batch[0]!).width, equals(16));
+      expect(batch[1], isNull);
+    });
+
+    test('batch output is identical for every thread count', () {
+      final requests = [
+        for (var i = 0; i < 5; i++)
+          BatchResizeRequest(
+            bytes: _encodePng(_pattern(60 + i * 9, 40, 3), 60 + i * 9, 40, 3),
+            outputWidth: 23,
+            outputHeight: 17,
+          ),
+      ];
+
+      final single = BicubicResizer.resizeBatch(requests, numThreads: 1);
+      for (final threads in [2, 4]) {
+        final batch = BicubicResizer.resizeBatch(requests, numThreads: threads);
+        for (var i = 0; i < requests.length; i++) {
+          expect(batch[i], equals(single[i]));
+        }
+      }
+    });
+
+    test('row padding is skipped', () {
+      final packed = _pattern(20, 10, 3);
+      final padded = Uint8List(64 * 10)..fillRange(0, 64 * 10, 0xFF);
+      for (var y = 0; y < 10; y++) {
+        padded.setRange(y * 64, y * 64 + 60, packed, y * 60);
+      }
+
+      Uint8List resize(Uint8List input, int stride) => BicubicResizer.resizeRgb(
+            input: input,
+            inputWidth: 20,
+            inputHeight: 10,
+            inputRowStride: stride,
+            outputWidth: 7,
+            outputHeight: 5,
+            cropAspectRatio: CropAspectRatio.original,
+          );
+
+      expect(resize(padded, 64), equals(resize(packed, 0)));
+    });
+
+    test('semi-planar chroma matches I420', () {
+      final yPlane = Uint8List.fromList(
+        List.generate(32 * 24, (i) => i * 5 % 256),
+      );
+      final uPlane = Uint8List.fromList(
+        List.generate(16 * 12, (i) => i * 3 % 256),
+      );
+      final vPlane = Uint8List.fromList(
+        List.generate(16 * 12, (i) => i * 11 % 256),
+      );
+
+      // Same chroma as Android NV21 planes: V and U are views into one
+      // interleaved buffer, offset by one byte
+      final interleaved = Uint8List(16 * 12 * 2);
+      for (var i = 0; i < 16 * 12; i++) {
+        interleaved[i * 2] = vPlane[i];
+        interleaved[i * 2 + 1] = uPlane[i];
+      }
+      final vInterleaved = interleaved.sublist(0, interleaved.length - 1);
+      final uInterleaved = interleaved.sublist(1);
+
+      final i420 = BicubicResizer.resizeYuv420(
+        yPlane: yPlane,
+        uPlane: uPlane,
+        vPlane: vPlane,
+        yRowStride: 32,
+        uvRowStride: 16,
+        uvPixelStride: 1,
+        inputWidth: 32,
+        inputHeight: 24,
+        outputWidth: 10,
+        outputHeight: 9,
+      );
+      final semiPlanar = BicubicResizer.resizeYuv420(
+        yPlane: yPlane,
+        uPlane: uInterleaved,
+        vPlane: vInterleaved,
+        yRowStride: 32,
+        uvRowStride: 32,
+        uvPixelStride: 2,
+        inputWidth: 32,
+        inputHeight: 24,
+        outputWidth: 10,
+        outputHeight: 9,
+      );
+
+      expect(semiPlanar, equals(i420));
+    });
+
+    test('neutral YUV converts to opaque gray', () {
+      final output = BicubicResizer.resizeYuv420(
+        yPlane: Uint8List(32 * 24)..fillRange(0, 32 * 24, 128),
+        uPlane: Uint8List(16 * 12)..fillRange(0, 16 * 12, 128),
+        vPlane: Uint8List(16 * 12)..fillRange(0, 16 * 12, 128),
+        yRowStride: 32,
+        uvRowStride: 16,
+        uvPixelStride: 1,
+        inputWidth: 32,
+        inputHeight: 24,
+        outputWidth: 10,
+        outputHeight: 9,
+        outputChannels: 4,
+      );
+
+      for (var i = 0; i < output.length; i += 4) {
+        for (var c = 0; c < 3; c++) {
+          expect(output[i + c], inInclusiveRange(127, 129));
+        }
+        expect(output[i + 3], equals(255));
+      }
+    });
+
+    test('co-sited chroma lands on even luma columns', () {
+      // Flat luma and V, U rising by 8 per chroma column
+      final uPlane = Uint8List.fromList(
+        List.generate(8 * 2, (i) => 96 + 8 * (i % 8)),
+      );
+
+      Uint8List resize(YuvChromaSiting siting) => BicubicResizer.resizeYuv420(
+            yPlane: Uint8List(16 * 4)..fillRange(0, 16 * 4, 128),
+            uPlane: uPlane,
+            vPlane: Uint8List(8 * 2)..fillRange(0, 8 * 2, 128),
+            yRowStride: 16,
+            uvRowStride: 8,
+            uvPixelStride: 1,
+            inputWidth: 16,
+            inputHeight: 4,
+            outputWidth: 16,
+            outputHeight: 4,
+            chromaSiting: siting,
+            cropAspectRatio: CropAspectRatio.original,
+          );
+
+      final cosited = resize(YuvChromaSiting.cosited);
+      final centered = resize(YuvChromaSiting.center);
+      for (var x = 2; x <= 12; x++) {
+        // Co-sited U at luma column x is the ramp sampled at x / 2
+        final u = 96 + 8 * (x / 2);
+        expect(cosited[x * 3 + 2], closeTo(128 + 1.772 * (u - 128), 1.5));
+        expect(centered[x * 3 + 2], lessThan(cosited[x * 3 + 2]));
+      }
+    });
+
+    test('reduced-size decode keeps the crop window in place', () {
+      // Smooth 1203x803 image, so a crop shift shows up as a large error
+      // while decode-scale rounding stays small
+      const width = 1203, height = 803;
+      final pixels = Uint8List(width * height * 3);
+      for (var y = 0; y < height; y++) {
+        for (var x = 0; x < width; x++) {
+          final i = (y * width + x) * 3;
+          pixels[i] = (128 + 100 * sin(x * 0.05) * cos(y * 0.03)).toInt();
+          pixels[i + 1] = x * 255 ~/ width;
+          pixels[i + 2] = y * 255 ~/ height;
+        }
+      }
+      final jpeg = _encodeJpeg(pixels, width, height, 3);
+
+      for (var orientation = 1; orientation <= 8; orientation++) {
+        final oriented = _withExifOrientation(jpeg, orientation);
+        final full = BicubicDecodedImage.decode(oriented);
+        addTearDown(full.dispose);
+
+        for (final anchor in CropAnchor.values) {
+          // 64x64 from a 0.9 crop decodes the JPEG at 1/8 size
+          final scaled = _decodePixels(BicubicResizer.resizeJpeg(
+            jpegBytes: oriented,
+            outputWidth: 64,
+            outputHeight: 64,
+            quality: 100,
+            chromaSubsampling: JpegChromaSubsampling.yuv444,
+            crop: 0.9,
+            cropAnchor: anchor,
+            cropAspectRatio: CropAspectRatio.original,
+          ));
+          final unscaled = full.resizePixels(
+            outputWidth: 64,
+            outputHeight: 64,
+            crop: 0.9,
+            cropAnchor: anchor,
+            cropAspectRatio: CropAspectRatio.original,
+          );
+          expect(
+            _psnr(scaled, unscaled),
+            greaterThan(40),
+            reason: 'orientation $orientation, $anchor',
+          );
+        }
+      }
+    });
+
+    test('off-center crop matches a full decode', () {
+      final jpeg = _encodeJpeg(_pattern(400, 300, 3), 400, 300, 3);
+      final full = BicubicDecodedImage.decode(jpeg);
+      addTearDown(full.dispose);
+
+      // 0.5 crop to 150x150 needs the full resolution, so only the region
+      // under the crop is decoded
+      for (final anchor in CropAnchor.values) {
+        final region = _decodePixels(BicubicResizer.resizeJpeg(
+          jpegBytes: jpeg,
+          outputWidth: 150,
+          outputHeight: 150,
+          quality: 100,
+          chromaSubsampling: JpegChromaSubsampling.yuv444,
+          crop: 0.5,
+          cropAnchor: anchor,
+        ));
+        final expected = full.resizePixels(
+          outputWidth: 150,
+          outputHeight: 150,
+          crop: 0.5,
+          cropAnchor: anchor,
+        );
+        expect(_psnr(region, expected), greaterThan(45), reason: '$anchor');
+      }
+    });
+
+    test('arena settings do not change results', () {
+      final png = _encodePng(_pattern(120, 90, 4), 120, 90, 4);
+      Uint8List resize() => BicubicResizer.resizePng(
+            pngBytes: png,
+            outputWidth: 37,
+            outputHeight: 29,
+          );
+      addTearDown(() => BicubicResizer.setArenaLimit(64 * 1024 * 1024));
+
+      final expected = resize();
+      // Warm arena reused by the next call
+      expect(resize(), equals(expected));
+
+      BicubicResizer.trimArenas();
+      expect(resize(), equals(expected));
+
+      // Arenas disabled: every allocation goes straight to malloc
+      BicubicResizer.setArenaLimit(0);
+      expect(resize(), equals(expected));
+    });
+
+    test('pointer input is read in place and results outlive it', () {
+      final frame = _pattern(64, 48, 3);
+      final input = malloc<Uint8>(frame.length);
+      input.asTypedList(frame.length).setAll(0, frame);
+
+      Uint8List resize() => BicubicResizer.resizeRgbFromPointer(
+            input: input,
+            inputWidth: 64,
+            inputHeight: 48,
+            outputWidth: 20,
+            outputHeight: 15,
+            cropAspectRatio: CropAspectRatio.original,
+          );
+
+      final first = resize();
+      final firstCopy = Uint8List.fromList(first);
+      // Reuse the buffer for the next frame
+      input.asTypedList(frame.length).fillRange(0, frame.length, 0);
+      final second = resize();
+      malloc.free(input);
+
+      expect(first, equals(firstCopy));
+      expect(
+        first,
+        equals(BicubicResizer.resizeRgb(
+          input: frame,
+          inputWidth: 64,
+          inputHeight: 48,
+          outputWidth: 20,
+          outputHeight: 15,
+          cropAspectRatio: CropAspectRatio.original,
+        )),
+      );
+      expect(second, everyElement(equals(0)));
+    });
+
+    test('encoded pointer input matches the copying variant', () {
+      final png = _encodePng(_pattern(64, 48, 3), 64, 48, 3);
+      final input = malloc<Uint8>(png.length);
+      addTearDown(() => malloc.free(input));
+      input.asTypedList(png.length).setAll(0, png);
+
+      expect(
+        BicubicResizer.resizePngFromPointer(
+          pngBytes: input,
+          length: png.length,
+          outputWidth: 16,
+          outputHeight: 16,
+        ),
+        equals(BicubicResizer.resizePng(
+          pngBytes: png,
+          outputWidth: 16,
+          outputHeight: 16,
+        )),
+      );
+    });
+
+    test('async resize matches the sync result', () async {
+      final input = _pattern(40, 30, 3);
+
+      final expected = BicubicResizer.resizeRgb(
+        input: input,
+        inputWidth: 40,
+        inputHeight: 30,
+        outputWidth: 17,
+        outputHeight: 13,
+      );
+      final actual = await BicubicResizer.resizeRgbAsync(
+        input: input,
+        inputWidth: 40,
+        inputHeight: 30,
+        outputWidth: 17,
+        outputHeight: 13,
+      );
+
+      expect(actual, equals(expected));
+    });
+
+    test('JPEG chroma subsampling option is honoured', () {
+      final jpeg = _encodeJpeg(_pattern(96, 64, 3), 96, 64, 3);
+
+      Uint8List resize(JpegChromaSubsampling subsampling) =>
+          BicubicResizer.resizeJpeg(
+            jpegBytes: jpeg,
+            outputWidth: 48,
+            outputHeight: 32,
+            quality: 100,
+            chromaSubsampling: subsampling,
+            cropAspectRatio: CropAspectRatio.original,
+          );
+
+      final full = resize(JpegChromaSubsampling.yuv444);
+      final half = resize(JpegChromaSubsampling.yuv420);
+      expect(half.length, lessThan(full.length));
+      expect(BicubicResizer.probe(half).width, equals(48));
+      expect(_psnr(_decodePixels(full), _decodePixels(half)), greaterThan(15));
+    });
+
+    test('PNG filter option changes the file, not the pixels', () {
+      final png = _encodePng(_pattern(96, 64, 3), 96, 64, 3);
+
+      Uint8List resize(PngFilter pngFilter) => BicubicResizer.resizePng(
+            pngBytes: png,
+            outputWidth: 48,
+            outputHeight: 32,
+            pngFilter: pngFilter,
+            cropAspectRatio: CropAspectRatio.original,
+          );
+
+      final expected = _decodePixels(resize(PngFilter.adaptive));
+      for (final pngFilter in PngFilter.values) {
+        expect(_decodePixels(resize(pngFilter)), equals(expected));
+      }
+      expect(
+        resize(PngFilter.none),
+        isNot(equals(resize(PngFilter.paeth))),
+      );
+    });
+
+    test('multi produces every rendition', () {
+      final png = _encodePng(_pattern(64, 48, 3), 64, 48, 3);
+
+      final renditions = BicubicResizer.resizeMulti(
+        bytes: png,
+        outputs: const [
+          ResizeOutputSpec(
+            outputWidth: 32,
+            outputHeight: 24,
+            cropAspectRatio: CropAspectRatio.original,
+          ),
+          ResizeOutputSpec(
+            outputWidth: 8,
+            outputHeight: 6,
+            cropAspectRatio: CropAspectRatio.original,
+          ),
+        ],
+      );
+      expect(BicubicResizer.probe(renditions[0]!).width, equals(32));
+      expect(BicubicResizer.probe(renditions[1]!).height, equals(6));
+    });
+
+    test('multi only cascades renditions with the same filter', () {
+      final png = _encodePng(_pattern(64, 48, 3), 64, 48, 3);
+      const small = ResizeOutputSpec(
+        outputWidth: 8,
+        outputHeight: 6,
+        filter: BicubicFilter.cubicBSpline,
+        edgeMode: EdgeMode.reflect,
+        cropAspectRatio: CropAspectRatio.original,
+      );
+
+      final mixed = BicubicResizer.resizeMulti(
+        bytes: png,
+        outputs: const [
+          ResizeOutputSpec(
+            outputWidth: 32,
+            outputHeight: 24,
+            cropAspectRatio: CropAspectRatio.original,
+          ),
+          small,
+        ],
+      );
+      final alone = BicubicResizer.resizeMulti(bytes: png, outputs: [small]);
+
+      expect(_decodePixels(mixed[1]!), equals(_decodePixels(alone[0]!)));
+    });
+
+    test('decoded image resizes like the raw pixels', () {
+      final pixels = _pattern(64, 48, 3);
+      final image = BicubicDecodedImage.decode(_encodePng(pixels, 64, 48, 3));
+      addTearDown(image.dispose);
+
+      expect(image.width, equals(64));
+      expect(image.height, equals(48));
+      expect(image.channels, equals(3));
+      expect(
+        image.resizePixels(outputWidth: 20, outputHeight: 20),
+        equals(
+          BicubicResizer.resizeRgb(
+            input: pixels,
+            inputWidth: 64,
+            inputHeight: 48,
+            outputWidth: 20,
+            outputHeight: 20,
+          ),
+        ),
+      );
+    });
+
+    test('probe reads PNG header fields', () {
+      final png = _encodePng(_pattern(64, 48, 3), 64, 48, 3);
+
+      final info = BicubicResizer.probe(png);
+      expect(info.format, equals(ImageFormat.png));
+      expect(info.width, equals(64));
+      expect(info.height, equals(48));
+      expect(info.channels, equals(3));
+      expect(info.bitDepth, equals(8));
+      expect(info.orientation, equals(1));
+      expect(info.progressive, isFalse);
+    });
+
+    test('grayscale JPEG stays single-channel', () {
+      final jpeg = _encodeJpeg(_pattern(64, 48, 1), 64, 48, 1);
+      expect(_channelsOf(jpeg), equals(1));
+
+      final output = BicubicResizer.resizeJpeg(
+        jpegBytes: jpeg,
+        outputWidth: 32,
+        outputHeight: 24,
+        cropAspectRatio: CropAspectRatio.original,
+      );
+      expect(BicubicResizer.probe(output).width, equals(32));
+      expect(_channelsOf(output), equals(1));
+    });
+
+    test('opaque PNG alpha is dropped, real alpha is kept', () {
+      final translucent = _pattern(64, 48, 4);
+      final opaque = Uint8List.fromList(translucent);
+      for (var i = 3; i < opaque.length; i += 4) {
+        opaque[i] = 255;
+      }
+
+      int resizedChannels(Uint8List pixels) => _channelsOf(
+            BicubicResizer.resizePng(
+              pngBytes: _encodePng(pixels, 64, 48, 4),
+              outputWidth: 32,
+              outputHeight: 24,
+              cropAspectRatio: CropAspectRatio.original,
+            ),
+          );
+
+      expect(resizedChannels(opaque), equals(3));
+      expect(resizedChannels(translucent), equals(4));
+    });
+
+    test('palette PNGs decode to the narrowest channel count', () {
+      final indices = Uint8List.fromList(
+        List.generate(40 * 30, (i) => (i % 40 + i ~/ 40) % 16),
+      );
+      final gray = [for (var i = 0; i < 16; i++) ...[i * 16, i * 16, i * 16]];
+      final color = [
+        for (var i = 0; i < 16; i++) ...[i * 16, 255 - i * 16, i * 8],
+      ];
+      final opaque = List.filled(16, 255);
+      final translucent = [for (var i = 0; i < 16; i++) i * 16];
+
+      int channels(List<int> palette, [List<int>? alpha]) => _channelsOf(
+            _encodeIndexedPng(indices, 40, 30, palette, alpha),
+          );
+
+      expect(channels(gray), equals(1));
+      expect(channels(gray, translucent), equals(2));
+      expect(channels(color), equals(3));
+      expect(channels(color, opaque), equals(3));
+      expect(channels(color, translucent), equals(4));
+    });
+
+    test('palette PNG resizes like its expanded pixels', () {
+      final indices = Uint8List.fromList(
+        List.generate(40 * 30, (i) => (i % 40 + i ~/ 40) % 16),
+      );
+      final palette = [
+        for (var i = 0; i < 16; i++) ...[i * 16, 255 - i * 16, i * 8],
+      ];
+      final expanded = Uint8List(40 * 30 * 3);
+      for (var i = 0; i < indices.length; i++) {
+        expanded.setRange(i * 3, i * 3 + 3, palette, indices[i] * 3);
+      }
+
+      Uint8List resize(Uint8List png) => _decodePixels(
+            BicubicResizer.resizePng(
+              pngBytes: png,
+              outputWidth: 20,
+              outputHeight: 15,
+              cropAspectRatio: CropAspectRatio.original,
+            ),
+          );
+
+      expect(
+        resize(_encodeIndexedPng(indices, 40, 30, palette)),
+        equals(resize(_encodePng(expanded, 40, 30, 3))),
+      );
+    });
+
+    test('streamed large PNG matches a full decode', () {
+      // Upscale past the 32 MB streaming threshold (3400 x 3400 RGB)
+      final small = _encodePng(_pattern(64, 48, 3), 64, 48, 3);
+      final large = BicubicResizer.resizePng(
+        pngBytes: small,
+        outputWidth: 3400,
+        outputHeight: 3400,
+        cropAspectRatio: CropAspectRatio.original,
+        compressionLevel: 1,
+      );
+
+      final streamed = BicubicResizer.resizePng(
+        pngBytes: large,
+        outputWidth: 64,
+        outputHeight: 64,
+        compressionLevel: 0,
+      );
+
+      final image = BicubicDecodedImage.decode(large);
+      addTearDown(image.dispose);
+      final expected = image.resizePixels(outputWidth: 64, outputHeight: 64);
+
+      expect(_decodePixels(streamed), equals(expected));
+    });
+
+    test('linear light averages a checkerboard brighter than gamma', () {
+      final input = Uint8List(64 * 64);
+      for (var i = 0; i < input.length; i++) {
+        input[i] = (i % 64 + i ~/ 64).isOdd ? 255 : 0;
+      }
+
+      Uint8List resize(ResizeColorSpace colorSpace) =>
+          BicubicResizer.resizeGray(
+            input: input,
+            inputWidth: 64,
+            inputHeight: 64,
+            outputWidth: 8,
+            outputHeight: 8,
+            colorSpace: colorSpace,
+          );
+
+      // Half of 255 in gamma space, sRGB(0.5) ~ 188 in linear light
+      expect(
+        resize(ResizeColorSpace.gamma),
+        everyElement(inInclusiveRange(120, 136)),
+      );
+      expect(
+        resize(ResizeColorSpace.linear),
+        everyElement(inInclusiveRange(180, 196)),
+      );
+    });
+
+    test('linear tensor output is not rounded to 8 bits', () {
+      final input = Uint8List(64 * 3);
+      for (var i = 0; i < input.length; i++) {
+        input[i] = i ~/ 3 * 4;
+      }
+
+      Float32List resize(int outputWidth) => BicubicResizer.resizeRgbToTensor(
+            input: input,
+            inputWidth: 64,
+            inputHeight: 1,
+            outputWidth: outputWidth,
+            outputHeight: 1,
+            filter: BicubicFilter.auto,
+            colorSpace: ResizeColorSpace.linear,
+            cropAspectRatio: CropAspectRatio.original,
+          );
+
+      // 1:1 round trip through linear light gives the input back
+      final copy = resize(64);
+      for (var i = 0; i < input.length; i++) {
+        expect(copy[i], closeTo(input[i] / 255, 1e-5));
+      }
+
+      // Downscaled values fall between the 8-bit steps
+      final offGrid = resize(7).map((v) {
+        final scaled = v * 255;
+        return (scaled - scaled.round()).abs();
+      });
+      expect(offGrid.reduce(max), greaterThan(0.1));
+    });
+
+    test('straight alpha keeps transparent color out of the result', () {
+      // Left half transparent red, right half opaque blue
+      final input = Uint8List(32 * 32 * 4);
+      for (var i = 0; i < 32 * 32; i++) {
+        final opaque = i % 32 >= 16;
+        input[i * 4] = opaque ? 0 : 255;
+        input[i * 4 + 2] = opaque ? 255 : 0;
+        input[i * 4 + 3] = opaque ? 255 : 0;
+      }
+
+      Uint8List resize(AlphaMode alphaMode) => BicubicResizer.resizeRgba(
+            input: input,
+            inputWidth: 32,
+            inputHeight: 32,
+            outputWidth: 8,
+            outputHeight: 8,
+            alphaMode: alphaMode,
+          );
+
+      bool redBleeds(Uint8List pixels) {
+        for (var i = 0; i < pixels.length; i += 4) {
+          if (pixels[i + 3] > 0 && pixels[i] > 0) return true;
+        }
+        return false;
+      }
+
+      expect(redBleeds(resize(AlphaMode.straight)), isFalse);
+      expect(redBleeds(resize(AlphaMode.ignore)), isTrue);
+    });
+
+    test('premultiplied alpha keeps color within alpha', () {
+      final input = _pattern(32, 32, 4);
+      for (var i = 0; i < input.length; i += 4) {
+        for (var c = 0; c < 3; c++) {
+          input[i + c] = input[i + c] * input[i + 3] ~/ 255;
+        }
+      }
+
+      final output = BicubicResizer.resizeRgba(
+        input: input,
+        inputWidth: 32,
+        inputHeight: 32,
+        outputWidth: 11,
+        outputHeight: 7,
+        alphaMode: AlphaMode.premultiplied,
+      );
+
+      for (var i = 0; i < output.length; i += 4) {
+        for (var c = 0; c < 3; c++) {
+          expect(output[i + c], lessThanOrEqualTo(output[i + 3] + 1));
+        }
+      }
+    });
+
+    test('BGRA input resizes like RGBA', () {
+      final rgba = _pattern(40, 30, 4);
+      final bgra = _swapRedBlue(rgba);
+
+      final fromBgra = BicubicResizer.resizeRaw(
+        input: bgra,
+        inputWidth: 40,
+        inputHeight: 30,
+        inputLayout: PixelLayout.bgra,
+        outputLayout: PixelLayout.rgba,
+        outputWidth: 17,
+        outputHeight: 13,
+      );
+      final fromRgba = BicubicResizer.resizeRgba(
+        input: rgba,
+        inputWidth: 40,
+        inputHeight: 30,
+        outputWidth: 17,
+        outputHeight: 13,
+      );
+
+      expect(fromBgra, equals(fromRgba));
+    });
+
+    test('RGBA input can be written as BGRA', () {
+      final rgba = _pattern(40, 30, 4);
+
+      final bgra = BicubicResizer.resizeRaw(
+        input: rgba,
+        inputWidth: 40,
+        inputHeight: 30,
+        inputLayout: PixelLayout.rgba,
+        outputLayout: PixelLayout.bgra,
+        outputWidth: 17,
+        outputHeight: 13,
+      );
+      final expected = BicubicResizer.resizeRgba(
+        input: rgba,
+        inputWidth: 40,
+        inputHeight: 30,
+        outputWidth: 17,
+        outputHeight: 13,
+      );
+
+      expect(bgra, equals(_swapRedBlue(expected)));
+    });
+
+    test('planar output holds one plane per channel', () {
+      final rgb = _pattern(40, 30, 3);
+      final interleaved = BicubicResizer.resizeRgb(
+        input: rgb,
+        inputWidth: 40,
+        inputHeight: 30,
+        outputWidth: 17,
+        outputHeight: 13,
+      );
+
+      for (final layout in [PixelLayout.rgb, PixelLayout.bgr]) {
+        final planar = BicubicResizer.resizeRaw(
+          input: rgb,
+          inputWidth: 40,
+          inputHeight: 30,
+          inputLayout: PixelLayout.rgb,
+          outputLayout: layout,
+          planarOutput: true,
+          outputWidth: 17,
+          outputHeight: 13,
+        );
+
+        const pixels = 17 * 13;
+        for (var i = 0; i < pixels; i++) {
+          for (var c = 0; c < 3; c++) {
+            final source = layout == PixelLayout.bgr ? 2 - c : c;
+            expect(planar[c * pixels + i], equals(interleaved[i * 3 + source]));
+          }
+        }
+      }
+    });
+
+    test('layouts with different channel counts are rejected', () {
+      expect(
+        () => BicubicResizer.resizeRaw(
+          input: _pattern(8, 8, 3),
+          inputWidth: 8,
+          inputHeight: 8,
+          inputLayout: PixelLayout.rgb,
+          outputLayout: PixelLayout.rgba,
+          outputWidth: 4,
+          outputHeight: 4,
+        ),
+        throwsArgumentError,
+      );
+    });
+
+    test('per-axis settings follow EXIF rotation', () {
+      final png = _encodePng(_pattern(96, 64, 3), 96, 64, 3);
+      final source = BicubicDecodedImage.decode(png);
+      final jpeg = source.encode(
+        outputWidth: 96,
+        outputHeight: 64,
+        outputFormat: ImageFormat.jpeg,
+        quality: 100,
+        chromaSubsampling: JpegChromaSubsampling.yuv444,
+        filter: BicubicFilter.auto,
+        cropAspectRatio: CropAspectRatio.original,
+      );
+      source.dispose();
+
+      // Orientation 6 stores the image rotated, so it displays as 64 x 96
+      final rotated = _withExifOrientation(jpeg, 6);
+      final resized = BicubicResizer.resizeJpeg(
+        jpegBytes: rotated,
+        outputWidth: 20,
+        outputHeight: 30,
+        quality: 100,
+        chromaSubsampling: JpegChromaSubsampling.yuv444,
+        filter: BicubicFilter.cubicBSpline,
+        verticalFilter: BicubicFilter.catmullRom,
+        edgeMode: EdgeMode.wrap,
+        verticalEdgeMode: EdgeMode.clamp,
+        cropAspectRatio: CropAspectRatio.original,
+      );
+
+      // The decoded image is oriented before it is resized
+      final image = BicubicDecodedImage.decode(rotated);
+      addTearDown(image.dispose);
+      final expected = image.resizePixels(
+        outputWidth: 20,
+        outputHeight: 30,
+        filter: BicubicFilter.cubicBSpline,
+        verticalFilter: BicubicFilter.catmullRom,
+        edgeMode: EdgeMode.wrap,
+        verticalEdgeMode: EdgeMode.clamp,
+        cropAspectRatio: CropAspectRatio.original,
+      );
+
+      final actual = _decodePixels(resized);
+      expect(actual.length, equals(expected.length));
+      for (var i = 0; i < expected.length; i++) {
+        expect((actual[i] - expected[i]).abs(), lessThanOrEqualTo(12));
+      }
+    });
+
+    test('reducing gap stays close to the full filter', () {
+      // Smooth gradient: red along x, green along y, blue diagonal
+      final input = Uint8List(256 * 256 * 3);
+      for (var i = 0; i < 256 * 256; i++) {
+        input[i * 3] = i % 256;
+        input[i * 3 + 1] = i ~/ 256;
+        input[i * 3 + 2] = (i % 256 + i ~/ 256) ~/ 2;
+      }
+
+      Uint8List resize(double reducingGap) => BicubicResizer.resizeRgb(
+            input: input,
+            inputWidth: 256,
+            inputHeight: 256,
+            outputWidth: 16,
+            outputHeight: 16,
+            filter: BicubicFilter.cubicBSpline,
+            reducingGap: reducingGap,
+          );
+
+      final exact = resize(0.0);
+      final reduced = resize(2.0);
+      for (var i = 0; i < exact.length; i++) {
+        expect((reduced[i] - exact[i]).abs(), lessThanOrEqualTo(2));
+      }
+    });
+
+    test('reducing gap leaves 4-channel input without alpha unweighted', () {
+      // Opaque red/green checkerboard; once alpha is known to be opaque the
+      // fourth channel is plain data and must not weight the box average
+      final input = Uint8List(64 * 64 * 4);
+      for (var i = 0; i < 64 * 64; i++) {
+        final green = (i % 64 + i ~/ 64).isOdd;
+        input[i * 4] = green ? 0 : 255;
+        input[i * 4 + 1] = green ? 255 : 0;
+        input[i * 4 + 3] = 255;
+      }
+
+      Uint8List resize(double reducingGap) => BicubicResizer.resizeRgba(
+            input: input,
+            inputWidth: 64,
+            inputHeight: 64,
+            outputWidth: 8,
+            outputHeight: 8,
+            reducingGap: reducingGap,
+            dropOpaqueAlpha: true,
+          );
+
+      final exact = resize(0.0);
+      final reduced = resize(2.0);
+      expect(reduced.length, equals(8 * 8 * 3));
+      for (var i = 0; i < exact.length; i++) {
+        expect((reduced[i] - exact[i]).abs(), lessThanOrEqualTo(2));
+      }
+
+      Float32List tensor(double reducingGap) =>
+          BicubicResizer.resizeRgbToTensor(
+            input: input,
+            inputWidth: 64,
+            inputHeight: 64,
+            inputChannels: 4,
+            outputWidth: 8,
+            outputHeight: 8,
+            colorSpace: ResizeColorSpace.linear,
+            reducingGap: reducingGap,
+          );
+
+      final exactTensor = tensor(0.0);
+      final reducedTensor = tensor(2.0);
+      for (var i = 0; i < exactTensor.length; i++) {
+        expect(reducedTensor[i], closeTo(exactTensor[i], 0.02));
+      }
+    });
+  }, skip: _nativeSkip);
+}
+
+/// Skip reason for native tests when the native library is not built for
+/// this host, or null when it loads. Any other failure is rethrown so that
+/// a broken native call fails the run instead of skipping the tests.
+final String? _nativeSkip = () {
+  try {
+    BicubicResizer.resizeGray(
+      input: Uint8List(4),
+      inputWidth: 2,
+      inputHeight: 2,
+      outputWidth: 1,
+      outputHeight: 1,
+    );
+    return null;
+  } on ArgumentError catch (error) {
+    // DynamicLibrary.open reports a missing library as an ArgumentError
+    if (!'$error'.contains('Failed to load dynamic library')) rethrow;
+    return 'Native library not available on this host: ${error.message}';
+  }
+}();
+
+/// Deterministic test image with distinct values per channel
+Uint8List _pattern(int width, int height, int channels) {
+  final pixels = Uint8List(width * height * channels);
+  for (var y = 0; y < height; y++) {
+    for (var x = 0; x < width; x++) {
+      for (var c = 0; c < channels; c++) {
+        pixels[(y * width + x) * channels + c] =
+            (x * 7 + y * 13 + c * 50) % 256;
+      }
+    }
+  }
+  return pixels;
+}
+
+/// Swap red and blue of 4-channel pixels (RGBA <-> BGRA)
+Uint8List _swapRedBlue(Uint8List pixels) {
+  final swapped = Uint8List.fromList(pixels);
+  for (var i = 0; i < swapped.length; i += 4) {
+    swapped[i] = pixels[i + 2];
+    swapped[i + 2] = pixels[i];
+  }
+  return swapped;
+}
+
+/// Raw pixels of an encoded image at its own size
+Uint8List _decodePixels(Uint8List bytes) {
+  final image = BicubicDecodedImage.decode(bytes);
+  try {
+    // Auto filter at 1:1 copies the pixels unchanged
+    return image.resizePixels(
+      outputWidth: image.width,
+      outputHeight: image.height,
+      filter: BicubicFilter.auto,
+      cropAspectRatio: CropAspectRatio.original,
+    );
+  } finally {
+    image.dispose();
+  }
+}
+
+/// Channel count an encoded image decodes to
+int _channelsOf(Uint8List bytes) {
+  final image = BicubicDecodedImage.decode(bytes);
+  final channels = image.channels;
+  image.dispose();
+  return channels;
+}
+
+/// Encode pixels as a quality 100, 4:4:4 JPEG through the native encoder
+Uint8List _encodeJpeg(Uint8List pixels, int width, int height, int channels) {
+  final image = BicubicDecodedImage.decode(
+    _encodePng(pixels, width, height, channels),
+  );
+  try {
+    return image.encode(
+      outputWidth: width,
+      outputHeight: height,
+      outputFormat: ImageFormat.jpeg,
+      quality: 100,
+      chromaSubsampling: JpegChromaSubsampling.yuv444,
+      filter: BicubicFilter.auto,
+      cropAspectRatio: CropAspectRatio.original,
+    );
+  } finally {
+    image.dispose();
+  }
+}
+
+/// Insert an EXIF segment holding only [orientation] after the JPEG SOI
+Uint8List _withExifOrientation(Uint8List jpeg, int orientation) {
+  final exif = [
+    0xFF, 0xE1, 0, 34, // APP1, segment length
+    0x45, 0x78, 0x69, 0x66, 0, 0, // "Exif"
+    0x4D, 0x4D, 0, 42, 0, 0, 0, 8, // Big-endian TIFF header
+    0, 1, // One IFD entry
+    0x01, 0x12, 0, 3, 0, 0, 0, 1, 0, orientation, 0, 0, // Orientation
+    0, 0, 0, 0, // No next IFD
+  ];
+  return Uint8List.fromList([
+    ...jpeg.sublist(0, 2),
+    ...exif,
+    ...jpeg.sublist(2),
+  ]);
+}
+
+/// Minimal 8-bit PNG encoder for test inputs
+Uint8List _encodePng(Uint8List pixels, int width, int height, int channels) {
+  const colorTypes = {1: 0, 2: 4, 3: 2, 4: 6};
+
+  final rowBytes = width * channels;
+  final raw = BytesBuilder();
+  for (var y = 0; y < height; y++) {
+    raw.addByte(0); // Filter: none
+    raw.add(Uint8List.sublistView(pixels, y * rowBytes, (y + 1) * rowBytes));
+  }
+
+  final header = ByteData(13)
+    ..setUint32(0, width)
+    ..setUint32(4, height)
+    ..setUint8(8, 8)
+    ..setUint8(9, colorTypes[channels]!);
+
+  final png = BytesBuilder()
+    ..add(const [0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A]);
+  _addPngChunk(png, 'IHDR', header.buffer.asUint8List());
+  _addPngChunk(png, 'IDAT', ZLibEncoder().convert(raw.takeBytes()));
+  _addPngChunk(png, 'IEND', const []);
+  return png.takeBytes();
+}
+
+/// Minimal 8-bit indexed PNG encoder; [alpha] becomes the tRNS chunk
+Uint8List _encodeIndexedPng(
+  Uint8List indices,
+  int width,
+  int height,
+  List<int> palette, [
+  List<int>? alpha,
+]) {
+  final raw = BytesBuilder();
+  for (var y = 0; y < height; y++) {
+    raw.addByte(0); // Filter: none
+    raw.add(Uint8List.sublistView(indices, y * width, (y + 1) * width));
+  }
+
+  final header = ByteData(13)
+    ..setUint32(0, width)
+    ..setUint32(4, height)
+    ..setUint8(8, 8)
+    ..setUint8(9, 3);
+
+  final png = BytesBuilder()
+    ..add(const [0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A]);
+  _addPngChunk(png, 'IHDR', header.buffer.asUint8List());
+  _addPngChunk(png, 'PLTE', palette);
+  if (alpha != null) _addPngChunk(png, 'tRNS', alpha);
+  _addPngChunk(png, 'IDAT', ZLibEncoder().convert(raw.takeBytes()));
+  _addPngChunk(png, 'IEND', const []);
+  return png.takeBytes();
+}
+
+void _addPngChunk(BytesBuilder png, String type, List<int> data) {
+  final body = [...type.codeUnits, ...data];
+  png
+    ..add((ByteData(4)..setUint32(0, data.length)).buffer.asUint8List())
+    ..add(body)
+    ..add((ByteData(4)..setUint32(0, _crc32(body))).buffer.asUint8List());
+}
+
+int _crc32(List<int> bytes) {
+  var crc = 0xFFFFFFFF;
+  for (final byte in bytes) {
+    crc ^= byte;
+    for (var k = 0; k < 8; k++) {
+      crc = (crc & 1) != 0 ? (crc >> 1) ^ 0xEDB88320 : crc >> 1;
+    }
+  }
+  return crc ^ 0xFFFFFFFF;
+}
+
+/// Peak signal-to-noise ratio of two equally sized 8-bit buffers, in dB
+double _psnr(Uint8List a, Uint8List b) {
+  var sum = 0.0;
+  for (var i = 0; i < a.length; i++) {
+    final d = a[i] - b[i];
+    sum += d * d;
+  }
+  if (sum == 0) return double.infinity;
+  return 10 * log(255.0 * 255.0 * a.length / sum) / ln10;
 }